@@ -0,0 +1,357 @@
+/***************************************************************************
+ *   File: command_input.c                                Part of FieryMUD *
+ *  Usage: benchmark of reading commands against the old txt_q             *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Floods a descriptor with typed-ahead commands, as a client pasting a
+ * long list of them or a bot would: reads of many lines at a time, some
+ * lines split between reads, with the odd '$', backspace and blank line.
+ * The same reads go through what process_input() used to do with text
+ * (rescanning the whole of inbuf on every read and mallocing a txt_block
+ * and a copy of every line for the txt_q) and through parse_telnet() and
+ * a CommandQueue.  After each read the game takes every command queued.
+ * Both must come up with the commands the flood was made of.  Every
+ * malloc(), calloc() and new while they run is counted.
+ *
+ *     command_input_bench [lines]
+ */
+
+#include "command_queue.hpp"
+#include "telnet_parser.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::uint64_t allocations;
+
+/* glibc's own allocator, under the names it exports for wrappers like these. */
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size) noexcept {
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept {
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size) noexcept {
+    ++allocations;
+    return __libc_realloc(ptr, size);
+}
+}
+
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+static const char *words[] = {"n",      "s",      "e",      "w",     "look",      "get",     "all",   "corpse",
+                              "kill",   "orc",    "say",    "hi",    "there",     "tell",    "bob",   "cast",
+                              "'heal'", "goblin", "wear",   "sword", "bag",       "rest",    "stand", "group",
+                              "follow", "assist", "bash",   "kick",  "score",     "inventory"};
+
+struct Flood {
+    std::vector<std::string> reads;
+    std::vector<std::string> commands; /* as they should be queued: backspaces done, $'s doubled */
+};
+
+static Flood make_flood(long lines) {
+    Flood flood;
+    std::string read, line, typed, command;
+    std::uint64_t r = 1;
+    long i;
+    int j, split;
+
+    for (i = 0; i < lines; i++) {
+        r = mix(r + i);
+
+        /* Return pressed on its own, in a read of its own */
+        if (r % 50 == 0) {
+            if (!read.empty())
+                flood.reads.push_back(std::move(read));
+            flood.reads.push_back("\r\n");
+            flood.commands.push_back("");
+            read.clear();
+            continue;
+        }
+
+        line.clear();
+        for (j = 0; j <= (int)((r >> 8) % 4); j++) {
+            if (j)
+                line += ' ';
+            line += words[(r >> (12 + 5 * j)) % (sizeof(words) / sizeof(*words))];
+        }
+        typed = line;
+        command.clear();
+        if (r % 20 == 1) { /* a typo, rubbed out */
+            typed += "x\b";
+        } else if (r % 20 == 2) {
+            typed += " 5$";
+            line += " 5$";
+        }
+        for (char c : line)
+            command += c == '$' ? "$$" : std::string(1, c);
+        flood.commands.push_back(command);
+        typed += r % 10 ? "\r\n" : "\n";
+        if (r % 30 == 3) /* a blank line pasted in, which ends nothing */
+            typed += "\n";
+
+        /*
+         * A read is cut off in the middle of a line now and then.  Only
+         * plain text is split, as the old code read the unfinished line
+         * over again, doubling any '$' and losing any backspace.
+         */
+        if (r % 8 == 4 && line.find('$') == std::string::npos && typed.find('\b') == std::string::npos &&
+            (split = 1 + (r >> 40) % line.size()) < (int)line.size()) {
+            read.append(typed, 0, split);
+            flood.reads.push_back(std::move(read));
+            read.assign(typed, split);
+        } else
+            read += typed;
+        if (read.size() > 4000) {
+            flood.reads.push_back(std::move(read));
+            read.clear();
+        }
+    }
+    if (!read.empty())
+        flood.reads.push_back(std::move(read));
+    return flood;
+}
+
+/* The txt_q of old: a malloc'd txt_block and a malloc'd copy of each line. */
+struct txt_q {
+    txt_block *head;
+    txt_block *tail;
+};
+
+struct OldDescriptor {
+    char inbuf[MAX_RAW_INPUT_LENGTH];
+    char last_input[MAX_INPUT_LENGTH];
+    txt_q input;
+};
+
+static void write_to_q(char *txt, txt_q *queue, int aliased) {
+    txt_block *new_msg;
+
+    new_msg = (txt_block *)calloc(1, sizeof(txt_block));
+    new_msg->text = (char *)calloc(strlen(txt) + 1, 1);
+    strcpy(new_msg->text, txt);
+    new_msg->aliased = aliased;
+
+    if (!queue->head) {
+        new_msg->next = nullptr;
+        queue->head = queue->tail = new_msg;
+    } else {
+        queue->tail->next = new_msg;
+        queue->tail = new_msg;
+        new_msg->next = nullptr;
+    }
+}
+
+static int get_from_q(txt_q *queue, char *dest, int *aliased) {
+    txt_block *tmp;
+
+    if (!queue->head)
+        return 0;
+
+    tmp = queue->head;
+    strcpy(dest, queue->head->text);
+    *aliased = queue->head->aliased;
+    queue->head = queue->head->next;
+
+    free(tmp->text);
+    free(tmp);
+    return 1;
+}
+
+/* process_input() as it was, with the telnet options left out, as the flood has none. */
+static void old_process_input(OldDescriptor *t, const std::string &read) {
+    int buf_length, space_left;
+    char *ptr, *write_point, tmp[MAX_INPUT_LENGTH + 8];
+
+    buf_length = strlen(t->inbuf);
+    memcpy(t->inbuf + buf_length, read.data(), read.size());
+    t->inbuf[buf_length + read.size()] = '\0';
+
+    write_point = tmp;
+    *write_point = '\0';
+    space_left = MAX_INPUT_LENGTH - 1;
+    for (ptr = t->inbuf; *ptr; ++ptr) {
+        if (IS_NEWLINE(*ptr)) {
+            *write_point = '\0';
+            strcpy(t->last_input, tmp);
+            write_to_q(tmp, &t->input, 0);
+            while (*(ptr + 1) && IS_NEWLINE(*(ptr + 1)))
+                ++ptr;
+            write_point = tmp;
+            *write_point = '\0';
+            space_left = MAX_INPUT_LENGTH - 1;
+        } else if (*ptr == '\b') {
+            if (write_point > tmp) {
+                if (*(--write_point) == '$') {
+                    write_point--;
+                    space_left += 2;
+                } else
+                    space_left++;
+            }
+        } else if (isascii(*ptr) && isprint(*ptr)) {
+            if ((*(write_point++) = *ptr) == '$') {
+                *(write_point++) = '$';
+                space_left -= 2;
+            } else
+                space_left--;
+            *write_point = '\0';
+        }
+    }
+    strcpy(t->inbuf, tmp);
+}
+
+/* Queues lines the way queue_command() does, less the snooping, history and casting. */
+class BenchInput : public TelnetHandler {
+  public:
+    BenchInput(CommandQueue &input, char *last_input, std::uint64_t &checksum)
+        : input_(input), last_input_(last_input), checksum_(checksum) {}
+
+    void line(std::string_view text) override {
+        char *cmd, *write_point;
+
+        if (input_.full())
+            drain();
+        cmd = write_point = input_.back_buffer();
+        for (auto c : text)
+            if ((*(write_point++) = c) == '$')
+                *(write_point++) = '$';
+        *write_point = '\0';
+        strcpy(last_input_, cmd);
+        input_.commit_back(false);
+    }
+    bool long_line(std::string_view text) override {
+        line(text);
+        return true;
+    }
+    void negotiation(unsigned char command, unsigned char option) override {}
+    void subnegotiation(unsigned char option, std::string_view data) override {}
+    void protocol_error(std::string_view what) override {}
+
+    void drain();
+
+  private:
+    CommandQueue &input_;
+    char *last_input_;
+    std::uint64_t &checksum_;
+};
+
+static std::uint64_t add_to_checksum(std::uint64_t checksum, const char *command) {
+    for (; *command; ++command)
+        checksum = checksum * 31 + (unsigned char)*command;
+    return checksum * 31 + '\n';
+}
+
+void BenchInput::drain() {
+    char comm[MAX_INPUT_LENGTH];
+    int aliased;
+
+    while (input_.pop(comm, &aliased))
+        checksum_ = add_to_checksum(checksum_, comm);
+}
+
+struct Result {
+    double seconds;
+    std::uint64_t allocations;
+    std::uint64_t checksum;
+};
+
+static Result run_old(const Flood &flood) {
+    OldDescriptor *t = new OldDescriptor{};
+    char comm[MAX_INPUT_LENGTH];
+    int aliased;
+    Result result{};
+
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string &read : flood.reads) {
+        old_process_input(t, read);
+        while (get_from_q(&t->input, comm, &aliased))
+            result.checksum = add_to_checksum(result.checksum, comm);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocations;
+    delete t;
+    return result;
+}
+
+static Result run_new(const Flood &flood) {
+    CommandQueue *input = new CommandQueue;
+    TelnetInput *tn = new TelnetInput{};
+    char *inbuf = new char[MAX_RAW_INPUT_LENGTH], last_input[MAX_INPUT_LENGTH];
+    Result result{};
+    BenchInput handler(*input, last_input, result.checksum);
+
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string &read : flood.reads) {
+        memcpy(inbuf + tn->line_len, read.data(), read.size());
+        parse_telnet(tn, inbuf, read.size(), handler);
+        handler.drain();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocations;
+    delete[] inbuf;
+    delete tn;
+    delete input;
+    return result;
+}
+
+static void report(const char *name, const Result &result, std::size_t lines) {
+    printf("%-20s %8.3f s  %10.0f lines/s  %6.2f allocations/line\n", name, result.seconds, lines / result.seconds,
+           (double)result.allocations / lines);
+}
+
+int main(int argc, char **argv) {
+    long lines = argc > 1 ? atol(argv[1]) : 1000000;
+    Flood flood = make_flood(lines);
+    std::uint64_t expected = 0;
+    std::size_t bytes = 0;
+
+    for (const std::string &command : flood.commands)
+        expected = add_to_checksum(expected, command.c_str());
+    for (const std::string &read : flood.reads)
+        bytes += read.size();
+    printf("%zu commands in %zu reads, %zu bytes\n", flood.commands.size(), flood.reads.size(), bytes);
+
+    Result old_result = run_old(flood);
+    report("txt_q", old_result, flood.commands.size());
+    Result new_result = run_new(flood);
+    report("command queue", new_result, flood.commands.size());
+
+    if (old_result.checksum != expected || new_result.checksum != expected) {
+        printf("MISMATCH: the commands queued weren't the ones typed (%s).\n",
+               old_result.checksum != expected ? "txt_q" : "command queue");
+        return 1;
+    }
+    printf("Speedup: %.2fx\n", old_result.seconds / new_result.seconds);
+    return 0;
+}
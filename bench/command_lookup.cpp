@@ -0,0 +1,209 @@
+/***************************************************************************
+ *   File: command_lookup.c                               Part of FieryMUD *
+ *  Usage: benchmark of command lookups against the old table scans        *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Reads the command names out of cmd_info[] in interpreter.cpp and
+ * replays a mix of input against them: mostly the movement, looking,
+ * talking and fighting abbreviations players type all day, some whole
+ * command names, and a few typos and words that aren't commands at all.
+ * Each word is looked up the way command_interpreter() did, by scanning
+ * the table with strncasecmp, and the way it does now, with a
+ * CommandTrie.  Each miss is then matched against every command with
+ * levenshtein_distance, as list_similar_commands() did, and searched for
+ * in a CommandBKTree.  Both ways must find the same commands.
+ *
+ *     command_lookup_bench [interpreter.cpp] [lines]
+ */
+
+#include "command_lookup.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+#include <vector>
+
+/* What players type, roughly in proportion. */
+static const char *common_input[] = {
+    "n",     "s",     "e",      "w",       "u",      "d",     "n",      "s",     "e",       "w",     "l",
+    "look",  "l",     "k",      "kill",    "say",    "'",     "gos",    "tell",  "reply",   "gt",    "get",
+    "drop",  "i",     "inv",    "eq",      "sc",     "score", "c",      "cast",  "wear",    "rem",   "wield",
+    "where", "who",   "rest",   "sleep",   "st",     "stand", "flee",   "bash",  "kick",    "hit",   "cons",
+    "ex",    "exa",   "open",   "close",   "buy",    "sell",  "list",   "fol",   "group",   "emote", "smile",
+    "nod",   "grin",  "assist", "backstab", "sneak", "hide",  "search", "memorize", "prompt", "save", "quit"};
+
+/* Mistyped and made-up words, which end up at list_similar_commands(). */
+static const char *other_input[] = {"lok",   "lookk", "scroe", "invetory", "wehre", "xyzzy", "folow",
+                                    "atack", "gropu", "caast", "mem",      "blargh", "qwerty", "sya"};
+
+static std::vector<std::string> read_commands(const char *path) {
+    std::vector<std::string> names;
+    char line[1024], *start, *end;
+    bool in_table = false;
+    FILE *fl;
+
+    if (!(fl = fopen(path, "r"))) {
+        perror(path);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), fl)) {
+        if (!in_table) {
+            in_table = strstr(line, "CommandInfo cmd_info[] = {") != nullptr;
+            continue;
+        }
+        start = line + strspn(line, " \t");
+        if (strncmp(start, "{\"", 2))
+            continue;
+        start += 2;
+        if (!strncmp(start, "\\n\"", 3)) /* the end of the table */
+            break;
+        if (!(end = strchr(start, '"')))
+            continue;
+        names.emplace_back(start, end);
+    }
+
+    fclose(fl);
+    return names;
+}
+
+/* levenshtein_distance() from text.cpp. */
+static int levenshtein_distance(const char *s1, const char *s2) {
+    int s1_len = strlen(s1), s2_len = strlen(s2), i, j;
+    std::vector<std::vector<int>> d(s1_len + 1, std::vector<int>(s2_len + 1));
+
+    for (i = 0; i <= s1_len; ++i)
+        d[i][0] = i;
+    for (j = 0; j <= s2_len; ++j)
+        d[0][j] = j;
+
+    for (i = 1; i <= s1_len; ++i)
+        for (j = 1; j <= s2_len; ++j)
+            d[i][j] = std::min(d[i - 1][j] + 1,
+                               std::min(d[i][j - 1] + 1, d[i - 1][j - 1] + ((s1[i - 1] == s2[j - 1]) ? 0 : 1)));
+
+    return d[s1_len][s2_len];
+}
+
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+struct Result {
+    double seconds;
+    std::uint64_t checksum;
+};
+
+template <typename Lookup> static Result run(const std::vector<const char *> &input, Lookup lookup) {
+    Result result{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (const char *word : input)
+        result.checksum = result.checksum * 31 + (std::uint64_t)lookup(word);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void report(const char *name, const Result &result, std::size_t lookups) {
+    printf("%-20s %8.3f s  %8.1f ns/lookup\n", name, result.seconds, result.seconds * 1e9 / lookups);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "src/interpreter.cpp";
+    long lines = argc > 2 ? atol(argv[2]) : 1000000;
+    std::vector<std::string> names = read_commands(path);
+    std::vector<const char *> input, misses;
+    CommandTrie trie;
+    CommandBKTree typos(levenshtein_distance);
+    int num_of_cmds = names.size(), i;
+    std::uint64_t r = 1;
+
+    if (names.empty()) {
+        printf("No commands found in %s.\n", path);
+        return 1;
+    }
+    for (i = 0; i < num_of_cmds; i++) {
+        trie.insert(i, names[i].c_str());
+        typos.insert(i, names[i].c_str());
+    }
+
+    /* One line in ten is a whole command name, one in fifty a miss. */
+    for (i = 0; i < lines; i++) {
+        r = mix(r + i);
+        if (r % 50 == 0)
+            input.push_back(other_input[(r >> 8) % (sizeof(other_input) / sizeof(*other_input))]);
+        else if (r % 10 == 1)
+            input.push_back(names[1 + (r >> 8) % (num_of_cmds - 1)].c_str());
+        else
+            input.push_back(common_input[(r >> 8) % (sizeof(common_input) / sizeof(*common_input))]);
+    }
+
+    printf("%d commands from %s, %zu lines\n", num_of_cmds, path, input.size());
+
+    Result old_result = run(input, [&](const char *word) {
+        int cmd, length = strlen(word);
+
+        for (cmd = 1; cmd < num_of_cmds; cmd++)
+            if (!strncasecmp(names[cmd].c_str(), word, length))
+                break;
+        return cmd;
+    });
+    report("table scan", old_result, input.size());
+    Result trie_result = run(input, [&](const char *word) {
+        const std::vector<int> *matches = trie.matches(word);
+
+        if (matches)
+            for (int cmd : *matches)
+                if (cmd > 0)
+                    return cmd;
+        return num_of_cmds;
+    });
+    report("command trie", trie_result, input.size());
+
+    for (const char *word : input)
+        if (!trie.matches(word))
+            misses.push_back(word);
+
+    Result old_typos = run(misses, [&](const char *word) {
+        std::uint64_t sum = 0;
+
+        for (int cmd = 0; cmd < num_of_cmds; cmd++)
+            if (levenshtein_distance(word, names[cmd].c_str()) <= 2)
+                sum = sum * 7 + cmd;
+        return sum;
+    });
+    report("levenshtein scan", old_typos, misses.size());
+    Result tree_typos = run(misses, [&](const char *word) {
+        std::uint64_t sum = 0;
+
+        for (int cmd : typos.within(word, 2))
+            sum = sum * 7 + cmd;
+        return sum;
+    });
+    report("BK-tree", tree_typos, misses.size());
+
+    if (old_result.checksum != trie_result.checksum || old_typos.checksum != tree_typos.checksum) {
+        printf("MISMATCH: the lookups found different commands.\n");
+        return 1;
+    }
+    printf("Speedup: %.2fx for commands, %.2fx for suggestions\n", old_result.seconds / trie_result.seconds,
+           old_typos.seconds / tree_typos.seconds);
+    return 0;
+}
@@ -0,0 +1,514 @@
+/***************************************************************************
+ *   File: dg_compile.c                                   Part of FieryMUD *
+ *  Usage: benchmark of compiled trigger scripts against the text ones     *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Reads the triggers out of a .trg file the way parse_trigger() does,
+ * compiles them, and runs each of them many times through a copy of
+ * script_driver()'s control flow: once reading the text as it did, with
+ * copies of find_else_end(), find_case() and eval_expr(), and once
+ * following what compile_script() worked out.  Variables are replaced
+ * with values picked by hashing their names, so different runs take
+ * different branches, and commands do nothing but add to a checksum of
+ * the lines each run went through.  Both ways must go through the same
+ * lines.  Since the real var_subst() costs more than the stand-in here,
+ * this measures the interpreter rather than a trigger as the game runs it.
+ *
+ *     dg_compile_bench [file.trg] [rounds]
+ */
+
+#include "dg_compile.hpp"
+
+#include "defines.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+#include <vector>
+
+/* What the variables stand for. */
+static const char *values[] = {"0", "1", "1", "2", "5", "10", "100", "Sorcerer", "Necromancer", "north", "a knight"};
+
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+/* One run of one trigger. */
+struct Run {
+    std::uint64_t seed;
+    std::uint64_t checksum;
+    int depth;
+    int loops;
+};
+
+/* var_subst(), with every variable replaced by a value from values[]. */
+static void stub_subst(Run &run, const char *line, char *buf) {
+    char *end = buf + MAX_INPUT_LENGTH - 1;
+    std::uint64_t hash;
+    const char *value;
+
+    while (*line && buf < end) {
+        if (*line != '%') {
+            *buf++ = *line++;
+            continue;
+        }
+        if (*++line == '%') {
+            *buf++ = *line++;
+            continue;
+        }
+        for (hash = run.seed; *line && *line != '%'; line++)
+            hash = (hash ^ (unsigned char)*line) * 0x100000001b3ULL;
+        if (*line)
+            line++;
+        for (value = values[mix(hash) % (sizeof(values) / sizeof(*values))]; *value && buf < end;)
+            *buf++ = *value++;
+    }
+    *buf = '\0';
+}
+
+static void compiled_subst(void *context, char *text, char *result) { stub_subst(*(Run *)context, text, result); }
+
+/* The text interpreter, from dg_scripts.cpp, logging nothing. */
+
+static int eval_lhs_op_rhs(char *expr, char *result, Run &run);
+
+static void eval_expr(char *line, char *result, Run &run) {
+    char expr[MAX_INPUT_LENGTH], *p;
+
+    while (*line && isspace(*line))
+        line++;
+
+    if (eval_lhs_op_rhs(line, result, run))
+        ;
+
+    else if (*line == '(') {
+        p = strcpy(expr, line);
+        p = matching_paren(expr);
+        *p = '\0';
+        eval_expr(expr + 1, result, run);
+    }
+
+    else
+        stub_subst(run, line, result);
+}
+
+static int eval_lhs_op_rhs(char *expr, char *result, Run &run) {
+    char *p, *tokens[MAX_INPUT_LENGTH];
+    char line[MAX_INPUT_LENGTH], lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
+    int i, j;
+
+    p = strcpy(line, expr);
+
+    for (j = 0; *p; j++) {
+        tokens[j] = p;
+        if (*p == '(')
+            p = matching_paren(p) + 1;
+        else if (*p == '"')
+            p = matching_quote(p) + 1;
+        else if (isalnum(*p))
+            for (p++; *p && (isalnum(*p) || isspace(*p)); p++)
+                ;
+        else
+            p++;
+    }
+    tokens[j] = nullptr;
+
+    for (i = 0; *script_ops[i] != '\n'; i++)
+        for (j = 0; tokens[j]; j++)
+            if (!strncasecmp(script_ops[i], tokens[j], strlen(script_ops[i]))) {
+                *tokens[j] = '\0';
+                p = tokens[j] + strlen(script_ops[i]);
+
+                eval_expr(line, lhr, run);
+                eval_expr(p, rhr, run);
+                eval_op(script_ops[i], lhr, rhr, result);
+
+                return 1;
+            }
+
+    return 0;
+}
+
+static int truth(char *result) {
+    while (*result && isspace(*result))
+        result++;
+    return *result && *result != '0';
+}
+
+static int process_if(char *cond, Run &run) {
+    char result[MAX_INPUT_LENGTH];
+
+    eval_expr(cond, result, run);
+    return truth(result);
+}
+
+static CmdlistElement *find_end(CmdlistElement *cl) {
+    CmdlistElement *c;
+    char *p;
+
+    if (!(cl->next))
+        return cl;
+
+    for (c = cl->next; c; c = c->next) {
+        for (p = c->cmd; *p && isspace(*p); p++)
+            ;
+
+        if (!strncasecmp("if ", p, 3))
+            c = find_end(c);
+        else if (!strncasecmp("end", p, 3))
+            return c;
+
+        if (!c->next)
+            return c;
+    }
+
+    return c;
+}
+
+static CmdlistElement *find_else_end(CmdlistElement *cl, Run &run) {
+    CmdlistElement *c;
+    char *p;
+
+    if (!(cl->next))
+        return cl;
+
+    for (c = cl->next; c->next; c = c->next) {
+        for (p = c->cmd; *p && isspace(*p); p++)
+            ;
+
+        if (!strncasecmp("if ", p, 3))
+            c = find_end(c);
+
+        else if (!strncasecmp("elseif ", p, 7)) {
+            if (process_if(p + 7, run)) {
+                run.depth++;
+                return c;
+            }
+        }
+
+        else if (!strncasecmp("else", p, 4)) {
+            run.depth++;
+            return c;
+        }
+
+        else if (!strncasecmp("end", p, 3))
+            return c;
+
+        if (!c->next)
+            return c;
+    }
+
+    return c;
+}
+
+static CmdlistElement *find_done(CmdlistElement *cl) {
+    CmdlistElement *c;
+    char *p;
+
+    if (!cl || !(cl->next))
+        return cl;
+
+    for (c = cl->next; c && c->next; c = c->next) {
+        for (p = c->cmd; *p && isspace(*p); p++)
+            ;
+
+        if (!strncasecmp("while ", p, 6) || !strncasecmp("switch ", p, 7))
+            c = find_done(c);
+        else if (!strncasecmp("done", p, 3))
+            return c;
+    }
+
+    return c;
+}
+
+static CmdlistElement *find_case(CmdlistElement *cl, char *cond, Run &run) {
+    char cond_expr[MAX_INPUT_LENGTH], *p;
+    CmdlistElement *c;
+
+    if (!(cl->next))
+        return cl;
+
+    eval_expr(cond, cond_expr, run);
+
+    for (c = cl->next; c->next; c = c->next) {
+        for (p = c->cmd; *p && isspace(*p); p++)
+            ;
+
+        if (!strncasecmp("while ", p, 6) || !strncasecmp("switch", p, 6))
+            c = find_done(c);
+        else if (!strncasecmp("case ", p, 5)) {
+            char case_expr[MAX_STRING_LENGTH];
+            char result[16];
+            eval_expr(p + 5, case_expr, run);
+            eval_op("==", cond_expr, case_expr, result);
+            if (*result && *result != '0')
+                return c;
+        } else if (!strncasecmp("default", p, 7))
+            return c;
+        else if (!strncasecmp("done", p, 3))
+            return c;
+    }
+    return c;
+}
+
+/* The compiled interpreter, from dg_scripts.cpp. */
+
+static int compiled_if(const ScriptExpr *cond, Run &run) {
+    char result[MAX_INPUT_LENGTH];
+
+    eval_script_expr(cond, result, compiled_subst, &run);
+    return truth(result);
+}
+
+static CmdlistElement *compiled_else_end(CmdlistElement *cl, Run &run) {
+    CmdlistElement *c;
+
+    if (!(cl->next))
+        return cl;
+
+    for (c = cl->branch; c->next; c = c->branch) {
+        if (c->keyword == ScriptKeyword::ElseIf) {
+            if (compiled_if(c->expr, run)) {
+                run.depth++;
+                return c;
+            }
+        } else {
+            if (c->keyword == ScriptKeyword::Else)
+                run.depth++;
+            return c;
+        }
+    }
+
+    return c;
+}
+
+static CmdlistElement *compiled_case(CmdlistElement *cl, Run &run) {
+    char cond_expr[MAX_INPUT_LENGTH], case_expr[MAX_STRING_LENGTH], result[16];
+    CmdlistElement *c;
+
+    if (!(cl->next))
+        return cl;
+
+    eval_script_expr(cl->expr, cond_expr, compiled_subst, &run);
+
+    for (c = cl->branch; c->next && c->keyword == ScriptKeyword::Case && c->expr; c = c->branch) {
+        eval_script_expr(c->expr, case_expr, compiled_subst, &run);
+        eval_op("==", cond_expr, case_expr, result);
+        if (*result && *result != '0')
+            break;
+    }
+
+    return c;
+}
+
+/*
+ * script_driver(), down to its control flow.  A wait ends the run, as
+ * the trigger would go to sleep there.
+ */
+static void drive(CmdlistElement *cmdlist, Run &run, bool use_compiled) {
+    bool compiled = use_compiled && script_compiled(cmdlist);
+    char cmd[MAX_INPUT_LENGTH], *p;
+    CmdlistElement *cl, *temp;
+    ScriptKeyword keyword;
+    ScriptCommand command;
+    unsigned long loops = 0;
+
+    run.depth = 1;
+    run.loops = 0;
+    for (cl = cmdlist; cl && run.depth; cl = cl->next) {
+        run.checksum = mix(run.checksum + (std::uintptr_t)cl);
+
+        for (p = cl->cmd; *p && isspace(*p); p++)
+            ;
+
+        keyword = compiled ? cl->keyword : script_keyword(p);
+
+        if (keyword == ScriptKeyword::Comment)
+            continue;
+
+        else if (keyword == ScriptKeyword::If) {
+            if (compiled ? compiled_if(cl->expr, run) : process_if(p + 3, run))
+                run.depth++;
+            else
+                cl = compiled ? compiled_else_end(cl, run) : find_else_end(cl, run);
+        }
+
+        else if (keyword == ScriptKeyword::ElseIf || keyword == ScriptKeyword::Else) {
+            if (run.depth == 1)
+                continue;
+            cl = compiled ? cl->jump : find_end(cl);
+            run.depth--;
+        } else if (keyword == ScriptKeyword::While) {
+            temp = compiled ? cl->jump : find_done(cl);
+            if (!temp)
+                return;
+            else if (compiled ? compiled_if(cl->expr, run) : process_if(p + 6, run))
+                temp->original = cl;
+            else {
+                cl = temp;
+                loops = 0;
+            }
+        } else if (keyword == ScriptKeyword::Switch) {
+            cl = compiled ? compiled_case(cl, run) : find_case(cl, p + 7, run);
+        } else if (keyword == ScriptKeyword::End) {
+            if (run.depth == 1)
+                continue;
+            run.depth--;
+        } else if (keyword == ScriptKeyword::Done) {
+            if (cl->original) {
+                char *orig_cmd = cl->original->cmd;
+                while (*orig_cmd && isspace(*orig_cmd))
+                    orig_cmd++;
+
+                if (compiled ? compiled_if(cl->original->expr, run) : process_if(orig_cmd + 6, run)) {
+                    cl = cl->original;
+                    loops++;
+                    run.loops++;
+                    if (loops == 30 || run.loops >= 100)
+                        break;
+                }
+            }
+        } else if (keyword == ScriptKeyword::Break) {
+            cl = compiled ? cl->jump : find_done(cl);
+        } else if (keyword == ScriptKeyword::Case) {
+            /* Do nothing, this allows multiple cases to a single instance */
+        }
+
+        else {
+            stub_subst(run, p, cmd);
+
+            command = cl->command == ScriptCommand::Unknown ? script_command(cmd) : cl->command;
+
+            run.checksum = mix(run.checksum + (int)command * 131 + strlen(cmd));
+            if (command == ScriptCommand::Halt || command == ScriptCommand::Wait)
+                break;
+        }
+    }
+
+    /* The next run starts the while loops over. */
+    for (cl = cmdlist; cl; cl = cl->next)
+        cl->original = nullptr;
+}
+
+/* fread_string(), up to the next ~ */
+static bool read_string(FILE *fl, std::string &text) {
+    char line[1024], *tilde;
+
+    text.clear();
+    while (fgets(line, sizeof(line), fl)) {
+        if ((tilde = strchr(line, '~'))) {
+            *tilde = '\0';
+            text += line;
+            return true;
+        }
+        text += line;
+    }
+    return false;
+}
+
+/* The command lists of the triggers in path, as parse_trigger() builds them. */
+static std::vector<CmdlistElement *> read_triggers(const char *path) {
+    std::vector<CmdlistElement *> triggers;
+    std::string name, arglist, commands;
+    CmdlistElement *cmdlist, **tail;
+    char line[1024], *s;
+    FILE *fl;
+
+    if (!(fl = fopen(path, "r"))) {
+        perror(path);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), fl)) {
+        if (*line != '#')
+            continue;
+        if (!read_string(fl, name) || !fgets(line, sizeof(line), fl) || !read_string(fl, arglist) ||
+            !read_string(fl, commands))
+            break;
+
+        cmdlist = nullptr;
+        tail = &cmdlist;
+        for (s = strtok(commands.data(), "\r\n"); s; s = strtok(nullptr, "\r\n")) {
+            *tail = (CmdlistElement *)calloc(1, sizeof(CmdlistElement));
+            (*tail)->cmd = strdup(s);
+            tail = &(*tail)->next;
+        }
+        if (cmdlist)
+            triggers.push_back(cmdlist);
+    }
+
+    fclose(fl);
+    return triggers;
+}
+
+struct Result {
+    double seconds;
+    std::uint64_t checksum;
+};
+
+static Result run(const std::vector<CmdlistElement *> &triggers, long rounds, bool use_compiled) {
+    Result result{};
+    Run trigger_run;
+    long round;
+    std::size_t i;
+
+    auto start = std::chrono::steady_clock::now();
+    for (round = 0; round < rounds; round++)
+        for (i = 0; i < triggers.size(); i++) {
+            trigger_run = {mix(round * triggers.size() + i), 0, 0, 0};
+            drive(triggers[i], trigger_run, use_compiled);
+            result.checksum = result.checksum * 31 + trigger_run.checksum;
+        }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void report(const char *name, const Result &result, std::size_t runs) {
+    printf("%-20s %8.3f s  %8.1f ns/run\n", name, result.seconds, result.seconds * 1e9 / runs);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "lib.default/world/trg/30.trg";
+    long rounds = argc > 2 ? atol(argv[2]) : 20000;
+    std::vector<CmdlistElement *> triggers = read_triggers(path);
+    std::size_t compiled = 0;
+
+    if (triggers.empty()) {
+        printf("No triggers found in %s.\n", path);
+        return 1;
+    }
+    for (CmdlistElement *cmdlist : triggers)
+        if (compile_script(cmdlist))
+            compiled++;
+
+    printf("%zu triggers from %s, %zu compiled, %ld rounds\n", triggers.size(), path, compiled, rounds);
+
+    Result text_result = run(triggers, rounds, false);
+    report("text", text_result, triggers.size() * rounds);
+    Result compiled_result = run(triggers, rounds, true);
+    report("compiled", compiled_result, triggers.size() * rounds);
+
+    if (text_result.checksum != compiled_result.checksum) {
+        printf("MISMATCH: the triggers ran different lines.\n");
+        return 1;
+    }
+    printf("Speedup: %.2fx\n", text_result.seconds / compiled_result.seconds);
+    return 0;
+}
@@ -0,0 +1,276 @@
+/***************************************************************************
+ *   File: dg_fields.c                                    Part of FieryMUD *
+ *  Usage: benchmark of %var.field% lookups against the strcasecmp chains  *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Looks up the fields of characters, objects and rooms the way
+ * find_replacement() did, comparing the field with each name in turn,
+ * and the way it does now, with script_field().  The fields asked for
+ * are the ones the stock triggers use most, in about the proportions
+ * they use them, with a coin name and a direction, which both leave to
+ * the checks that come after.  Both must find the same fields.
+ *
+ *     dg_fields_bench [lookups]
+ */
+
+#include "dg_fields.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <strings.h>
+#include <vector>
+
+enum Entity { CHAR, OBJ, ROOM };
+
+struct ChainName {
+    const char *name;
+    ScriptField field;
+};
+
+/* The names find_replacement() compared, in the order it compared them. */
+static const ChainName char_chain[] = {
+    {"name", ScriptField::Name},
+    {"p", ScriptField::HisHer},
+    {"hisher", ScriptField::HisHer},
+    {"o", ScriptField::HimHer},
+    {"himher", ScriptField::HimHer},
+    {"n", ScriptField::HeShe},
+    {"heshe", ScriptField::HeShe},
+    {"alias", ScriptField::Alias},
+    {"title", ScriptField::Title},
+    {"vnum", ScriptField::Vnum},
+    {"id", ScriptField::Id},
+    {"sex", ScriptField::Sex},
+    {"gender", ScriptField::Sex},
+    {"class", ScriptField::Class},
+    {"race", ScriptField::Race},
+    {"level", ScriptField::Level},
+    {"weight", ScriptField::Weight},
+    {"height", ScriptField::Height},
+    {"size", ScriptField::Size},
+    {"cha", ScriptField::Cha},
+    {"str", ScriptField::Str},
+    {"int", ScriptField::Int},
+    {"wis", ScriptField::Wis},
+    {"con", ScriptField::Con},
+    {"dex", ScriptField::Dex},
+    {"real_cha", ScriptField::RealCha},
+    {"real_str", ScriptField::RealStr},
+    {"real_int", ScriptField::RealInt},
+    {"real_wis", ScriptField::RealWis},
+    {"real_con", ScriptField::RealCon},
+    {"real_dex", ScriptField::RealDex},
+    {"hit", ScriptField::Hit},
+    {"maxhit", ScriptField::MaxHit},
+    {"move", ScriptField::Move},
+    {"maxmove", ScriptField::MaxMove},
+    {"armor", ScriptField::Armor},
+    {"hitroll", ScriptField::Hitroll},
+    {"damroll", ScriptField::Damroll},
+    {"exp", ScriptField::Exp},
+    {"perception", ScriptField::Perception},
+    {"hiddenness", ScriptField::Hiddenness},
+    {"align", ScriptField::Alignment},
+    {"alignment", ScriptField::Alignment},
+    {"composition", ScriptField::Composition},
+    {"lifeforce", ScriptField::Lifeforce},
+    {"flags", ScriptField::Flags},
+    {"flagged", ScriptField::Flagged},
+    {"aff_flags", ScriptField::EffFlags},
+    {"eff_flags", ScriptField::EffFlags},
+    {"aff_flagged", ScriptField::EffFlagged},
+    {"eff_flagged", ScriptField::EffFlagged},
+    {"spells", ScriptField::Spells},
+    {"has_spell", ScriptField::HasSpell},
+    {"fighting", ScriptField::Fighting},
+    {"hunting", ScriptField::Hunting},
+    {"riding", ScriptField::Riding},
+    {"ridden_by", ScriptField::RiddenBy},
+    {"consented", ScriptField::Consented},
+    {"master", ScriptField::Master},
+    {"next_in_room", ScriptField::NextInRoom},
+    {"group_size", ScriptField::GroupSize},
+    {"group_size_in_room", ScriptField::GroupSizeInRoom},
+    {"group_leader", ScriptField::GroupLeader},
+    {"group_member", ScriptField::GroupMember},
+    {"quest_variable", ScriptField::QuestVariable},
+    {"quest_stage", ScriptField::QuestStage},
+    {"has_completed", ScriptField::HasCompleted},
+    {"has_failed", ScriptField::HasFailed},
+    {"inventory", ScriptField::Inventory},
+    {"worn", ScriptField::Worn},
+    {"wearing", ScriptField::Wearing},
+    {"position", ScriptField::Position},
+    {"stance", ScriptField::Stance},
+    {"room", ScriptField::Room},
+    {"talent", ScriptField::Skill},
+    {"skill", ScriptField::Skill},
+    {"clan", ScriptField::Clan},
+    {"clan_rank", ScriptField::ClanRank},
+    {"can_be_seen", ScriptField::CanBeSeen},
+    {"trophy", ScriptField::Trophy},
+    {nullptr, ScriptField::Unknown},
+};
+
+static const ChainName obj_chain[] = {
+    {"name", ScriptField::Name},
+    {"shortdesc", ScriptField::ShortDesc},
+    {"description", ScriptField::Description},
+    {"vnum", ScriptField::Vnum},
+    {"type", ScriptField::Type},
+    {"id", ScriptField::Id},
+    {"weight", ScriptField::Weight},
+    {"cost", ScriptField::Cost},
+    {"cost_per_day", ScriptField::Rent},
+    {"rent", ScriptField::Rent},
+    {"level", ScriptField::Level},
+    {"val0", ScriptField::Val0},
+    {"val1", ScriptField::Val1},
+    {"val2", ScriptField::Val2},
+    {"val3", ScriptField::Val3},
+    {"timer", ScriptField::Timer},
+    {"decomp", ScriptField::Decomp},
+    {"hiddenness", ScriptField::Hiddenness},
+    {"affect", ScriptField::Effect},
+    {"effect", ScriptField::Effect},
+    {"affect_value", ScriptField::EffectValue},
+    {"effect_value", ScriptField::EffectValue},
+    {"flags", ScriptField::Flags},
+    {"flagged", ScriptField::Flagged},
+    {"spells", ScriptField::Spells},
+    {"has_spell", ScriptField::HasSpell},
+    {"room", ScriptField::Room},
+    {"carried_by", ScriptField::CarriedBy},
+    {"worn_by", ScriptField::WornBy},
+    {"worn_on", ScriptField::WornOn},
+    {"contents", ScriptField::Contents},
+    {"next_in_list", ScriptField::NextInList},
+    {nullptr, ScriptField::Unknown},
+};
+
+/* Less sector, which was a prefix match before is_dark. */
+static const ChainName room_chain[] = {
+    {"name", ScriptField::Name},
+    {"vnum", ScriptField::Vnum},
+    {"is_dark", ScriptField::IsDark},
+    {"flags", ScriptField::Flags},
+    {"flagged", ScriptField::Flagged},
+    {"effects", ScriptField::Effects},
+    {"affects", ScriptField::Effects},
+    {"has_effect", ScriptField::HasEffect},
+    {"has_affect", ScriptField::HasEffect},
+    {"objects", ScriptField::Objects},
+    {"people", ScriptField::People},
+    {nullptr, ScriptField::Unknown},
+};
+
+static const ChainName *chains[] = {char_chain, obj_chain, room_chain};
+
+struct Query {
+    Entity entity;
+    const char *field;
+    int weight;
+};
+
+/* Roughly how often the stock triggers ask for each. */
+static const Query mix_of_fields[] = {
+    {CHAR, "name", 40},          {CHAR, "skill", 15},   {CHAR, "level", 10},    {CHAR, "quest_variable", 8},
+    {CHAR, "class", 5},          {CHAR, "vnum", 5},     {CHAR, "room", 4},      {CHAR, "quest_stage", 4},
+    {CHAR, "real_int", 1},       {CHAR, "race", 1},     {CHAR, "fighting", 1},  {CHAR, "p", 1},
+    {CHAR, "n", 1},              {CHAR, "worn", 1},     {CHAR, "wearing", 1},   {CHAR, "has_completed", 1},
+    {CHAR, "gold", 1},           {OBJ, "shortdesc", 4}, {OBJ, "vnum", 1},       {ROOM, "people", 1},
+    {ROOM, "north", 1},
+};
+
+#define NUM_FIELDS_IN_MIX (sizeof(mix_of_fields) / sizeof(*mix_of_fields))
+
+/* find_replacement() as it was. */
+static ScriptField chain_field(Entity entity, const char *field) {
+    const ChainName *name;
+
+    for (name = chains[entity]; name->name; name++)
+        if (!strcasecmp(field, name->name))
+            return name->field;
+    return ScriptField::Unknown;
+}
+
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+struct Result {
+    double seconds;
+    std::uint64_t checksum;
+};
+
+template <typename Lookup> static Result run(const std::vector<const Query *> &queries, Lookup lookup) {
+    Result result{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Query *query : queries)
+        result.checksum = result.checksum * 31 + (std::uint64_t)lookup(query->entity, query->field) + 1;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void report(const char *name, const Result &result, std::size_t lookups) {
+    printf("%-16s %8.3f s  %7.1f ns/lookup\n", name, result.seconds, result.seconds * 1e9 / lookups);
+}
+
+int main(int argc, char **argv) {
+    long lookups = argc > 1 ? atol(argv[1]) : 10000000;
+    std::vector<const Query *> weighted, queries;
+    /* Which fields each switch in find_replacement() has a case for */
+    bool handled[3][256] = {};
+    const ChainName *name;
+    std::uint64_t r = 1;
+    std::size_t i;
+    long n;
+    int w;
+
+    for (w = CHAR; w <= ROOM; w++)
+        for (name = chains[w]; name->name; name++)
+            handled[w][(int)name->field] = true;
+
+    for (i = 0; i < NUM_FIELDS_IN_MIX; i++)
+        for (w = 0; w < mix_of_fields[i].weight; w++)
+            weighted.push_back(&mix_of_fields[i]);
+
+    queries.reserve(lookups);
+    for (n = 0; n < lookups; n++) {
+        r = mix(r + n);
+        queries.push_back(weighted[r % weighted.size()]);
+    }
+
+    printf("%zu fields in the mix, %ld lookups\n", NUM_FIELDS_IN_MIX, lookups);
+
+    Result old_result = run(queries, [](Entity entity, const char *field) { return chain_field(entity, field); });
+    report("strcasecmp chain", old_result, queries.size());
+    Result hash_result = run(queries, [&](Entity entity, const char *field) {
+        ScriptField found = script_field(field);
+
+        return handled[entity][(int)found] ? found : ScriptField::Unknown;
+    });
+    report("perfect hash", hash_result, queries.size());
+
+    if (old_result.checksum != hash_result.checksum) {
+        printf("MISMATCH: the lookups found different fields.\n");
+        return 1;
+    }
+    printf("Speedup: %.2fx\n", old_result.seconds / hash_result.seconds);
+    return 0;
+}
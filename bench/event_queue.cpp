@@ -0,0 +1,236 @@
+/***************************************************************************
+ *   File: event_queue.c                                  Part of FieryMUD *
+ *  Usage: benchmark of the event queue against the old sorted buckets     *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Drives the event queue the way the game does: a crowd of characters,
+ * each with an event that re-queues itself when it fires (mostly short,
+ * like regen and casting, sometimes long, like cooldowns), while other
+ * events are cancelled and created (combat starting, characters leaving).
+ * The same workload runs against queue.cpp and against the 100 sorted
+ * lists it replaced, and the two must fire the same events on the same
+ * pulses.
+ *
+ *     event_queue_bench [characters] [pulses]
+ */
+
+#include "queue.hpp"
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+unsigned long pulse = 0;
+
+/* The queue as it was: NUM_EVENT_QUEUES lists kept sorted by key. */
+namespace sorted_buckets {
+
+#define NUM_EVENT_QUEUES 100
+
+struct QElement {
+    void *data;
+    long key;
+    QElement *prev, *next;
+};
+
+struct Queue {
+    QElement *head[NUM_EVENT_QUEUES], *tail[NUM_EVENT_QUEUES];
+};
+
+Queue *queue_init(void) { return (Queue *)calloc(1, sizeof(Queue)); }
+
+QElement *queue_enq(Queue *q, void *data, long key) {
+    QElement *qe, *i;
+    int bucket;
+
+    qe = (QElement *)calloc(1, sizeof(QElement));
+    qe->data = data;
+    qe->key = key;
+
+    bucket = key % NUM_EVENT_QUEUES;
+
+    if (!q->head[bucket]) {
+        q->head[bucket] = qe;
+        q->tail[bucket] = qe;
+    } else {
+        for (i = q->tail[bucket]; i; i = i->prev) {
+            if (i->key < key) {
+                if (i == q->tail[bucket])
+                    q->tail[bucket] = qe;
+                else {
+                    qe->next = i->next;
+                    i->next->prev = qe;
+                }
+                qe->prev = i;
+                i->next = qe;
+                break;
+            }
+        }
+        if (i == nullptr) {
+            qe->next = q->head[bucket];
+            q->head[bucket] = qe;
+            qe->next->prev = qe;
+        }
+    }
+
+    return qe;
+}
+
+void queue_deq(Queue *q, QElement *qe) {
+    int i = qe->key % NUM_EVENT_QUEUES;
+
+    if (qe->prev == nullptr)
+        q->head[i] = qe->next;
+    else
+        qe->prev->next = qe->next;
+    if (qe->next == nullptr)
+        q->tail[i] = qe->prev;
+    else
+        qe->next->prev = qe->prev;
+
+    free(qe);
+}
+
+void *queue_head(Queue *q) {
+    void *data;
+    int i = pulse % NUM_EVENT_QUEUES;
+
+    if (!q->head[i])
+        return nullptr;
+    data = q->head[i]->data;
+    queue_deq(q, q->head[i]);
+    return data;
+}
+
+long queue_key(Queue *q) {
+    int i = pulse % NUM_EVENT_QUEUES;
+
+    return q->head[i] ? q->head[i]->key : LONG_MAX;
+}
+
+void queue_free(Queue *q) {
+    QElement *qe, *next_qe;
+    int i;
+
+    for (i = 0; i < NUM_EVENT_QUEUES; i++)
+        for (qe = q->head[i]; qe; qe = next_qe) {
+            next_qe = qe->next;
+            free(qe);
+        }
+    free(q);
+}
+
+} // namespace sorted_buckets
+
+/* A cheap, order-independent random number for the nth firing of a character's event. */
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+/* Pulses until the event fires again: mostly regen-like, now and then a long cooldown. */
+static long next_delay(int who, std::uint64_t count) {
+    std::uint64_t r = mix(((std::uint64_t)who << 32) ^ count);
+
+    if (r % 10 == 0)
+        return 100 + (long)((r >> 8) % 3000);
+    return 1 + (long)((r >> 8) % 40);
+}
+
+struct Character {
+    int who;
+    std::uint64_t fired;
+    void *q_el;
+};
+
+struct Result {
+    double seconds;
+    std::uint64_t fired;
+    std::uint64_t checksum;
+};
+
+template <typename QueueT, typename ElementT, typename Enq, typename Deq, typename Head, typename Key, typename Free>
+static Result run(int characters, long pulses, Enq enq, Deq deq, Head head, Key key, Free queue_free, QueueT *q) {
+    std::vector<Character> crowd(characters);
+    std::uint64_t churn = 0x9e3779b97f4a7c15ULL;
+    Result result{};
+    Character *ch;
+    int i, victim;
+
+    pulse = 0;
+    for (i = 0; i < characters; i++) {
+        crowd[i].who = i;
+        crowd[i].q_el = enq(q, &crowd[i], next_delay(i, 0));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (pulse = 1; (long)pulse <= pulses; pulse++) {
+        /* event_process() */
+        while ((long)pulse >= key(q)) {
+            ch = (Character *)head(q);
+            ch->fired++;
+            result.fired++;
+            result.checksum += pulse * (std::uint64_t)(ch->who + 1);
+            ch->q_el = enq(q, ch, pulse + next_delay(ch->who, ch->fired));
+        }
+
+        /* A few events are cancelled and replaced each pulse. */
+        for (i = 0; i < characters / 200 + 1; i++) {
+            churn = mix(churn);
+            victim = churn % characters;
+            deq(q, (ElementT *)crowd[victim].q_el);
+            crowd[victim].q_el = enq(q, &crowd[victim], pulse + 1 + (long)((churn >> 32) % 60));
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    queue_free(q);
+    return result;
+}
+
+/* The events belong to the crowd, so the queue is freed without them. */
+static void wheel_free(Queue *q) { queue_free(q, nullptr); }
+
+static void report(const char *name, const Result &result) {
+    printf("%-20s %8.3f s  %10llu events fired  %7.1f ns/event\n", name, result.seconds,
+           (unsigned long long)result.fired, result.fired ? result.seconds * 1e9 / result.fired : 0.0);
+}
+
+int main(int argc, char **argv) {
+    int characters = argc > 1 ? atoi(argv[1]) : 20000;
+    long pulses = argc > 2 ? atol(argv[2]) : 20000;
+
+    printf("%d characters, %ld pulses\n", characters, pulses);
+
+    Result old_result = run<sorted_buckets::Queue, sorted_buckets::QElement>(
+        characters, pulses, sorted_buckets::queue_enq, sorted_buckets::queue_deq, sorted_buckets::queue_head,
+        sorted_buckets::queue_key, sorted_buckets::queue_free, sorted_buckets::queue_init());
+    report("sorted buckets", old_result);
+
+    pulse = 0;
+    Result wheel_result = run<Queue, QElement>(characters, pulses, queue_enq, queue_deq, queue_head, queue_key,
+                                               wheel_free, queue_init());
+    report("timing wheel", wheel_result);
+
+    if (old_result.fired != wheel_result.fired || old_result.checksum != wheel_result.checksum) {
+        printf("MISMATCH: the queues fired different events.\n");
+        return 1;
+    }
+    printf("Speedup: %.2fx\n", old_result.seconds / wheel_result.seconds);
+    return 0;
+}
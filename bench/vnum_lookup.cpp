@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   File: vnum_lookup.c                                  Part of FieryMUD *
+ *  Usage: benchmark of vnum lookups against the old binary searches       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * Builds a world-like table of vnums (zones of up to 100 vnums, most of
+ * them used, with unused zone numbers between them) and looks vnums up
+ * in it the way real_room() did, with a binary search, and the way it
+ * does now, with a VnumIndex.  One lookup in ten is for a vnum that
+ * doesn't exist.  Both must find the same rnums.
+ *
+ *     vnum_lookup_bench [zones] [lookups]
+ */
+
+#include "vnum_index.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* real_room() as it was. */
+static int binary_search(const std::vector<int> &vnums, int vnum) {
+    int bot, top, mid;
+
+    bot = 0;
+    top = vnums.size() - 1;
+
+    for (;;) {
+        mid = (bot + top) / 2;
+
+        if (vnums[mid] == vnum)
+            return mid;
+        if (bot >= top)
+            return -1;
+        if (vnums[mid] > vnum)
+            top = mid - 1;
+        else
+            bot = mid + 1;
+    }
+}
+
+static std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+struct Result {
+    double seconds;
+    std::uint64_t checksum;
+};
+
+template <typename Lookup> static Result run(const std::vector<int> &queries, Lookup lookup) {
+    Result result{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (int vnum : queries)
+        result.checksum = result.checksum * 31 + (std::uint64_t)(lookup(vnum) + 1);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void report(const char *name, const Result &result, std::size_t lookups) {
+    printf("%-16s %8.3f s  %7.1f ns/lookup\n", name, result.seconds, result.seconds * 1e9 / lookups);
+}
+
+int main(int argc, char **argv) {
+    int zones = argc > 1 ? atoi(argv[1]) : 600;
+    long lookups = argc > 2 ? atol(argv[2]) : 10000000;
+    std::vector<int> vnums, queries;
+    std::uint64_t r = 1;
+    VnumIndex index;
+    int zone, number = 0, i;
+
+    for (zone = 0; zone < zones; zone++) {
+        r = mix(r + zone);
+        number += 1 + r % 4; /* zone numbers aren't contiguous */
+        for (i = 0; i < 100; i++)
+            if (mix(r + i) % 4) /* nor are the vnums within a zone */
+                vnums.push_back(number * 100 + i);
+    }
+    for (i = 0; i < (int)vnums.size(); i++)
+        index.set(vnums[i], i);
+
+    queries.reserve(lookups);
+    for (i = 0; i < lookups; i++) {
+        r = mix(r + i);
+        queries.push_back(r % 10 ? vnums[(r >> 8) % vnums.size()] : (int)((r >> 8) % ((number + 1) * 100)));
+    }
+
+    printf("%zu vnums in %d zones, %ld lookups\n", vnums.size(), zones, lookups);
+
+    Result old_result = run(queries, [&](int vnum) { return binary_search(vnums, vnum); });
+    report("binary search", old_result, queries.size());
+    Result index_result = run(queries, [&](int vnum) { return index.get(vnum); });
+    report("vnum index", index_result, queries.size());
+
+    if (old_result.checksum != index_result.checksum) {
+        printf("MISMATCH: the lookups found different rnums.\n");
+        return 1;
+    }
+    printf("Speedup: %.2fx\n", old_result.seconds / index_result.seconds);
+    return 0;
+}
@@ -0,0 +1,157 @@
+import argparse
+import os
+import socket
+import statistics
+import subprocess
+import threading
+import time
+
+PULSE = 0.1  # seconds per game pulse
+PROMPT = b"Name: "
+BATCH = 50  # commands the probe types ahead; the game runs one per pulse
+
+
+def wait_for_game(host: str, port: int, timeout: float):
+    """The socket listens before the world is loaded, so wait for an answer."""
+    end = time.time() + timeout
+    while time.time() < end:
+        try:
+            with socket.create_connection((host, port), timeout=end - time.time()) as sock:
+                sock.sendall(b"1\r\n")
+                pending = b""
+                while PROMPT not in pending:
+                    data = sock.recv(65536)
+                    if not data:
+                        break
+                    pending += data
+                else:
+                    return
+        except OSError:
+            time.sleep(0.5)
+    raise RuntimeError(f"No game is answering on {host}:{port}")
+
+
+def flood(host: str, port: int, stop: threading.Event):
+    """Keep one connection busy: type far ahead and read everything that comes back."""
+    junk = b"x\r\n" * 500
+    while not stop.is_set():
+        try:
+            with socket.create_connection((host, port)) as sock:
+                sock.settimeout(0.05)
+                while not stop.is_set():
+                    sock.sendall(junk)
+                    try:
+                        while sock.recv(65536):
+                            pass
+                        break  # the server hung up (the name prompt times out); connect again
+                    except socket.timeout:
+                        pass
+        except OSError:
+            time.sleep(0.1)
+
+
+def probe(host: str, port: int, duration: float) -> list:
+    """
+    Type BATCH invalid names at once.  The game answers one per pulse, so
+    the gaps between the answers are the pulse lengths the players see.
+    """
+    gaps = []
+    sock = None
+    end = time.time() + duration
+    while time.time() < end:
+        if sock is None:
+            sock = socket.create_connection((host, port))
+            sock.settimeout(30)
+        sock.sendall(b"1\r\n" * BATCH)
+        seen, last, pending = 0, None, b""
+        while seen < BATCH:
+            data = sock.recv(65536)
+            if not data:  # timed out at the name prompt; start over
+                sock.close()
+                sock = None
+                break
+            pending += data
+            while PROMPT in pending:
+                pending = pending[pending.index(PROMPT) + len(PROMPT) :]
+                now = time.monotonic()
+                if last is not None:
+                    gaps.append(now - last)
+                last = now
+                seen += 1
+    if sock:
+        sock.close()
+    return gaps
+
+
+def measure(host: str, port: int, flooders: int, duration: float) -> list:
+    stop = threading.Event()
+    threads = [threading.Thread(target=flood, args=(host, port, stop), daemon=True) for _ in range(flooders)]
+    for thread in threads:
+        thread.start()
+    time.sleep(1)
+    try:
+        return probe(host, port, duration)
+    finally:
+        stop.set()
+        for thread in threads:
+            thread.join()
+
+
+def report(label: str, gaps: list):
+    jitter = sorted(abs(gap - PULSE) * 1000 for gap in gaps)
+    if not jitter:
+        print(f"{label}: no samples")
+        return
+
+    def pct(p):
+        return jitter[min(len(jitter) - 1, int(len(jitter) * p))]
+
+    print(
+        f"{label}: {len(jitter)} pulses, jitter ms: mean {statistics.mean(jitter):.2f}"
+        f"  p50 {pct(0.5):.2f}  p90 {pct(0.9):.2f}  p99 {pct(0.99):.2f}  max {jitter[-1]:.2f}"
+    )
+
+
+def run_server(binary: str, lib: str, port: int, threads: int, args) -> list:
+    server = subprocess.Popen(
+        [binary, f"-t{threads}", "-d", lib, str(port)],
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.DEVNULL,
+    )
+    try:
+        wait_for_game(args.host, port, args.boot_timeout)
+        return measure(args.host, port, args.flooders, args.duration)
+    finally:
+        server.terminate()
+        server.wait()
+
+
+def main(args):
+    if not args.binary:
+        report(f"{args.host}:{args.port}", measure(args.host, args.port, args.flooders, args.duration))
+        return
+
+    for threads in (0, args.threads):
+        label = f"{threads} I/O thread{'' if threads == 1 else 's'}" if threads else "game thread I/O"
+        report(label, run_server(os.path.abspath(args.binary), args.lib, args.port, threads, args))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Measure pulse jitter as seen by a client while other connections flood the server.",
+    )
+    parser.add_argument("--host", help="The server to connect to.", type=str, default="127.0.0.1")
+    parser.add_argument("--port", help="The port to connect to (or to start the server on).", type=int, default=4000)
+    parser.add_argument("--flooders", help="Connections flooding the server with input.", type=int, default=50)
+    parser.add_argument("--duration", help="Seconds to measure for.", type=float, default=30)
+    parser.add_argument(
+        "--binary",
+        help="Start this server binary twice, without and with I/O threads, and compare.  "
+        "If not specified, an already running server is measured.",
+        type=str,
+    )
+    parser.add_argument("--lib", help="The lib directory to start the server with.", type=str, default="../lib")
+    parser.add_argument("--threads", help="I/O threads for the second run.", type=int, default=2)
+    parser.add_argument("--boot-timeout", help="Seconds to wait for the server to boot.", type=float, default=120)
+    args = parser.parse_args()
+    main(args)
@@ -637,6 +637,11 @@ ACMD(do_gen_comm) {
         if (subcmd == SCMD_SHOUT &&
             (world[ch->in_room].zone != world[i->character->in_room].zone || !AWAKE(i->character)))
             continue;
+        /* Chatter is the first thing to go when a player's connection is backed up. */
+        if (output_backlogged(i)) {
+            ++output_chatter_dropped;
+            continue;
+        }
 
         if (COLOR_LEV(i->character) >= C_NRM)
             desc_printf(i, color_on);
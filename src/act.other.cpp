@@ -707,6 +707,7 @@ ACMD(do_shapechange) {
     mob->desc = ch->desc;
     ch->desc = nullptr;
     ch->forward = mob;
+    update_zone_occupancy(mob->desc);
 }
 
 bool creature_allowed_skill(CharData *ch, int skill) {
@@ -853,7 +854,7 @@ ACMD(do_camp) {
         char_printf(ch, "It's hard to set your tent up while dying...\n");
     else {
         /* create and initialize the camp event */
-        CREATE(ce, CampEvent, 1);
+        CREATE_EVENT_OBJ(ce, CampEvent);
         ce->ch = ch;
         ce->was_in = ch->in_room;
         event_create(EVENT_CAMP, camp_event, ce, true, &(ch->events), GET_LEVEL(ch) >= LVL_IMMORT ? 5 : 350);
@@ -49,6 +49,7 @@
 #include "structs.hpp"
 #include "sysdep.hpp"
 #include "textfiles.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
 #include "weather.hpp"
 
@@ -337,6 +338,7 @@ ACMD(do_linkload) {
             load_objects(victim);
             victim->next = character_list;
             character_list = victim;
+            char_uids.add(GET_ID(victim), victim);
             victim->desc = nullptr;
             act("You linkload $N.", false, ch, 0, victim, TO_CHAR);
             act("$n linkloads $N.", false, ch, 0, victim, TO_NOTVICT);
@@ -597,6 +599,7 @@ ACMD(do_switch) {
 
         victim->desc = ch->desc;
         ch->desc = nullptr;
+        update_zone_occupancy(victim->desc);
 
         if (!GET_PROMPT(victim) || IS_NPC(victim))
             GET_PROMPT(victim) = strdup(GET_PROMPT(ch));
@@ -671,6 +674,7 @@ ACMD(do_return) {
         ch->desc->original = nullptr;
 
         ch->desc->character->desc = ch->desc;
+        update_zone_occupancy(ch->desc);
         ch->desc = nullptr;
     } else
         char_printf(ch, "Huh?!?\n");
@@ -3048,6 +3052,7 @@ ACMD(do_pfilemaint) {
 
     player_table = new_player_table;
     top_of_p_table = j - 1;
+    index_player_table();
     save_player_index();
 
     log("PFILEMAINT: Done.");
@@ -3058,13 +3063,15 @@ ACMD(do_hotboot) {
     FILE *fp;
     bool found = false;
     DescriptorData *d, *d_next;
-    char buf[MAX_INPUT_LENGTH];
+    char buf[MAX_INPUT_LENGTH], threads_arg[16], lib_dir[PATH_MAX];
+    std::chrono::steady_clock::time_point give_up;
     int i;
 
     extern int num_hotboots;
     extern ush_int port;
     extern socket_t mother_desc;
     extern time_t *boot_time;
+    extern void ispell_init(void);
     extern void ispell_done(void);
 
     skip_spaces(&argument);
@@ -3121,22 +3128,42 @@ ACMD(do_hotboot) {
         fprintf(fp, " %ld", boot_time[i]); /* time of each boot */
     fprintf(fp, "\n");
 
+    /* The new process can't pick up a compressed stream */
+    for (d = descriptor_list; d; d = d->next)
+        stop_mccp(d);
+
+    /* Nor can it inherit the I/O threads; what they were given goes out first */
+    stop_network_threads();
+
+    /*
+     * Everything is sent through the output rings, which must be empty by
+     * the exec, so nothing plain can overtake the end of a compressed stream.
+     */
+    give_up = std::chrono::steady_clock::now() + std::chrono::seconds(HOTBOOT_DRAIN_SECS);
+
     /* For each playing descriptor, save its state */
     for (d = descriptor_list; d; d = d_next) {
         /* We delete from the list, so need to save this. */
         d_next = d->next;
 
         /* Drop those logging on */
-        if (!d->character || !IS_PLAYING(d)) {
-            write_to_descriptor(d->descriptor, "\nSorry, we are rebooting.  Come back in a minute.\n");
+        if (!d->character || !IS_PLAYING(d) || STATE(d) == CON_CLOSE) {
+            write_to_descriptor(d, "\nSorry, we are rebooting.  Come back in a minute.\n");
+            drain_output(d, give_up);
             close_socket(d); /* throw 'em out */
         } else {
             CharData *tch = d->character;
-            fprintf(fp, "%d %s %s\n", d->descriptor, GET_NAME(tch), d->host);
             /* save tch */
             GET_QUIT_REASON(tch) = QUIT_HOTBOOT; /* Not exactly leaving, but sort of */
             save_player(tch);
-            write_to_descriptor(d->descriptor, buf);
+            write_to_descriptor(d, buf);
+            /* The new process would pick up whatever its socket didn't take */
+            if (!drain_output(d, give_up)) {
+                log("Hotboot: {}'s connection isn't taking output; dropping it.", GET_NAME(tch));
+                close_socket(d);
+                continue;
+            }
+            fprintf(fp, "%d %s %s\n", d->descriptor, GET_NAME(tch), d->host);
         }
     }
 
@@ -3149,20 +3176,35 @@ ACMD(do_hotboot) {
     /* Prepare arguments to call self */
     sprintf(buf, "%d", port);
     sprintf(buf2, "-H%d", mother_desc);
+    sprintf(threads_arg, "-t%d", network_thread_count);
 
     /* Ugh, seems it is expected we are 1 step above lib - this may be dangerous!
      */
+    if (!getcwd(lib_dir, sizeof(lib_dir)))
+        *lib_dir = '\0';
     chdir("..");
 
     /* exec - descriptors are inherited! */
-    execl("bin/fiery", "fiery", buf2, buf, (char *)nullptr);
+    execl("bin/fiery", "fiery", buf2, threads_arg, buf, (char *)nullptr);
 
     /* Failed - successful exec will not return */
     perror("do_hotboot: execl");
-    write_to_descriptor(ch->desc->descriptor, "Hotboot FAILED!\n");
 
-    /* Too much trouble to try and recover! */
-    exit(1);
+    /*
+     * Carry on as before.  With -t, the sockets (and the mother socket)
+     * belonged to the I/O threads that were stopped above, so new ones
+     * take them over; otherwise the game loop is still watching them.
+     */
+    if (!*lib_dir || chdir(lib_dir) < 0) {
+        perror("SYSERR: do_hotboot: returning to the lib directory");
+        exit(1);
+    }
+    unlink(HOTBOOT_FILE);
+    ispell_init();
+    start_network_threads();
+    log("SYSERR: Hotboot by {} failed; the game continues.", GET_NAME(ch));
+    if (ch->desc)
+        char_printf(ch, "Hotboot FAILED!\n");
 }
 
 void scan_pfile_objs(CharData *ch, int vnum) {
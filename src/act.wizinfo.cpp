@@ -26,20 +26,24 @@
 #include "damage.hpp"
 #include "db.hpp"
 #include "dg_scripts.hpp"
+#include "event_profiler.hpp"
 #include "events.hpp"
 #include "exits.hpp"
 #include "fight.hpp"
 #include "handler.hpp"
 #include "house.hpp"
 #include "interpreter.hpp"
+#include "lag_profiler.hpp"
 #include "lifeforce.hpp"
 #include "limits.hpp"
 #include "logging.hpp"
+#include "mccp.hpp"
 #include "messages.hpp"
 #include "modify.hpp"
 #include "olc.hpp"
 #include "pfiles.hpp"
 #include "players.hpp"
+#include "pulse_clock.hpp"
 #include "quest.hpp"
 #include "races.hpp"
 #include "rogue.hpp"
@@ -50,6 +54,7 @@
 #include "string_utils.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
+#include "trigger_profiler.hpp"
 #include "utils.hpp"
 #include "version.hpp"
 #include "vsearch.hpp"
@@ -512,8 +517,8 @@ void do_stat_object(CharData *ch, ObjData *j) {
     resp += buf;
 
     /* Report any events attached. */
-    if (j->events) {
-        e = j->events;
+    if (j->events.head) {
+        e = j->events.head;
         resp += fmt::format("Events: {}", eventname(e));
         while (e->next) {
             e = e->next;
@@ -862,8 +867,8 @@ void do_stat_character(CharData *ch, CharData *k) {
     }
 
     /* Report any events attached. */
-    if (k->events) {
-        e = k->events;
+    if (k->events.head) {
+        e = k->events.head;
         resp += fmt::format("Events: {}", eventname(e));
         while (e->next) {
             e = e->next;
@@ -1364,9 +1369,99 @@ void do_show_stats(CharData *ch, char *argument) {
                 "   {:5d} objects               {:5d} prototypes\n"
                 "   {:5d} rooms                 {:5d} zones\n"
                 "   {:5d} large bufs\n"
-                "   {:5d} buf switches          {:5d} overflows\n",
+                "   {:5d} buf switches          {:5d} overflows\n"
+                "   {:5d} chatter drops\n",
                 players, connected, top_of_p_table + 1, mobiles, top_of_mobt + 1, objects, top_of_objt + 1,
-                top_of_world + 1, top_of_zone_table + 1, buf_largecount, buf_switches, buf_overflows);
+                top_of_world + 1, top_of_zone_table + 1, buf_largecount, buf_switches, buf_overflows,
+                output_chatter_dropped);
+    char_printf(ch,
+                "   {:5d} compressed links      {:5d}k compressor memory\n"
+                "   {:5d}k compressed to {}k ({}% saved)\n",
+                MccpStream::streams(), MccpStream::memory_in_use() / 1024, MccpStream::total_in() / 1024,
+                MccpStream::total_out() / 1024,
+                MccpStream::total_in() ? 100 - (int)(MccpStream::total_out() * 100 / MccpStream::total_in()) : 0);
+    const EventPoolStats &events = event_pool_stats();
+    char_printf(ch,
+                "   {:5d} event blocks in use   {:5d} event slabs ({}k)\n"
+                "   {:5d} event allocations     {:5d}% reused\n",
+                events.in_use, events.slabs, events.slabs * EVENT_SLAB_SIZE / 1024, events.allocations,
+                events.allocations ? (int)(events.reuses * 100 / events.allocations) : 0);
+}
+
+void do_show_lag(CharData *ch, char *argument) {
+    skip_spaces(&argument);
+
+    if (*argument && is_abbrev(argument, "reset")) {
+        lag_reset();
+        char_printf(ch, "Pulse phase timings cleared.\n");
+        return;
+    }
+
+    char_printf(ch, "Time spent in each phase of the pulse (\"Last\" is the last {:d} runs of each):\n\n{}",
+                LAG_HISTORY, lag_report());
+}
+
+void do_show_resets(CharData *ch, char *argument) { page_string(ch, zone_reset_report()); }
+
+void do_show_events(CharData *ch, char *argument) {
+    skip_spaces(&argument);
+
+    if (*argument && is_abbrev(argument, "reset")) {
+        event_profile_reset();
+        char_printf(ch, "Event statistics cleared.\n");
+        return;
+    }
+
+    page_string(ch, event_profile_report());
+}
+
+void do_show_triggers(CharData *ch, char *argument) {
+    char arg1[MAX_INPUT_LENGTH];
+    int count = TRIGGER_PROFILE_LIST;
+    bool zones = false;
+
+    argument = any_one_arg(argument, arg1);
+    if (*arg1 && is_abbrev(arg1, "reset")) {
+        trigger_profile_reset();
+        char_printf(ch, "Trigger statistics cleared.\n");
+        return;
+    }
+    if (*arg1 && is_abbrev(arg1, "zones")) {
+        zones = true;
+        argument = any_one_arg(argument, arg1);
+    }
+    if (*arg1) {
+        if (!is_number(arg1) || (count = atoi(arg1)) < 1) {
+            char_printf(ch, "Usage: show triggers [zones] [count]\n       show triggers reset\n");
+            return;
+        }
+    }
+
+    page_string(ch, zones ? trigger_profile_zone_report(count) : trigger_profile_report(count));
+}
+
+static std::string pulse_histogram_row(const char *label, const LatencyHistogram &histogram) {
+    return fmt::format("   {:<12} {:9.2f} {:9.2f} {:9.2f}\n", label, histogram.percentile(0.5).count() / 1e6,
+                       histogram.percentile(0.99).count() / 1e6, histogram.max().count() / 1e6);
+}
+
+void do_show_pulses(CharData *ch, char *argument) {
+    extern std::unique_ptr<PulseClock> pulse_clock;
+
+    if (!pulse_clock) {
+        char_printf(ch, "The pulse clock isn't running.\n");
+        return;
+    }
+
+    char_printf(ch,
+                "Pulses, scheduled by {}, {} ms apart:\n"
+                "   {:9d} pulses       {:9d} missed      {:9d} overran\n"
+                "\n"
+                "   Milliseconds       p50       p99       max\n"
+                "{}{}",
+                pulse_clock->name(), OPT_USEC / 1000, pulse_clock->pulses(), pulse_clock->missed(),
+                pulse_clock->overruns(), pulse_histogram_row("late", pulse_clock->lateness()),
+                pulse_histogram_row("processing", pulse_clock->processing()));
 }
 
 void do_show_errors(CharData *ch, char *argument) {
@@ -1938,17 +2033,21 @@ ACMD(do_show) {
                   {"datenames", LVL_IMMORT, do_show_date_names},
                   {"death", LVL_GOD, do_show_death},
                   {"errors", LVL_GRGOD, do_show_errors},
+                  {"events", LVL_IMMORT, do_show_events},
                   {"exp", LVL_IMMORT, do_show_exp},
                   {"file", LVL_GRGOD, do_show_file},
                   {"godrooms", LVL_GOD, do_show_godrooms},
                   {"groups", LVL_GOD, do_show_command_groups},
                   {"houses", LVL_GOD, do_show_houses},
+                  {"lag", LVL_IMMORT, do_show_lag},
                   {"lifeforces", LVL_IMMORT, do_show_lifeforces},
                   {"liquids", LVL_IMMORT, do_show_liquids},
                   {"notes", LVL_IMMORT, do_show_notes},
                   {"player", LVL_GOD, do_show_player},
+                  {"pulses", LVL_IMMORT, do_show_pulses},
                   {"races", LVL_IMMORT, do_show_races},
                   {"rent", LVL_GOD, show_rent},
+                  {"resets", LVL_IMMORT, do_show_resets},
                   {"sectors", LVL_IMMORT, do_show_sectors},
                   {"shops", LVL_GOD, show_shops},
                   {"sizes", LVL_IMMORT, do_show_sizes},
@@ -1956,6 +2055,7 @@ ACMD(do_show) {
                   {"snoop", LVL_GOD, do_show_snoop},
                   {"spell", LVL_IMMORT, do_show_skill},
                   {"stats", LVL_IMMORT, do_show_stats},
+                  {"triggers", LVL_IMMORT, do_show_triggers},
                   {"zones", LVL_IMMORT, do_show_zones},
                   {nullptr, 0, nullptr}};
 
@@ -184,7 +184,7 @@ EVENTFUNC(delayed_cast_event) {
 DelayedCastEventObj *construct_delayed_cast(CharData *ch, CharData *victim, int spellnum, int routines, int rounds,
                                             int wait, int skill, int savetype, bool sustained) {
     DelayedCastEventObj *event_obj;
-    CREATE(event_obj, DelayedCastEventObj, 1);
+    CREATE_EVENT_OBJ(event_obj, DelayedCastEventObj);
     event_obj->ch = ch;
     event_obj->victim = victim;
     event_obj->spell = spellnum;
@@ -16,6 +16,7 @@
 #include "board.hpp"
 #include "casting.hpp"
 #include "clan.hpp"
+#include "command_queue.hpp"
 #include "commands.hpp"
 #include "conf.hpp"
 #include "constants.hpp"
@@ -25,26 +26,36 @@
 #include "directions.hpp"
 #include "editor.hpp"
 #include "effects.hpp"
+#include "event_profiler.hpp"
 #include "events.hpp"
 #include "exits.hpp"
 #include "fight.hpp"
 #include "handler.hpp"
 #include "house.hpp"
 #include "interpreter.hpp"
+#include "lag_profiler.hpp"
 #include "logging.hpp"
 #include "mail.hpp"
 #include "math.hpp"
+#include "mccp.hpp"
 #include "modify.hpp"
+#include "network_thread.hpp"
 #include "olc.hpp"
+#include "output_queue.hpp"
 #include "pfiles.hpp"
 #include "players.hpp"
+#include "poller.hpp"
+#include "pulse_clock.hpp"
 #include "races.hpp"
+#include "resolver.hpp"
+#include "ring_buffer.hpp"
 #include "rules.hpp"
 #include "screen.hpp"
 #include "skills.hpp"
 #include "string_utils.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
+#include "telnet_parser.hpp"
 #include "utils.hpp"
 #include "version.hpp"
 #include "weather.hpp"
@@ -52,9 +63,13 @@
 #include <fmt/format.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <optional>
+#include <poll.h>
 #include <signal.h>
 #include <sys/resource.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <unordered_map>
 #include <utility>
 
 #ifdef HAVE_ARPA_TELNET_H
@@ -84,29 +99,37 @@ ACMD(do_shapechange);
 ush_int port;
 socket_t mother_desc;
 
-struct timeval null_time;
-
 DescriptorData *descriptor_list = nullptr; /* master desc list */
+std::unique_ptr<DescriptorPoller> poller;  /* watches mother_desc and every descriptor */
+std::unique_ptr<PulseClock> pulse_clock;   /* says when the next pulse is due */
+std::unique_ptr<HostResolver> resolver;    /* looks up sitenames off the game thread */
 unsigned long global_pulse = 0;            /* number of pulses since game start */
 unsigned long pulse = 0;                   /* number of pulses since game started */
 
+/* With -t, the sockets belong to these and the game hears about them by desc_num. */
+std::vector<std::unique_ptr<NetworkThread>> network_threads;
+static std::unordered_map<int, DescriptorData *> network_descriptors;
+
 /* local globals */
 char comm_buf[MAX_STRING_LENGTH] = {'\0'};
 txt_block *bufpool = 0;        /* pool of large output buffers */
 int buf_largecount = 0;        /* # of large buffers which exist */
 int buf_overflows = 0;         /* # of overflows of output */
+int output_chatter_dropped = 0; /* # of channel messages not sent to backlogged descriptors */
 int buf_switches = 0;          /* # of switches from small to large buf */
 int circle_shutdown = 0;       /* clean shutdown */
+volatile sig_atomic_t lag_dump_requested = 0; /* log the pulse timings (SIGUSR1) */
 int circle_reboot = 0;         /* reboot the game after a shutdown */
 int no_specials = 0;           /* Suppress ass. of special routines */
 int max_players = 0;           /* max descriptors available */
 int tics = 0;                  /* for extern checkpointing */
 int scheck = 0;                /* for syntax checking mode */
+int reset_benchmark = 0;       /* zone reset rounds to time instead of running (-b) */
 int dg_act_check;              /* toggle for act_trigger */
 int gossip_channel_active = 1; /* Flag for turning on or off gossip for the whole MUD */
+int network_thread_count = 0;  /* I/O threads to hand the sockets to (0: do it all here) */
 
 /* functions in this file */
-int get_from_q(txt_q *queue, char *dest, int *aliased);
 void init_game(int port);
 void signal_setup(void);
 void game_loop(int mother_desc);
@@ -114,17 +137,21 @@ int init_socket(int port);
 int new_descriptor(int s);
 int get_max_players(void);
 int process_output(DescriptorData *t);
+int flush_output(DescriptorData *t);
+static int send_pulse_output(DescriptorData *t);
 int process_input(DescriptorData *t);
 void close_socket(DescriptorData *d);
-timeval timediff(timeval a, timeval b);
-timeval timeadd(timeval a, timeval b);
 void flush_queues(DescriptorData *d);
 void nonblock(socket_t s);
+int poll_descriptors(int timeout_ms);
+void process_network_events(void);
+void process_resolved_hosts(void);
 int perform_subst(DescriptorData *t, char *orig, char *subst);
 int perform_alias(DescriptorData *d, char *orig);
 void record_usage(void);
 void send_gmcp_char_info(DescriptorData *d);
 void make_prompt(DescriptorData *d);
+void offer_mccp(DescriptorData *d);
 void check_idle_passwords(void);
 void heartbeat(int pulse);
 char *new_txt;
@@ -136,6 +163,8 @@ void free_bufpools(void);
 void boot_db(void);
 void boot_world(void);
 void zone_update(void);
+void run_zone_resets(void);
+void benchmark_zone_resets(int rounds);
 void effect_update(void); /* In spells.c */
 void point_update(void);  /* In limits.c */
 void sick_update(void);   /* In limits.c */
@@ -160,6 +189,8 @@ void free_invalid_list(void);
  *  main game loop and related stuff                                    *
  ********************************************************************* */
 
+/* The tests have Catch2's main() instead. */
+#ifndef FIERYMUD_TESTS
 int main(int argc, char **argv) {
     int pos = 1;
     const char *dir, *env;
@@ -194,6 +225,27 @@ int main(int argc, char **argv) {
             num_hotboots = 1;
             mother_desc = atoi(argv[pos] + 2);
             break;
+        case 't': /* -t<threads> move socket I/O off the game thread */
+            if (*(argv[pos] + 2))
+                network_thread_count = atoi(argv[pos] + 2);
+            else if (++pos < argc)
+                network_thread_count = atoi(argv[pos]);
+            else {
+                log("Thread count expected after option -t.");
+                exit(1);
+            }
+            break;
+        case 'b': /* -b<rounds> time resetting every zone, then exit */
+            if (*(argv[pos] + 2))
+                reset_benchmark = atoi(argv[pos] + 2);
+            else if (++pos < argc)
+                reset_benchmark = atoi(argv[pos]);
+            if (reset_benchmark <= 0) {
+                log("Number of rounds expected after option -b.");
+                exit(1);
+            }
+            log("Zone reset benchmark mode enabled.");
+            break;
         case 'c':
             scheck = 1;
             log("Syntax check mode enabled.");
@@ -219,7 +271,7 @@ int main(int argc, char **argv) {
 
     if (pos < argc) {
         if (!isdigit(*argv[pos])) {
-            fprintf(stderr, "Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n", argv[0]);
+            fprintf(stderr, "Usage: %s [-b rounds] [-c] [-m] [-q] [-r] [-s] [-t threads] [-d pathname] [port #]\n", argv[0]);
             exit(1);
         } else if ((port = atoi(argv[pos])) <= 1024) {
             fprintf(stderr, "Illegal port number.\n");
@@ -257,6 +309,10 @@ int main(int argc, char **argv) {
 
     if (scheck) {
         boot_world();
+    } else if (reset_benchmark) {
+        event_init();
+        boot_db();
+        benchmark_zone_resets(reset_benchmark);
     } else {
         log("Running game on port {:d}.", port);
         init_game(port);
@@ -267,6 +323,7 @@ int main(int argc, char **argv) {
 
     return 0;
 }
+#endif
 
 void hotboot_recover() {
     DescriptorData *d;
@@ -322,11 +379,23 @@ void hotboot_recover() {
         /* Create a new descriptor */
         CREATE(d, DescriptorData, 1);
         memset((char *)d, 0, sizeof(DescriptorData));
+        if (!network_threads.empty())
+            d->desc_num = NetworkThread::claim_desc_num();
         init_descriptor(d, desc); /* set up various stuff */
 
         strcpy(d->host, host);
         d->next = descriptor_list;
         descriptor_list = d;
+        if (!network_threads.empty()) {
+            /* Share the survivors out among the I/O threads. */
+            d->network = network_threads[count % network_threads.size()].get();
+            d->network->adopt(d->desc_num, desc);
+            network_descriptors[d->desc_num] = d;
+        } else if (!poller->add(desc, d)) {
+            close_socket(d);
+            continue;
+        } else
+            SET_BIT(d->poll_events, POLL_WRITE); /* it took our message just now */
 
         d->connected = CON_CLOSE;
 
@@ -345,13 +414,15 @@ void hotboot_recover() {
             fOld = false;
 
         if (!fOld) {
-            write_to_descriptor(desc, "\nSomehow, your character was lost in the hotboot.  Sorry.\n");
+            write_to_descriptor(d, "\nSomehow, your character was lost in the hotboot.  Sorry.\n");
             close_socket(d);
         } else {
             sprintf(buf, "\n%sHotboot recovery complete.%s\n", CLR(d->character, HGRN), CLR(d->character, ANRM));
-            write_to_descriptor(desc, buf);
+            write_to_descriptor(d, buf);
+            offer_mccp(d);
             enter_player_game(d);
             d->connected = CON_PLAYING;
+            update_zone_occupancy(d);
             look_at_room(d->character, false);
         }
     }
@@ -375,6 +446,23 @@ void init_game(int port) {
         mother_desc = init_socket(port);
     }
 
+    resolver = std::make_unique<HostResolver>(HostResolver::system_lookup, resolver_cache_size,
+                                              std::chrono::seconds(resolver_cache_ttl));
+
+    poller = make_descriptor_poller();
+    log("Using {} to multiplex sockets.", poller->name());
+    if (network_thread_count <= 0 && !poller->add(mother_desc, nullptr)) {
+        log("SYSERR: Unable to watch the mother connection.");
+        exit(1);
+    }
+
+    pulse_clock = std::make_unique<PulseClock>(std::chrono::microseconds(OPT_USEC));
+    log("Using {} to schedule pulses.", pulse_clock->name());
+    if (pulse_clock->fd() >= 0 && !poller->add(pulse_clock->fd(), pulse_clock.get())) {
+        log("SYSERR: Unable to watch the pulse timer.");
+        exit(1);
+    }
+
     event_init();
 
     boot_db();
@@ -386,6 +474,9 @@ void init_game(int port) {
     reboot_pulse = 3600 * PASSES_PER_SEC * (reboot_hours_base - reboot_hours_deviation) +
                    random_number(0, 3600 * PASSES_PER_SEC * 2 * reboot_hours_deviation);
 
+    /* Until now, new connections have simply waited in the listen queue. */
+    start_network_threads();
+
     if (num_hotboots > 0)
         hotboot_recover();
 
@@ -402,8 +493,15 @@ void init_game(int port) {
     log("Closing all sockets.");
     while (descriptor_list)
         close_socket(descriptor_list);
+    stop_network_threads();
 
+    poller->remove(mother_desc);
     CLOSE_SOCKET(mother_desc);
+    if (pulse_clock->fd() >= 0)
+        poller->remove(pulse_clock->fd());
+    pulse_clock.reset();
+    poller.reset();
+    resolver.reset();
 
     if (circle_reboot != 2 && olc_save_list) { /* Don't save zones. */
         OLCSaveInfo *entry, *next_entry;
@@ -723,20 +821,15 @@ void check_auto_rebooting() {
  * such as mobile_activity().
  */
 void game_loop(int mother_desc) {
-    fd_set input_set, output_set, exc_set, null_set;
-    timeval last_time, before_sleep, opt_time, process_time, now, timeout;
     char comm[MAX_INPUT_LENGTH];
     DescriptorData *d, *next_d;
-    int missed_pulses, maxdesc, aliased;
-
-    /* initialize various time values */
-    null_time.tv_sec = 0;
-    null_time.tv_usec = 0;
-    opt_time.tv_usec = OPT_USEC;
-    opt_time.tv_sec = 0;
-    FD_ZERO(&null_set);
+    int missed_pulses, aliased;
+    std::optional<LagTimer> lag_timer; /* times the current phase of the pulse */
+    std::chrono::steady_clock::time_point commands_start, events_start;
+    std::chrono::steady_clock::duration command_events; /* running events between commands */
+    extern Queue *event_q;
 
-    gettimeofday(&last_time, nullptr);
+    pulse_clock->restart();
 
     /* The Main Loop.  The Big Cheese.  The Top Dog.  The Head Honcho.  The.. */
     while (!circle_shutdown) {
@@ -744,106 +837,79 @@ void game_loop(int mother_desc) {
         /* Sleep if we don't have any connections and are not about to reboot */
         if (descriptor_list == nullptr && !reboot_warning) {
             log("No connections.  Going to sleep.");
-            FD_ZERO(&input_set);
-            FD_SET(mother_desc, &input_set);
-            if (select(mother_desc + 1, &input_set, (fd_set *)0, (fd_set *)0, nullptr) < 0) {
-                if (errno == EINTR)
-                    log("Waking up to process signal.");
-                else
-                    perror("Select coma");
-            } else
+            pulse_clock->pause();
+            if (poll_descriptors(-1) < 0) {
+                perror("Poll coma");
+                return;
+            }
+            if (descriptor_list)
                 log("New connection.  Waking up.");
-            gettimeofday(&last_time, nullptr);
-        }
-        /* Set up the input, output, and exception sets for select(). */
-        FD_ZERO(&input_set);
-        FD_ZERO(&output_set);
-        FD_ZERO(&exc_set);
-        FD_SET(mother_desc, &input_set);
-
-        maxdesc = mother_desc;
-        for (d = descriptor_list; d; d = d->next) {
-            if (d->descriptor > maxdesc)
-                maxdesc = d->descriptor;
-            FD_SET(d->descriptor, &input_set);
-            FD_SET(d->descriptor, &output_set);
-            FD_SET(d->descriptor, &exc_set);
+            else
+                log("Waking up.");
+            pulse_clock->restart();
         }
 
         /*
          * At this point, we have completed all input, output and heartbeat
          * activity from the previous iteration, so we have to put ourselves
-         * to sleep until the next 0.1 second tick.  The first step is to
-         * calculate how long we took processing the previous iteration.
+         * to sleep until the next 0.1 second tick.  The wait for socket
+         * activity is the sleep: new connections are accepted and readiness
+         * is recorded as it arrives, until the pulse clock says it's time.
          */
-
-        gettimeofday(&before_sleep, nullptr); /* current time */
-        process_time = timediff(before_sleep, last_time);
+        while (!pulse_clock->due())
+            if (poll_descriptors(pulse_clock->wait_ms()) < 0) {
+                perror("Poll sleep");
+                return;
+            }
 
         /*
-         * If we were asleep for more than one pass, count missed pulses and sleep
-         * until we're resynchronized with the next upcoming pulse.
+         * If we slept (or worked) through more than one pass, the pulses we
+         * missed are made up for below.
          */
-        if (process_time.tv_sec == 0 && process_time.tv_usec < OPT_USEC) {
-            missed_pulses = 0;
-        } else {
-            missed_pulses = process_time.tv_sec * PASSES_PER_SEC;
-            missed_pulses += process_time.tv_usec / OPT_USEC;
-            process_time.tv_sec = 0;
-            process_time.tv_usec = process_time.tv_usec % OPT_USEC;
-        }
-
-        /* Calculate the time we should wake up */
-        last_time = timeadd(before_sleep, timediff(opt_time, process_time));
+        missed_pulses = pulse_clock->begin_pulse() - 1;
 
-        /* Now keep sleeping until that time has come */
-        gettimeofday(&now, nullptr);
-        timeout = timediff(last_time, now);
+        /* Fill in any sitenames the resolver has come up with. */
+        process_resolved_hosts();
 
-        /* go to sleep */
-        do {
-            if (select(0, (fd_set *)0, (fd_set *)0, (fd_set *)0, &timeout) < 0) {
-                if (errno != EINTR) {
-                    perror("Select sleep");
-                    exit(1);
-                }
-            }
-            gettimeofday(&now, nullptr);
-            timeout = timediff(last_time, now);
-        } while (timeout.tv_usec || timeout.tv_sec);
-
-        /* poll (without blocking) for new input, output, and exceptions */
-        if (select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) < 0) {
-            perror("Select poll");
-            return;
+        /* A kill -USR1 asked for the pulse timings. */
+        if (lag_dump_requested) {
+            lag_dump_requested = 0;
+            lag_log_report();
+            event_profile_log_report();
         }
-        /* If there are new connections waiting, accept them. */
-        if (FD_ISSET(mother_desc, &input_set))
-            new_descriptor(mother_desc);
+
+        lag_timer.emplace(LAG_INPUT);
 
         /* kick out the freaky folks in the exception set */
         for (d = descriptor_list; d; d = next_d) {
             next_d = d->next;
-            if (FD_ISSET(d->descriptor, &exc_set)) {
-                FD_CLR(d->descriptor, &input_set);
-                FD_CLR(d->descriptor, &output_set);
+            if (IS_SET(d->poll_events, POLL_ERROR))
                 close_socket(d);
-            }
         }
 
-        /* process descriptors with input pending */
+        /* process descriptors with input pending; process_input reads until it would block */
         for (d = descriptor_list; d; d = next_d) {
             next_d = d->next;
-            if (FD_ISSET(d->descriptor, &input_set))
+            if (IS_SET(d->poll_events, POLL_READ)) {
+                REMOVE_BIT(d->poll_events, POLL_READ);
                 if (process_input(d) < 0)
                     close_socket(d);
+            }
         }
 
+        /*
+         * The events run after each command are charged to a phase of their
+         * own, so the commands phase is the commands alone.
+         */
+        lag_timer.reset();
+        commands_start = std::chrono::steady_clock::now();
+        command_events = std::chrono::steady_clock::duration::zero();
+
         /* process commands we just read from process_input */
         for (d = descriptor_list; d; d = next_d) {
             next_d = d->next;
 
-            if ((--(d->wait) <= 0) && get_from_q(&d->input, comm, &aliased)) {
+            if ((--(d->wait) <= 0) && d->input->pop(comm, &aliased)) {
                 if (d->character) {
                     /* reset the idle timer & pull char back from void if necessary */
                     if (d->original)
@@ -875,23 +941,36 @@ void game_loop(int mother_desc) {
                     if (aliased) /* to prevent recursive aliases */
                         d->prompt_mode = 0;
                     else if (perform_alias(d, comm)) /* run it through aliasing system */
-                        get_from_q(&d->input, comm, &aliased);
+                        d->input->pop(comm, &aliased);
                     desc_printf(d, "\n");
                     command_interpreter(d->character, comm); /* send it to interpreter */
                 }
             }
+            events_start = std::chrono::steady_clock::now();
             event_process();
+            command_events += std::chrono::steady_clock::now() - events_start;
         }
 
-        /* send queued output out to the operating system (ultimately to user) */
+        lag_record(LAG_COMMANDS, std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - commands_start - command_events));
+        lag_record(LAG_CMD_EVENTS, std::chrono::duration_cast<std::chrono::microseconds>(command_events));
+
+        lag_timer.emplace(LAG_OUTPUT);
+
+        /*
+         * send queued output out to the operating system (ultimately to user).
+         * Output is always moved into the descriptor's ring so it stays
+         * bounded; it only reaches the socket when the socket is writable.
+         */
         for (d = descriptor_list; d; d = next_d) {
             next_d = d->next;
-            if (FD_ISSET(d->descriptor, &output_set) && !d->output.empty()) {
+            if (!d->output->empty()) {
                 if (process_output(d) < 0)
                     close_socket(d);
                 else
                     d->prompt_mode = 1;
-            }
+            } else if (send_pulse_output(d) < 0)
+                close_socket(d);
         }
 
         /* kick out folks in the CON_CLOSE state */
@@ -909,6 +988,12 @@ void game_loop(int mother_desc) {
             }
         }
 
+        /* The I/O threads can start writing this pulse's output. */
+        for (auto &network : network_threads)
+            network->wake();
+
+        lag_timer.reset(); /* the heartbeat functions time themselves */
+
         /*
          * Now, we execute as many pulses as necessary--just one if we haven't
          * missed any pulses, or make up for lost time if we missed a few
@@ -929,35 +1014,130 @@ void game_loop(int mother_desc) {
 
         /* Now execute the heartbeat functions */
         while (missed_pulses--) {
-            event_process();
+            /* Before any event runs, so its lateness is reckoned from this pulse */
+            event_profile_pulse(pulse_clock->due_at(missed_pulses), event_q->size);
+            {
+                LagTimer timer(LAG_EVENTS);
+                event_process();
+            }
             heartbeat(++pulse);
         }
 
         /* Update tics for deadlock protection (UNIX only) */
         tics++;
+
+        pulse_clock->end_pulse();
+    }
+}
+
+/*
+ * Wait up to timeout_ms for socket activity (forever if negative).  New
+ * connections are accepted right away; readiness on player sockets is
+ * recorded in poll_events for the game loop to act upon.  With I/O
+ * threads, the only thing to wait for is news from them.
+ */
+int poll_descriptors(int timeout_ms) {
+    PollEvent events[MAX_POLL_EVENTS];
+    DescriptorData *d;
+    int i, count;
+
+    if ((count = poller->wait(events, MAX_POLL_EVENTS, timeout_ms)) < 0)
+        return errno == EINTR ? 0 : -1;
+
+    for (i = 0; i < count; ++i) {
+        if (events[i].data == pulse_clock.get())
+            pulse_clock->acknowledge(); /* the game loop will see the pulse is due */
+        else if (!network_threads.empty())
+            continue; /* an I/O thread has news for process_network_events() */
+        else if (!events[i].data) {
+            /* The mother socket: accept everyone who is waiting. */
+            if (IS_SET(events[i].events, POLL_READ))
+                while (new_descriptor(mother_desc) >= 0)
+                    ;
+        } else {
+            d = (DescriptorData *)events[i].data;
+            SET_BIT(d->poll_events, events[i].events);
+        }
+    }
+
+    if (!network_threads.empty())
+        process_network_events();
+
+    return count;
+}
+
+/*
+ * Fill in sitenames that the resolver has finished looking up, and apply
+ * any ban that the name (rather than the number) brings to light.
+ */
+void process_resolved_hosts(void) {
+    DescriptorData *d;
+    int ban;
+
+    for (auto &result : resolver->collect()) {
+        if (result.hostname.empty())
+            continue;
+        for (d = descriptor_list; d; d = d->next)
+            if (d->resolve_id == result.id)
+                break;
+        if (!d || STATE(d) == CON_CLOSE)
+            continue;
+
+        strncpy(d->host, result.hostname.c_str(), HOST_LENGTH);
+        *(d->host + HOST_LENGTH) = '\0';
+
+        ban = isbanned(d->host);
+        if (ban == BAN_ALL) {
+            desc_printf(d, "{}{}{}\n Connection logged from: {}\n\n", BANNEDINTHEUSA, BANNEDINTHEUSA2,
+                        BANNEDINTHEUSA3, d->host);
+            log(LogSeverity::Stat, LVL_GOD, "BANNED: Connection from [{}] closed once its name resolved", d->host);
+            STATE(d) = CON_CLOSE;
+            update_zone_occupancy(d);
+        } else if (ban == BAN_SELECT && d->character && STATE(d) != CON_GET_NAME && STATE(d) != CON_NAME_CNFRM &&
+                   STATE(d) != CON_PASSWORD && !PLR_FLAGGED(d->character, PLR_SITEOK)) {
+            /* Already past the login check that would have caught this. */
+            desc_printf(d, "Sorry, this char has not been cleared for login from your site!\n");
+            log(LogSeverity::Stat, LVL_GOD, "Connection for {} closed once its site resolved to {}",
+                GET_NAME(d->character), d->host);
+            STATE(d) = CON_CLOSE;
+            update_zone_occupancy(d);
+        }
     }
 }
 
 void heartbeat(int pulse) {
     static int mins_since_autosave = 0;
+    std::optional<LagTimer> lag_timer;
 
     global_pulse++;
 
-    if (!(pulse % PULSE_DG_SCRIPT))
+    if (!(pulse % PULSE_DG_SCRIPT)) {
+        LagTimer timer(LAG_SCRIPTS);
         script_trigger_check();
+    }
 
-    event_process();
+    {
+        LagTimer timer(LAG_EVENTS);
+        event_process();
+    }
 
-    if (!(pulse % PULSE_ZONE))
-        zone_update();
+    {
+        LagTimer timer(LAG_ZONES);
+        if (!(pulse % PULSE_ZONE))
+            zone_update();
+        run_zone_resets();
+    }
 
     if (!(pulse % (15 * PASSES_PER_SEC))) /* 15 seconds */
         check_idle_passwords();
 
-    if (!(pulse % PULSE_MOBILE))
+    if (!(pulse % PULSE_MOBILE)) {
+        LagTimer timer(LAG_MOBILES);
         mobile_activity();
+    }
 
     if (!(pulse % PULSE_VIOLENCE)) {
+        LagTimer timer(LAG_VIOLENCE);
         perform_violence();
         mobile_spec_activity();
     }
@@ -965,6 +1145,7 @@ void heartbeat(int pulse) {
     if (!(pulse % (PULSE_VIOLENCE / 2))) {
         /* Every other combat round, NPCs in battle attempt skill and
          * spell-based attacks. */
+        LagTimer timer(LAG_MOB_VIOLENCE);
         perform_mob_violence();
     }
 
@@ -975,30 +1156,43 @@ void heartbeat(int pulse) {
 
     if (!(pulse % (PULSE_VIOLENCE * 6))) {
         /* Check poison and disease every 6 rounds. */
+        LagTimer timer(LAG_SICKNESS);
         sick_update();
     }
 
     if (!(pulse % (SECS_PER_MUD_HOUR * PASSES_PER_SEC))) {
+        lag_timer.emplace(LAG_TIME);
         update_weather(pulse);
         increment_game_time(); /* Increment game time by an hour. */
+        lag_timer.emplace(LAG_EFFECTS);
         effect_update();
+        lag_timer.emplace(LAG_POINTS);
         point_update();
+        lag_timer.emplace(LAG_SCRIPTS);
         check_time_triggers();
+        lag_timer.reset();
     }
 
     if (!(pulse % PULSE_AUTOSAVE)) { /* 1 minute */
         if (++mins_since_autosave >= 1) {
             mins_since_autosave = 0;
+            lag_timer.emplace(LAG_SAVES);
             auto_save_all();
+            lag_timer.emplace(LAG_HOUSES);
             House_save_all();
+            lag_timer.reset();
         }
     }
+    if (!(pulse % EVENT_PROFILE_LOG_INTERVAL))
+        event_profile_log_report();
+
     /* Commenting entire 5 minute check section because there would be
        nothing to run once this since function was commented - RSD  */
     /* if (!(pulse % (5 * 60 * PASSES_PER_SEC))) {  */ /* 5 minutes */
     /*  record_usage();
        }
      */
+    LagTimer timer(LAG_EVENTS);
     event_process();
 }
 
@@ -1006,55 +1200,6 @@ void heartbeat(int pulse) {
  *  general utility stuff (for local use)                            *
  ****************************************************************** */
 
-/*
- *  new code to calculate time differences, which works on systems
- *  for which tv_usec is unsigned (and thus comparisons for something
- *  being < 0 fail).  Based on code submitted by ss@sirocco.cup.hp.com.
- */
-
-/*
- * code to return the time difference between a and b (a-b).
- * always returns a nonnegative value (floors at 0).
- */
-timeval timediff(timeval a, timeval b) {
-    timeval rslt;
-
-    if (a.tv_sec < b.tv_sec)
-        return null_time;
-    else if (a.tv_sec == b.tv_sec) {
-        if (a.tv_usec < b.tv_usec)
-            return null_time;
-        else {
-            rslt.tv_sec = 0;
-            rslt.tv_usec = a.tv_usec - b.tv_usec;
-            return rslt;
-        }
-    } else { /* a->tv_sec > b->tv_sec */
-        rslt.tv_sec = a.tv_sec - b.tv_sec;
-        if (a.tv_usec < b.tv_usec) {
-            rslt.tv_usec = a.tv_usec + 1000000 - b.tv_usec;
-            rslt.tv_sec--;
-        } else
-            rslt.tv_usec = a.tv_usec - b.tv_usec;
-        return rslt;
-    }
-}
-
-/* add 2 timevals */
-timeval timeadd(timeval a, timeval b) {
-    timeval rslt;
-
-    rslt.tv_sec = a.tv_sec + b.tv_sec;
-    rslt.tv_usec = a.tv_usec + b.tv_usec;
-
-    while (rslt.tv_usec >= 1000000) {
-        rslt.tv_usec -= 1000000;
-        rslt.tv_sec++;
-    }
-
-    return rslt;
-}
-
 void record_usage(void) {
     int sockets_connected = 0, sockets_playing = 0;
     DescriptorData *d;
@@ -1070,26 +1215,88 @@ void record_usage(void) {
 
 void offer_mssp(DescriptorData *d) {
     char offer_mssp[] = {(char)IAC, (char)WILL, (char)MSSP, (char)0};
-    write_to_descriptor(d->descriptor, offer_mssp);
+    write_to_descriptor(d, offer_mssp);
 }
 
 void offer_gmcp(DescriptorData *d) {
     char offer_gmcp[] = {(char)IAC, (char)WILL, (char)GMCP, (char)0};
-    write_to_descriptor(d->descriptor, offer_gmcp);
+    write_to_descriptor(d, offer_gmcp);
+}
+
+void offer_mccp(DescriptorData *d) {
+    char offer_mccp[] = {(char)IAC, (char)WILL, (char)MCCP2, (char)0};
+    if (mccp_memory_limit > 0)
+        write_to_descriptor(d, offer_mccp);
+}
+
+/*
+ * The client said DO MCCP2: everything after the subnegotiation below is
+ * compressed.  If the compressors are already using all the memory
+ * they're allowed, the client is told WONT and keeps plain text.
+ */
+static void start_mccp(DescriptorData *d) {
+    char start_mccp[] = {(char)IAC, (char)SB, (char)MCCP2, (char)IAC, (char)SE, (char)0};
+    char refuse_mccp[] = {(char)IAC, (char)WONT, (char)MCCP2, (char)0};
+    MccpStream *stream;
+
+    if (d->mccp)
+        return;
+
+    if (!MccpStream::can_start(mccp_memory_limit)) {
+        write_to_descriptor(d, refuse_mccp);
+        return;
+    }
+
+    stream = new MccpStream;
+    if (!stream->ok()) {
+        log("SYSERR: unable to start MCCP2 compression for {}", d->host);
+        delete stream;
+        write_to_descriptor(d, refuse_mccp);
+        return;
+    }
+
+    write_to_descriptor(d, start_mccp);
+    d->mccp = stream;
+}
+
+/*
+ * End the compressed stream (if any) so the client is back to plain text.
+ * The end can't be cut short, so if the ring has no room for it even
+ * after sending what the socket will take, the connection is closed.
+ */
+void stop_mccp(DescriptorData *d) {
+    std::string_view end;
+
+    if (!d->mccp)
+        return;
+
+    end = d->mccp->finish();
+    if (end.size() > d->outring->space())
+        flush_output(d);
+    if (end.size() > d->outring->space()) {
+        log("SYSERR: No room to end the MCCP2 stream to {}; closing the connection.", d->host);
+        d->outring->clear();
+        STATE(d) = CON_CLOSE;
+        update_zone_occupancy(d);
+    } else
+        d->outring->write(end);
+    delete d->mccp;
+    d->mccp = nullptr;
+    flush_output(d);
 }
 
 void request_ttype(DescriptorData *d) {
     char request_ttype[] = {(char)IAC, (char)DO, (char)TELOPT_TTYPE, (char)0};
-    write_to_descriptor(d->descriptor, request_ttype);
+    write_to_descriptor(d, request_ttype);
 }
 
 void send_opt(DescriptorData *d, byte a) {
     const byte buf[] = {(char)IAC, (char)SB, a, (char)TELQUAL_SEND, (char)IAC, (char)SE};
-    write_to_descriptor(d->descriptor, buf);
+    write_to_descriptor(d, std::string_view((const char *)buf, sizeof(buf)));
 }
 
 void send_gmcp(DescriptorData *d, std::string_view package, json j) {
-    write_to_descriptor(d->descriptor, fmt::format("{}{} {}{}", gmcp_start_data, package, j.dump(), gmcp_end_data));
+    write_to_descriptor(d, fmt::format("{}{} {}{}", gmcp_start_data, package, j.dump(), gmcp_end_data));
 }
 
 void offer_gmcp_services(DescriptorData *d) {
@@ -1165,11 +1372,11 @@ void handle_telopt_request(DescriptorData *d, char *txt) {
     if (supports_ansi(txt)) {
         SET_FLAG(PRF_FLAGS(d->character), PRF_COLOR_1);
         SET_FLAG(PRF_FLAGS(d->character), PRF_COLOR_2);
-        write_to_descriptor(d->descriptor, "Color is on.\r\n");
+        write_to_descriptor(d, "Color is on.\r\n");
     } else {
         REMOVE_FLAG(PRF_FLAGS(d->character), PRF_COLOR_1);
         REMOVE_FLAG(PRF_FLAGS(d->character), PRF_COLOR_2);
-        write_to_descriptor(d->descriptor, "Color is off.\r\n");
+        write_to_descriptor(d, "Color is off.\r\n");
     }
     if ((get_build_number() >= 0)) {
         sprintf(bcbuf, " %d", get_build_number());
@@ -1213,7 +1420,7 @@ void send_gmcp_prompt(DescriptorData *d) {
     effect *eff;
 
     if (!d->gmcp_enabled) {
-        write_to_descriptor(d->descriptor, ga_string);
+        write_to_descriptor(d, ga_string);
         return;
     }
 
@@ -1263,7 +1470,7 @@ void send_gmcp_prompt(DescriptorData *d) {
         {"SpellSlots", get_spell_slots_available(ch)}};
 
     send_gmcp(d, "Char", gmcp_data);
-    write_to_descriptor(d->descriptor, ga_string);
+    write_to_descriptor(d, ga_string);
     std::string details =
         fmt::format("Character: {}  Class: {}  Level: {}", GET_NAME(ch), capitalize(CLASS_NAME(ch)), GET_LEVEL(ch));
     auto login = std::chrono::system_clock::from_time_t(ch->player.time.logon);
@@ -1351,7 +1558,7 @@ void send_mssp(DescriptorData *d) {
     mssp_data += fmt::format("{:c}{}{:c}{}", MSSP_VAR, "GENRE", MSSP_VAL, "Fantasy");
 
     mssp_data += fmt::format("{:c}{:c}", IAC, SE);
-    write_to_descriptor(d->descriptor, mssp_data.c_str());
+    write_to_descriptor(d, mssp_data.c_str());
 }
 
 /*
@@ -1766,13 +1973,13 @@ void make_prompt(DescriptorData *d) {
 
         sprintf(prompt, "\r[ Return to continue, (q)uit, (r)efresh,%s or page number (%d/%d) ]\n",
                 PAGING_PAGE(d) == 0 ? "" : " (b)ack,", PAGING_PAGE(d) + 1, PAGING_NUMPAGES(d));
-        write_to_descriptor(d->descriptor, prompt);
+        write_to_descriptor(d, prompt);
     } else if (EDITING(d) || d->str)
-        write_to_descriptor(d->descriptor, "] ");
+        write_to_descriptor(d, "] ");
     else if (!d->connected) {
         char *prompt = prompt_str(d->character);
 
-        write_to_descriptor(d->descriptor,
+        write_to_descriptor(d,
                             process_colors(prompt, COLOR_LEV(d->character) >= C_NRM ? CLR_PARSE : CLR_STRIP));
         send_gmcp_prompt(d);
     }
@@ -1833,49 +2040,12 @@ bool casting_command(DescriptorData *d, char *txt) {
     return true;
 }
 
-void write_to_q(char *txt, txt_q *queue, int aliased, DescriptorData *d) {
-    txt_block *new_msg;
-
-    CREATE(new_msg, txt_block, 1);
-    CREATE(new_msg->text, char, strlen(txt) + 1);
-    strcpy(new_msg->text, txt);
-    new_msg->aliased = aliased;
-
-    /* queue empty? */
-    if (!queue->head) {
-        new_msg->next = nullptr;
-        queue->head = queue->tail = new_msg;
-    } else {
-        queue->tail->next = new_msg;
-        queue->tail = new_msg;
-        new_msg->next = nullptr;
-    }
-}
-
-int get_from_q(txt_q *queue, char *dest, int *aliased) {
-    txt_block *tmp;
-
-    /* queue empty? */
-    if (!queue->head)
-        return 0;
-
-    tmp = queue->head;
-    strcpy(dest, queue->head->text);
-    *aliased = queue->head->aliased;
-    queue->head = queue->head->next;
-
-    free(tmp->text);
-    free(tmp);
-
-    return 1;
-}
-
 /* Empty the queues before closing connection */
-void flush_queues(DescriptorData *d) {
-    int dummy;
+void flush_queues(DescriptorData *d) { d->input->clear(); }
 
-    while (get_from_q(&d->input, buf2, &dummy))
-        ;
+/* How color codes in text bound for this descriptor should be handled */
+static int output_color_mode(const DescriptorData *t) {
+    return t->character && COLOR_LEV(t->character) >= C_NRM ? CLR_PARSE : CLR_STRIP;
 }
 
 /* Add a new string to a player's output queue */
@@ -1883,9 +2053,36 @@ void string_to_output(DescriptorData *t, std::string_view txt) {
     if (!t || txt.empty())
         return;
 
-    t->output += process_colors(txt, t->character && COLOR_LEV(t->character) >= C_NRM ? CLR_PARSE : CLR_STRIP);
+    t->output->append(process_colors(txt, output_color_mode(t)));
 }
 
+/*
+ * A message going to many descriptors at once.  It is color-processed at
+ * most once per color mode, and everyone with the same mode queues the
+ * same buffer.
+ */
+class Broadcast {
+  public:
+    explicit Broadcast(std::string_view text) : text_(text) {}
+
+    void send(DescriptorData *t) {
+        int mode;
+
+        if (!t || text_.empty())
+            return;
+
+        mode = output_color_mode(t);
+        auto &rendered = rendered_[mode == CLR_PARSE];
+        if (!rendered)
+            rendered = std::make_shared<const std::string>(process_colors(text_, mode));
+        t->output->append(rendered);
+    }
+
+  private:
+    std::string_view text_;
+    SharedText rendered_[2];
+};
+
 void free_bufpools(void) {
     extern struct txt_block *bufpool;
     txt_block *tmp;
@@ -1903,15 +2100,24 @@ void free_bufpools(void) {
  *  socket handling                                                  *
  ****************************************************************** */
 
-void init_descriptor(DescriptorData *newd, int desc) {
+static int next_desc_num(void) {
     static int last_desc = 0;
 
+    if (++last_desc == 1000)
+        last_desc = 1;
+    return last_desc;
+}
+
+void init_descriptor(DescriptorData *newd, int desc) {
     newd->descriptor = desc;
     newd->idle_tics = 0;
     newd->login_time = time(0);
     newd->wait = 1;
     newd->gmcp_enabled = false;
     newd->page_outbuf = new std::list<std::string>();
+    newd->input = new CommandQueue;
+    newd->output = new OutputQueue;
+    newd->outring = new RingBuffer(output_buffer_size);
 
     if (newd->character == nullptr) {
         CREATE(newd->character, CharData, 1);
@@ -1921,72 +2127,89 @@ void init_descriptor(DescriptorData *newd, int desc) {
     }
 
     STATE(newd) = CON_GET_NAME;
+    newd->zone = NOWHERE;
 
-    if (++last_desc == 1000)
-        last_desc = 1;
-    newd->desc_num = last_desc;
+    /* An I/O thread may already have numbered it */
+    if (!newd->desc_num)
+        newd->desc_num = next_desc_num();
 }
 
-int new_descriptor(int s) {
-    socket_t desc;
+/* Turn away a connection that never became a descriptor. */
+static void refuse_connection(socket_t desc, NetworkThread *network, int desc_num, std::string_view why) {
+    if (network) {
+        network->send_output(desc_num, why);
+        network->disconnect(desc_num);
+    } else {
+        write_to_descriptor(desc, why);
+        CLOSE_SOCKET(desc);
+    }
+}
+
+/*
+ * Make a descriptor for a newly accepted socket, unless the game is full
+ * or the site is banned.  network is the I/O thread that owns the socket
+ * (which knows it as desc_num), or null if the game thread does its own
+ * socket I/O.
+ */
+static void open_descriptor(socket_t desc, in_addr peer_addr, NetworkThread *network, int desc_num) {
+    static unsigned long last_resolve_id = 0;
     int sockets_connected = 0;
     unsigned long addr;
-    unsigned int i;
     DescriptorData *newd;
-    sockaddr_in peer;
-    hostent *from;
-
-    /* accept the new connection */
-    i = sizeof(peer);
-    if ((desc = accept(s, (sockaddr *)&peer, &i)) == INVALID_SOCKET) {
-        perror("accept");
-        return -1;
-    }
-    /* keep it from blocking */
-    nonblock(desc);
+    std::optional<std::string> hostname;
 
     /* make sure we have room for it */
     for (newd = descriptor_list; newd; newd = newd->next)
         sockets_connected++;
 
     if (sockets_connected >= max_players) {
-        write_to_descriptor(desc, "Sorry, FieryMUD is full right now... please try again later!\n");
-        CLOSE_SOCKET(desc);
-        return 0;
+        refuse_connection(desc, network, desc_num, "Sorry, FieryMUD is full right now... please try again later!\n");
+        return;
     }
     /* create a new descriptor */
     CREATE(newd, DescriptorData, 1);
     memset((char *)newd, 0, sizeof(DescriptorData));
+    newd->network = network;
+    newd->desc_num = desc_num;
 
-    /* find the sitename */
-    if (nameserver_is_slow || !(from = gethostbyaddr((char *)&peer.sin_addr, sizeof(peer.sin_addr), AF_INET))) {
+    /* find the numeric site address */
+    addr = ntohl(peer_addr.s_addr);
+    sprintf(newd->host, "%03u.%03u.%03u.%03u", (int)((addr & 0xFF000000) >> 24), (int)((addr & 0x00FF0000) >> 16),
+            (int)((addr & 0x0000FF00) >> 8), (int)((addr & 0x000000FF)));
 
-        /* resolution failed */
-        if (!nameserver_is_slow)
-            perror("gethostbyaddr");
-
-        /* find the numeric site address */
-        addr = ntohl(peer.sin_addr.s_addr);
-        sprintf(newd->host, "%03u.%03u.%03u.%03u", (int)((addr & 0xFF000000) >> 24), (int)((addr & 0x00FF0000) >> 16),
-                (int)((addr & 0x0000FF00) >> 8), (int)((addr & 0x000000FF)));
-    } else {
-        strncpy(newd->host, from->h_name, HOST_LENGTH);
-        *(newd->host + HOST_LENGTH) = '\0';
+    /*
+     * Find the sitename.  The lookup is done by the resolver thread; unless
+     * the name is already cached, the numeric address stands in until
+     * process_resolved_hosts() fills it in.
+     */
+    if (!nameserver_is_slow) {
+        /* Unlike desc_num, this never comes round again for a later connection. */
+        newd->resolve_id = ++last_resolve_id;
+        if ((hostname = resolver->request(newd->resolve_id, peer_addr)) && !hostname->empty()) {
+            strncpy(newd->host, hostname->c_str(), HOST_LENGTH);
+            *(newd->host + HOST_LENGTH) = '\0';
+        }
     }
 
     /* determine if the site is banned */
     if (isbanned(newd->host) == BAN_ALL) {
-        write_to_descriptor(desc, BANNEDINTHEUSA);
-        write_to_descriptor(desc, BANNEDINTHEUSA2);
-        write_to_descriptor(desc, BANNEDINTHEUSA3);
-        write_to_descriptor(desc, "\n Connection logged from: {}\n\n", newd->host);
-        CLOSE_SOCKET(desc);
+        refuse_connection(desc, network, desc_num,
+                          fmt::format("{}{}{}\n Connection logged from: {}\n\n", BANNEDINTHEUSA, BANNEDINTHEUSA2,
+                                      BANNEDINTHEUSA3, newd->host));
         log(LogSeverity::Stat, LVL_GOD, "BANNED: Connection attempt denied from [{}]", newd->host);
         free(newd);
-        return 0;
+        return;
+    }
+
+    if (!network && !poller->add(desc, newd)) {
+        refuse_connection(desc, network, desc_num, "Sorry, FieryMUD is full right now... please try again later!\n");
+        free(newd);
+        return;
     }
 
     init_descriptor(newd, desc);
+    if (network)
+        network_descriptors[newd->desc_num] = newd;
 
     /* prepend to list */
     newd->next = descriptor_list;
@@ -1995,33 +2218,259 @@ int new_descriptor(int s) {
     request_ttype(newd);
     offer_mssp(newd);
     offer_gmcp(newd);
+    offer_mccp(newd);
+}
+
+int new_descriptor(int s) {
+    socket_t desc;
+    unsigned int i;
+    sockaddr_in peer;
+
+    /* accept the new connection */
+    i = sizeof(peer);
+    if ((desc = accept(s, (sockaddr *)&peer, &i)) == INVALID_SOCKET) {
+#ifdef EWOULDBLOCK
+        if (errno == EWOULDBLOCK)
+            errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+        /* Nobody left waiting is the normal way out of the accept loop. */
+        if (errno != EAGAIN && errno != EINTR)
+            perror("accept");
+        return -1;
+    }
+    /* keep it from blocking */
+    nonblock(desc);
+
+    open_descriptor(desc, peer.sin_addr, nullptr, 0);
+    return 0;
+}
+
+/* Put text in the output ring, compressing it first if MCCP2 is on. */
+static void store_output(DescriptorData *t, std::string_view txt) {
+    if (t->mccp)
+        txt = t->mccp->compress(txt);
+    t->outring->write(txt);
+}
+
+/*
+ * Append already-processed text to a descriptor's output ring.  If the
+ * ring can't hold all of it, as much as fits is kept and the rest is
+ * replaced by an overflow marker.  A compressed stream can't be cut
+ * short, so for MCCP2 the plain text is trimmed instead, leaving room
+ * for whatever the compressor may still emit.
+ */
+static std::size_t output_room(const DescriptorData *t) {
+    return t->mccp ? t->mccp->room(t->outring->space()) : t->outring->space();
+}
+
+static void queue_output(DescriptorData *t, std::string_view txt) {
+    static const std::string_view overflow = "**OVERFLOW**\r\n";
+    std::size_t room = output_room(t);
+
+    if (txt.size() <= room) {
+        store_output(t, txt);
+        return;
+    }
+
+    ++buf_overflows;
+    if (room > overflow.size())
+        store_output(t, txt.substr(0, room - overflow.size()));
+    store_output(t, overflow.substr(0, std::min(room, overflow.size())));
+}
+
+/*
+ * writev() to a descriptor's socket.  Returns the number of bytes the
+ * socket took, clearing POLL_WRITE if it didn't take them all, or -1 if
+ * the connection is broken.
+ */
+static ssize_t write_to_socket(DescriptorData *t, const iovec *iov, int count) {
+    ssize_t bytes_written;
+    std::size_t total = 0;
+    int i;
+
+    for (i = 0; i < count; ++i)
+        total += iov[i].iov_len;
+
+    while ((bytes_written = writev(t->descriptor, iov, count)) < 0) {
+#ifdef EWOULDBLOCK
+        if (errno == EWOULDBLOCK)
+            errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+        if (errno == EAGAIN) {
+            REMOVE_BIT(t->poll_events, POLL_WRITE);
+            poller->want_write(t->descriptor);
+            return 0;
+        }
+        if (errno != EINTR) {
+            perror("Write to socket");
+            return -1;
+        }
+    }
+
+    /* A short write means the socket buffer is full. */
+    if ((std::size_t)bytes_written < total) {
+        REMOVE_BIT(t->poll_events, POLL_WRITE);
+        poller->want_write(t->descriptor);
+    }
+    return bytes_written;
+}
+
+/*
+ * With I/O threads, sending output means handing the ring's contents to
+ * the thread that owns the socket.  The thread holds no more than
+ * output_buffer_size bytes of it at a time; the rest waits in the ring,
+ * so a slow client still backs up where the game can see it.
+ */
+static void hand_off_output(DescriptorData *t) {
+    iovec iov[2];
+    std::size_t held = NetworkThread::unsent(t->desc_num), room;
+    std::string bytes;
+    int i, count;
+
+    if (held >= (std::size_t)output_buffer_size || !(count = t->outring->peek(iov)))
+        return;
+
+    room = output_buffer_size - held;
+    for (i = 0; i < count && bytes.size() < room; ++i)
+        bytes.append((const char *)iov[i].iov_base, std::min(iov[i].iov_len, room - bytes.size()));
+    if (t->network->send_output(t->desc_num, bytes))
+        t->outring->consume(bytes.size());
+}
+
+/*
+ * Send as much of the output ring as the socket will take.  Whatever is
+ * left stays queued and POLL_WRITE is cleared until the poller reports
+ * the socket writable again.  Returns -1 if the connection is broken.
+ *
+ * With MCCP2 the client can't decode the last of what this sends until
+ * the compressor is flushed, which send_pulse_output() does once a pulse.
+ */
+int flush_output(DescriptorData *t) {
+    iovec iov[2];
+    ssize_t bytes_written;
+    int count;
+
+    if (t->network) {
+        hand_off_output(t);
+        return 0;
+    }
+
+    while (IS_SET(t->poll_events, POLL_WRITE) && (count = t->outring->peek(iov))) {
+        if ((bytes_written = write_to_socket(t, iov, count)) < 0)
+            return -1;
+        t->outring->consume(bytes_written);
+    }
 
     return 0;
 }
 
 int process_output(DescriptorData *t) {
-    static int result;
+    iovec iov[2 + MAX_OUTPUT_IOVECS];
+    ssize_t bytes_written;
+    std::size_t from_ring;
+    int count;
 
     /* add the extra CRLF if the person isn't in compact mode */
     if (!t->connected && t->character && !PRF_FLAGGED(t->character, PRF_COMPACT))
-        t->output += "\n";
+        t->output->append("\n");
 
     /*
-     * now, send the output.  If this is an 'interruption', use the prepended
+     * now, queue the output.  If this is an 'interruption', use the prepended
      * CRLF, otherwise send the straight output sans CRLF.
      */
     if (!t->prompt_mode) /* && !t->connected) */
-        result = write_to_descriptor(t->descriptor, "\r\n" + t->output);
-    else
-        result = write_to_descriptor(t->descriptor, t->output);
+        queue_output(t, "\r\n");
 
     /* handle snooping: prepend "% " and send to snooper */
     if (t->snoop_by)
-        desc_printf(t->snoop_by, "&2((&0 {} &2))&0", trim(t->output));
+        desc_printf(t->snoop_by, "&2((&0 {} &2))&0", trim(t->output->str()));
 
-    t->output.clear();
+    /*
+     * Hand the ring and the queued output to the socket together, so
+     * broadcasts are written straight out of their shared buffers.  With
+     * MCCP2 everything has to pass through the compressor instead.
+     */
+    while (!t->mccp && IS_SET(t->poll_events, POLL_WRITE) && !t->output->empty()) {
+        count = t->outring->peek(iov);
+        count += t->output->peek(iov + count, MAX_OUTPUT_IOVECS);
+        if ((bytes_written = write_to_socket(t, iov, count)) < 0)
+            return -1;
+        from_ring = std::min((std::size_t)bytes_written, t->outring->size());
+        t->outring->consume(from_ring);
+        t->output->consume(bytes_written - from_ring);
+    }
+
+    /* Only what the socket wouldn't take gets copied into the ring. */
+    while (!t->output->empty()) {
+        t->output->peek(iov, 1);
+        if (iov[0].iov_len > output_room(t)) {
+            queue_output(t, t->output->str());
+            t->output->clear();
+            break;
+        }
+        queue_output(t, std::string_view((const char *)iov[0].iov_base, iov[0].iov_len));
+        t->output->consume(iov[0].iov_len);
+    }
+
+    return send_pulse_output(t);
+}
+
+/*
+ * Make everything compressed this pulse decodable by the client, and send
+ * the ring.  A sync flush costs a few bytes and a deflate call, so it is
+ * done once a pulse rather than for every write.
+ */
+static int send_pulse_output(DescriptorData *t) {
+    if (t->mccp && t->mccp->unflushed())
+        t->outring->write(t->mccp->flush());
+    return t->outring->empty() ? 0 : flush_output(t);
+}
 
-    return result;
+/*
+ * Send everything waiting for a descriptor the game thread does the I/O
+ * for, waiting until give_up for the socket to take it.  For when the
+ * ring is about to be lost, as at a hotboot.  Returns false if some of
+ * it is still waiting.
+ */
+bool drain_output(DescriptorData *d, std::chrono::steady_clock::time_point give_up) {
+    pollfd pfd;
+    long left;
+
+    if (d->network)
+        return false;
+    if (d->mccp && d->mccp->unflushed())
+        d->outring->write(d->mccp->flush());
+
+    while (!d->outring->empty()) {
+        SET_BIT(d->poll_events, POLL_WRITE);
+        if (flush_output(d) < 0)
+            return false;
+        if (d->outring->empty())
+            break;
+        left = std::chrono::duration_cast<std::chrono::milliseconds>(give_up - std::chrono::steady_clock::now())
+                   .count();
+        if (left <= 0)
+            return false;
+        pfd.fd = d->descriptor;
+        pfd.events = POLLOUT;
+        if (poll(&pfd, 1, left) < 0 && errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+/* Whether a descriptor has so much unsent output that it should be spared more. */
+bool output_backlogged(const DescriptorData *d) {
+    return d && d->outring && d->outring->size() + d->output->size() > (std::size_t)output_high_water;
+}
+
+/*
+ * Send raw bytes (telnet negotiation, prompts) to a player.  They go
+ * behind anything already waiting in the output ring so ordering is kept.
+ */
+int write_to_descriptor(DescriptorData *d, std::string_view txt) {
+    queue_output(d, txt);
+    return flush_output(d);
 }
 
 int write_to_descriptor(socket_t desc, std::string_view txt) {
@@ -2031,185 +2480,263 @@ int write_to_descriptor(socket_t desc, std::string_view txt) {
     bytes_written = write(desc, txt.data(), total);
 
     if (bytes_written < 0) {
+#ifdef EWOULDBLOCK
+        if (errno == EWOULDBLOCK)
+            errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+        if (errno == EAGAIN)
+            return 0; /* the socket would block; nothing was written */
         perror("Write to socket");
         return -1;
     } else
         return bytes_written;
 }
 
+/* The client answered one of our telnet option offers, or made its own. */
+static void handle_telnet_negotiation(DescriptorData *t, unsigned char command, unsigned char option) {
+    switch (option) {
+    case GMCP:
+        if (command == DO) {
+            t->gmcp_enabled = true;
+            offer_gmcp_services(t);
+        } else if (command == DONT)
+            t->gmcp_enabled = false;
+        else
+            log("Invalid GMCP code {}", command);
+        break;
+    case TELOPT_TTYPE:
+        if (command == WILL)
+            send_opt(t, (char)TELOPT_TTYPE);
+        break;
+    case MSSP:
+        if (command == DO)
+            send_mssp(t);
+        break;
+    case MCCP2:
+        if (command == DO)
+            start_mccp(t);
+        else if (command == DONT)
+            stop_mccp(t);
+        break;
+    }
+}
+
+/* A complete IAC SB ... IAC SE arrived. */
+static void handle_telnet_subnegotiation(DescriptorData *t, unsigned char option, std::string_view data) {
+    if (option == GMCP)
+        handle_gmcp_request(t, data);
+    else if (option == TELOPT_TTYPE && !data.empty() && data[0] == TELQUAL_IS) {
+        std::string client(data.substr(1));
+
+        handle_telopt_request(t, client.data());
+    }
+}
+
 /*
- * ASSUMPTION: There will be no newlines in the raw input buffer when this
- * function is called.  We must maintain that before returning.
+ * A complete line of input.  It is expanded ('$' doubled, '!' and '^'
+ * history) straight into the free slot of the command queue and then
+ * committed, unless casting_command() consumed it.
+ */
+static void queue_command(DescriptorData *t, std::string_view line) {
+    char *cmd = t->input->back_buffer(), *write_point = cmd;
+    int failed_subst = 0;
+
+    for (auto c : line)
+        if ((*(write_point++) = c) == '$') /* if it's a $, double it */
+            *(write_point++) = '$';
+    *write_point = '\0';
+
+    if (t->snoop_by)
+        desc_printf(t->snoop_by, "&6>>&b {} &0\n", cmd);
+
+    if (*cmd == '!')
+        strcpy(cmd, t->last_input);
+    else if (*cmd == '^') {
+        if (!(failed_subst = perform_subst(t, t->last_input, cmd)))
+            strcpy(t->last_input, cmd);
+    } else
+        strcpy(t->last_input, cmd);
+
+    /*
+     * If the user is casting, and the command is ok
+     * when casting, then it gets processed immediately
+     * by the command interpreter within casting_command().
+     * Otherwise, the command is queued up and handled by
+     * the game loop normally.  Oh, and this is a hack.
+     */
+    if (failed_subst || casting_command(t, cmd))
+        return;
+
+    if (!t->input->commit_back(false))
+        desc_printf(t, "You have typed too far ahead; '{}' was ignored.\n", cmd);
+}
+
+/* The line was cut short; what was kept is queued all the same. */
+static int queue_long_line(DescriptorData *t, std::string_view line) {
+    queue_command(t, line);
+    return write_to_descriptor(t, fmt::format("Line too long.  Truncated to:\n{}\n", line));
+}
+
+/* Hands what the telnet parser finds in a descriptor's input straight to the game. */
+class DescriptorInput : public TelnetHandler {
+  public:
+    explicit DescriptorInput(DescriptorData *t) : t_(t) {}
+
+    void line(std::string_view text) override { queue_command(t_, text); }
+    bool long_line(std::string_view text) override { return queue_long_line(t_, text) >= 0; }
+    void negotiation(unsigned char command, unsigned char option) override {
+        handle_telnet_negotiation(t_, command, option);
+    }
+    void subnegotiation(unsigned char option, std::string_view data) override {
+        handle_telnet_subnegotiation(t_, option, data);
+    }
+    void protocol_error(std::string_view what) override { log(what); }
+
+  private:
+    DescriptorData *t_;
+};
+
+/*
+ * Read whatever the socket has and run it through the telnet parser.
+ * The parser's state (t->telnet) survives between calls, so nothing is
+ * lost when a line or negotiation is split across reads.
  */
 int process_input(DescriptorData *t) {
-    int buf_length, bytes_read, space_left, command_space_left, failed_subst, telopt = 0;
-    char *ptr, *read_point, *write_point = nullptr, *write_cmd_point = nullptr;
-    char tmp[MAX_INPUT_LENGTH + 8], telnet_opts[MAX_INPUT_LENGTH + 8], telcmd = 0;
-    int data_mode = 0;
-
-    buf_length = strlen(t->inbuf);
-    read_point = t->inbuf + buf_length;
-    space_left = MAX_RAW_INPUT_LENGTH - buf_length - 1;
-    command_space_left = MAX_INPUT_LENGTH - 1;
-
-    do {
-        if (space_left <= 0) {
-            log("process_input: about to close connection: input overflow [{}]", t->host);
-            return -1;
-        }
-        if ((bytes_read = read(t->descriptor, read_point, space_left)) < 0) {
+    DescriptorInput handler(t);
+    TelnetInput *tn = &t->telnet;
+    int bytes_read;
+
+    while (true) {
+        if ((bytes_read = read(t->descriptor, t->inbuf + tn->line_len, MAX_RAW_INPUT_LENGTH - tn->line_len)) < 0) {
 #ifdef EWOULDBLOCK
             if (errno == EWOULDBLOCK)
                 errno = EAGAIN;
 #endif /* EWOULDBLOCK */
+            if (errno == EINTR)
+                continue;
             if (errno != EAGAIN) {
                 log("process_input: about to lose connection [{}]", t->host);
                 return -1; /* some error condition was encountered on read */
-            } else {
-                break; /* the read would have blocked: just means no data there but everything's okay */
             }
+            return 0; /* the read would have blocked: just means no data there but everything's okay */
         } else if (bytes_read == 0) {
             log("EOF on socket read (connection broken by peer) [{}]", t->host);
             return -1;
         }
 
-        *(read_point + bytes_read) = '\0'; /* terminate the string */
-        read_point += bytes_read;
-        space_left -= bytes_read;
-    } while (true);
+        if (!parse_telnet(tn, t->inbuf, bytes_read, handler))
+            return -1;
+    }
+}
 
-    /* All data read, lets process it. */
-    write_point = tmp;
-    *write_point = '\0';
-    space_left = MAX_INPUT_LENGTH - 1;
-    /* search for a newline or control codes in the data we just read */
-    for (ptr = t->inbuf; *ptr; ++ptr) {
-        if (*ptr == (char)IAC) { /* Telnet Control Option Starting */
-            telopt = 1;
-        } else if (telopt == 1 && *ptr == (char)SE) {
-            /* End of negotiations */
-            if (data_mode == 0) {
-                log("Error, attempting to end a telnet negotiation we never started!");
-            } else {
-                telopt = 0;
-                *write_cmd_point = '\0';
-                if (data_mode == 1)
-                    handle_gmcp_request(t, telnet_opts);
-                else if (data_mode == 2)
-                    handle_telopt_request(t, telnet_opts);
-                data_mode = 0;
-            }
-        } else if (telopt == 1) {
-            telopt = 2;
-            telcmd = *ptr;
-        } else if (telopt == 2) {
-            if (*ptr == (char)GMCP) { /* Ready to handle GMCP data */
-                if (telcmd == (char)DO) {
-                    telopt = 0;
-                    t->gmcp_enabled = true;
-                    offer_gmcp_services(t);
-                } else if (telcmd == (char)DONT) {
-                    telopt = 0;
-                    t->gmcp_enabled = false;
-                } else if (telcmd == (char)SB) {
-                    /* Start listening to new GMCP command. */
-                    write_cmd_point = telnet_opts;
-                    *write_cmd_point = '\0';
-                    command_space_left = MAX_INPUT_LENGTH - 1;
-                    telopt = 0;
-                    data_mode = 1;
-                } else {
-                    telopt = 0;
-                    /* ERROR */
-                    log("Invalid GMCP code {}", (unsigned char)telcmd);
-                }
-                /* Responding to terminal type. */
-            } else if (*ptr == TELOPT_TTYPE) {
-                if (telcmd == (char)WILL)
-                    send_opt(t, (char)TELOPT_TTYPE);
-                else if (telcmd == (char)SB) {
-                    (void)*ptr++; // Step past the null IS
-                    /* Start listening for the terminal type. */
-                    write_cmd_point = telnet_opts;
-                    *write_cmd_point = '\0';
-                    command_space_left = MAX_INPUT_LENGTH - 1;
-                    telopt = 0;
-                    data_mode = 2;
-                }
-            } else if (*ptr == (char)MSSP) {
-                if (telcmd == (char)DO)
-                    send_mssp(t);
-            } else if (*ptr != (char)TELOPT_ECHO) {
-                /* Ignore echo requests for new. */
+/*
+ * Act on everything the I/O threads have to say.  What they parsed from
+ * the sockets gets the same treatment here that process_input() gives it
+ * when the game thread reads the sockets itself.
+ */
+void process_network_events(void) {
+    NetMessage msg;
+    DescriptorData *d;
+
+    for (auto &network : network_threads) {
+        network->clear_notify();
+        while (network->receive(msg)) {
+            if (msg.type == NET_CONNECTED) {
+                open_descriptor(msg.fd, msg.addr, network.get(), msg.desc_num);
+                continue;
             }
 
-        } else if (telopt > 0) { /* If we are here, there is an error */
-            log("Invalid telnet IAC code {:d}", (int)*ptr);
-        } else if (data_mode) {
-            /* In telnet data negotiation mode.  Log data to the command buffer. */
-            *(write_cmd_point++) = *ptr;
-            command_space_left--;
-        } else {
-            /* If we are here, it's normal text input. */
-            if (IS_NEWLINE(*ptr) || space_left <= 0) { /* End of command, process it */
-                *write_point = '\0';
-                if (t->snoop_by)
-                    desc_printf(t->snoop_by, "&6>>&b {} &0\n", tmp);
-
-                failed_subst = 0;
-
-                if (*tmp == '!')
-                    strcpy(tmp, t->last_input);
-                else if (*tmp == '^') {
-                    if (!(failed_subst = perform_subst(t, t->last_input, tmp)))
-                        strcpy(t->last_input, tmp);
-                } else
-                    strcpy(t->last_input, tmp);
-                /*
-                 * If the user is casting, and the command is ok
-                 * when casting, then it gets processed immediately
-                 * by the command interpreter within casting_command().
-                 * Otherwise, the command is queued up and handled by
-                 * the game loop normally.  Oh, and this is a hack.
-                 */
-                if (!failed_subst && !casting_command(t, tmp)) {
-                    write_to_q(tmp, &t->input, 0, t);
-                }
+            /* Skip what was on its way when the descriptor was closed. */
+            auto found = network_descriptors.find(msg.desc_num);
+            if (found == network_descriptors.end() || found->second->network != network.get())
+                continue;
+            d = found->second;
 
-                if (space_left <= 0) {
-                    char buffer[MAX_INPUT_LENGTH + 64];
-                    if (write_to_descriptor(t->descriptor, "Line too long.  Truncated to:\n{}\n", tmp) < 0)
-                        return -1;
-                    while (*ptr && !IS_NEWLINE(*ptr)) /* Find next newline */
-                        ++ptr;
-                }
-                while (*(ptr + 1) && IS_NEWLINE(*(ptr + 1))) /* Find start of next command. */
-                    ++ptr;
-
-                write_point = tmp;
-                *write_point = '\0';
-                space_left = MAX_INPUT_LENGTH - 1;
-            } else if (*ptr == '\b') { /* handle backspacing */
-                if (write_point > tmp) {
-                    if (*(--write_point) == '$') {
-                        write_point--;
-                        space_left += 2;
-                    } else
-                        space_left++;
-                }
-            } else if (isascii(*ptr) && isprint(*ptr)) {
-                if ((*(write_point++) = *ptr) == '$') { /* copy one character */
-                    *(write_point++) = '$';             /* if it's a $, double it */
-                    space_left -= 2;
-                } else
-                    space_left--;
-
-                *write_point = '\0';
+            switch (msg.type) {
+            case NET_LINE:
+                queue_command(d, msg.text);
+                break;
+            case NET_LONG_LINE:
+                queue_long_line(d, msg.text);
+                break;
+            case NET_NEGOTIATE:
+                handle_telnet_negotiation(d, msg.command, msg.option);
+                break;
+            case NET_SUBNEGOTIATE:
+                handle_telnet_subnegotiation(d, msg.option, msg.text);
+                break;
+            case NET_ERROR:
+                log(msg.text);
+                break;
+            case NET_LOST:
+                log("{} [{}]", msg.text, d->host);
+                close_socket(d);
+                break;
             }
         }
+        network->wake();
     }
-    strcpy(t->inbuf, tmp);
-    return 0;
+}
+
+/*
+ * With -t, hand the sockets over to network_thread_count I/O threads.  At
+ * boot there are none yet; after a failed hotboot, everyone still
+ * connected is shared out among the new threads.
+ */
+void start_network_threads(void) {
+    DescriptorData *d;
+    std::size_t count = 0;
+
+    if (network_thread_count <= 0)
+        return;
+
+    log("Starting {:d} network I/O thread{}.", network_thread_count, network_thread_count == 1 ? "" : "s");
+    while (network_threads.size() < (std::size_t)network_thread_count) {
+        network_threads.push_back(std::make_unique<NetworkThread>(mother_desc));
+        if (!poller->add(network_threads.back()->notify_fd(), network_threads.back().get())) {
+            log("SYSERR: Unable to watch a network I/O thread.");
+            exit(1);
+        }
+    }
+
+    for (d = descriptor_list; d; d = d->next) {
+        if (!(d->desc_num = NetworkThread::claim_desc_num())) {
+            STATE(d) = CON_CLOSE; /* no thread can know it by number */
+            update_zone_occupancy(d);
+            continue;
+        }
+        d->network = network_threads[count++ % network_threads.size()].get();
+        d->network->adopt(d->desc_num, d->descriptor);
+        network_descriptors[d->desc_num] = d;
+    }
+}
+
+/*
+ * Take the sockets back from the I/O threads once they have written what
+ * they were given, so the game thread can write to them directly again.
+ * A hotboot does this before handing the sockets to the new process.
+ */
+void stop_network_threads(void) {
+    DescriptorData *d;
+
+    for (auto &network : network_threads) {
+        network->stop();
+        poller->remove(network->notify_fd());
+    }
+
+    for (d = descriptor_list; d; d = d->next) {
+        if (!d->network)
+            continue;
+        d->network = nullptr;
+        /* Only if the thread got it all out; otherwise the stream would have a hole. */
+        if (NetworkThread::unsent(d->desc_num) == 0) {
+            SET_BIT(d->poll_events, POLL_WRITE);
+            flush_output(d);
+        }
+    }
+
+    network_threads.clear();
+    network_descriptors.clear();
 }
 
 /*
@@ -2265,7 +2792,13 @@ int perform_subst(DescriptorData *t, char *orig, char *subst) {
 void close_socket(DescriptorData *d) {
     DescriptorData *temp;
 
-    CLOSE_SOCKET(d->descriptor);
+    if (d->network) {
+        d->network->disconnect(d->desc_num);
+        network_descriptors.erase(d->desc_num);
+    } else {
+        poller->remove(d->descriptor);
+        CLOSE_SOCKET(d->descriptor);
+    }
     flush_queues(d);
 
     /* Forget snooping */
@@ -2305,6 +2838,7 @@ void close_socket(DescriptorData *d) {
         if (d->character)
             REMOVE_FLAG(PLR_FLAGS(d->character), PLR_WRITING);
         d->connected = CON_PLAYING;
+        update_zone_occupancy(d);
         break;
     default:
         break;
@@ -2345,6 +2879,8 @@ void close_socket(DescriptorData *d) {
     if (d->original && d->original->desc)
         d->original->desc = nullptr;
 
+    /* Not before here: shapechanging back above moves the character. */
+    remove_zone_occupancy(d);
     REMOVE_FROM_LIST(d, descriptor_list, next);
 
     if (d->storage)
@@ -2353,6 +2889,11 @@ void close_socket(DescriptorData *d) {
     if (d->page_outbuf)
         free(d->page_outbuf);
 
+    delete d->input;
+    delete d->output;
+    delete d->outring;
+    delete d->mccp;
+
     free(d);
 }
 
@@ -2414,8 +2955,9 @@ RETSIGTYPE checkpointing(int signo) {
 }
 
 RETSIGTYPE dump_core(int signo) {
-    log(LogSeverity::Info, LVL_IMMORT, "Received SIGUSR1 - dumping core.");
+    log(LogSeverity::Info, LVL_IMMORT, "Received SIGUSR1 - dumping core and pulse timings.");
     drop_core(nullptr, "usrsig");
+    lag_dump_requested = 1; /* logged by the game loop, not in the handler */
 }
 
 RETSIGTYPE unrestrict_game(int signo) {
@@ -2473,19 +3015,21 @@ void signal_setup(void) {
 // Updated variadic functions
 void all_printf(std::string_view str) {
     DescriptorData *i;
+    Broadcast message(str);
 
     for (i = descriptor_list; i; i = i->next)
         if (!i->connected)
-            string_to_output(i, str);
+            message.send(i);
 }
 
 void all_except_printf(CharData *ch, std::string_view str) {
     DescriptorData *i;
     CharData *avoid = REAL_CHAR(ch);
+    Broadcast message(str);
 
     for (i = descriptor_list; i; i = i->next)
         if (!i->connected && i->character != avoid)
-            string_to_output(i, str);
+            message.send(i);
 }
 
 void char_printf(const CharData *ch, std::string_view str) {
@@ -2498,6 +3042,7 @@ void room_printf(int rvnum, std::string_view str) {
     RoomData *room;
     Exit *exit;
     int dir;
+    Broadcast message(str);
 
     if (rvnum >= 0 && rvnum <= top_of_world)
         room = &world[rvnum];
@@ -2511,7 +3056,7 @@ void room_printf(int rvnum, std::string_view str) {
 
     for (i = room->people; i; i = i->next_in_room)
         if (i->desc)
-            string_to_output(i->desc, str);
+            message.send(i->desc);
 
     /* Reflect to OBSERVATORY rooms if this room is an ARENA. */
     if (ROOM_FLAGGED(rvnum, ROOM_ARENA)) {
@@ -2520,7 +3065,7 @@ void room_printf(int rvnum, std::string_view str) {
                 ROOM_FLAGGED(EXIT_NDEST(exit), ROOM_OBSERVATORY)) {
                 for (i = EXIT_DEST(exit)->people; i; i = i->next_in_room)
                     if (i->desc) {
-                        string_to_output(i->desc, str);
+                        message.send(i->desc);
                         break;
                     }
             }
@@ -2531,33 +3076,37 @@ void room_printf(int rvnum, std::string_view str) {
 void zone_printf(int zone_vnum, int skip_room, int min_stance, std::string_view str) {
     DescriptorData *i;
     int zone_rnum = real_zone(zone_vnum);
+    Broadcast message(str);
 
     if (zone_rnum == NOWHERE) {
         log(LogSeverity::Error, LVL_GOD, "SYSERR: bad zone vnum {} passed to zone_printf", zone_vnum);
         return;
     }
 
-    for (i = descriptor_list; i; i = i->next)
+    /* The zone's list can be a moment behind a change of state, so check it all again. */
+    for (i = zone_table[zone_rnum].descriptors; i; i = i->zone_next)
         if (!i->connected && i->character && i->character->in_room != NOWHERE && i->character->in_room != skip_room &&
             i->character->char_specials.stance >= min_stance && world[i->character->in_room].zone == zone_rnum)
-            string_to_output(i, str);
+            message.send(i);
 }
 
 void callback_printf(CBP_FUNC(callback), int data, std::string_view str) {
     DescriptorData *i;
+    Broadcast message(str);
 
     for (i = descriptor_list; i; i = i->next)
         if (!i->connected && i->character && i->character->desc && callback(i->character, data))
-            string_to_output(i, str);
+            message.send(i);
 }
 
 void outdoor_printf(int zone_num, std::string_view str) {
     DescriptorData *i;
+    Broadcast message(str);
 
-    for (i = descriptor_list; i; i = i->next)
+    for (i = zone_table[zone_num].descriptors; i; i = i->zone_next)
         if (!i->connected && i->character && AWAKE(i->character) && CH_OUTSIDE(i->character) &&
             IN_ZONE_RNUM(i->character) == zone_num && STATE(i) == CON_PLAYING)
-            string_to_output(i, str);
+            message.send(i);
 }
 
 /* SPEECH_OK
@@ -2863,6 +3412,89 @@ std::string format_act(std::string_view format, const CharData *ch, ActArg obj,
     return capitalize_first(rtn);
 }
 
+/*
+ * An act() message going to a roomful of people.  What a viewer reads
+ * depends only on which of the participants named in the message they
+ * can see and on whether they get color, so viewers who agree on those
+ * share one rendering instead of each having the message formatted and
+ * color-processed for them.
+ */
+class ActBroadcast {
+  public:
+    ActBroadcast(std::string_view format, const CharData *ch, ActArg obj, ActArg vict_obj)
+        : format_(format), ch_(ch), obj_(obj), vict_obj_(vict_obj) {
+        bool code = false;
+
+        for (auto c : format) {
+            if (!std::exchange(code, false)) {
+                code = (c == '$');
+                continue;
+            }
+            switch (c) {
+            case 'n':
+                names_ch_ = true;
+                break;
+            case 'N':
+                names_victim_ = true;
+                break;
+            case 'o':
+            case 'p':
+                names_obj_ = true;
+                break;
+            case 'O':
+            case 'P':
+                names_vict_obj_ = true;
+                break;
+            }
+        }
+    }
+
+    void send(const CharData *to) {
+        int mode, key;
+
+        if (!to->desc)
+            return;
+
+        mode = output_color_mode(to->desc);
+        key = (visibility(to) << 1) | (mode == CLR_PARSE);
+        if (!rendered_[key])
+            rendered_[key] =
+                std::make_shared<const std::string>(process_colors(format_act(format_, ch_, obj_, vict_obj_, to), mode));
+        to->desc->output->append(rendered_[key]);
+    }
+
+  private:
+    /* One bit for each participant named in the message that to can see */
+    int visibility(const CharData *to) const {
+        const CharData *victim = nullptr;
+        const ObjData *object = nullptr, *vict_object = nullptr;
+        int seen = 0;
+
+        if (auto arg = std::get_if<CharData *>(&vict_obj_))
+            victim = *arg;
+        if (auto arg = std::get_if<ObjData *>(&obj_))
+            object = *arg;
+        if (auto arg = std::get_if<ObjData *>(&vict_obj_))
+            vict_object = *arg;
+
+        if (names_ch_ && CAN_SEE(to, ch_))
+            seen |= 1 << 0;
+        if (names_victim_ && victim && CAN_SEE(to, victim))
+            seen |= 1 << 1;
+        if (names_obj_ && object && CAN_SEE_OBJ(to, object))
+            seen |= 1 << 2;
+        if (names_vict_obj_ && vict_object && CAN_SEE_OBJ(to, vict_object))
+            seen |= 1 << 3;
+        return seen;
+    }
+
+    std::string_view format_;
+    const CharData *ch_;
+    ActArg obj_, vict_obj_;
+    bool names_ch_ = false, names_victim_ = false, names_obj_ = false, names_vict_obj_ = false;
+    SharedText rendered_[1 << 5]; /* by visibility, then color mode */
+};
+
 /* The "act" action interpreter */
 void act(std::string_view str, int hide_invisible, const CharData *ch, ActArg obj, ActArg vict_obj, int type) {
     char lbuf[MAX_STRING_LENGTH];
@@ -2964,18 +3596,22 @@ void act(std::string_view str, int hide_invisible, const CharData *ch, ActArg ob
             return;
         }
     }
+
+    ActBroadcast message(str, ch, obj, vict_obj);
+
     for (to = world[in_room].people; to; to = to->next_in_room)
         if (((MOB_PERFORMS_SCRIPTS(to) && SCRIPT_CHECK(to, MTRIG_ACT)) || SENDOK(to)) &&
-            !(hide_invisible && ch && !CAN_SEE(to, ch)) && (to != ch) && (type == TO_ROOM || (to != victim))) {
-            auto formatted = format_act(str, ch, obj, vict_obj, to);
-            char_printf(to, formatted);
-        }
+            !(hide_invisible && ch && !CAN_SEE(to, ch)) && (to != ch) && (type == TO_ROOM || (to != victim)))
+            message.send(to);
     /*
      * Reflect TO_ROOM and TO_NOTVICT calls that occur in ARENA rooms
      * into OBSERVATORY rooms, allowing players standing in observatories
      * to watch arena battles safely.
      */
-    if (ROOM_FLAGGED(in_room, ROOM_ARENA))
+    if (ROOM_FLAGGED(in_room, ROOM_ARENA)) {
+        auto arena_tag = fmt::format("&4<&0{}&0&4>&0 ", world[in_room].name);
+        Broadcast tag(arena_tag);
+
         for (i = 0; i < NUM_OF_DIRS; ++i)
             if (world[in_room].exits[i] && world[in_room].exits[i]->to_room != NOWHERE &&
                 world[in_room].exits[i]->to_room != in_room &&
@@ -2983,8 +3619,8 @@ void act(std::string_view str, int hide_invisible, const CharData *ch, ActArg ob
                 for (to = world[world[in_room].exits[i]->to_room].people; to; to = to->next_in_room)
                     if (SENDOK(to) && !(hide_invisible && ch && !CAN_SEE(to, ch)) && (to != ch) &&
                         (type == TO_ROOM || (to != victim))) {
-                        char_printf(to, "&4<&0{}&0&4>&0 ", world[in_room].name);
-                        auto formatted = format_act(str, ch, obj, vict_obj, to);
-                        char_printf(to, formatted);
+                        tag.send(to->desc);
+                        message.send(to);
                     }
+    }
 }
@@ -15,6 +15,7 @@
 #include "structs.hpp"
 #include "sysdep.hpp"
 
+#include <chrono>
 #include <fmt/format.h>
 #include <functional>
 #include <nlohmann/json.hpp>
@@ -26,6 +27,7 @@ using json = nlohmann::json;
 #define NUM_RESERVED_DESCS 8
 
 #define HOTBOOT_FILE "hotboot.dat"
+#define HOTBOOT_DRAIN_SECS 3 /* how long a hotboot waits for sockets to take their output */
 
 // #define CBP_FUNC(name) int(name)(CharData *, int)
 using CBP_FUNC = std::function<int(CharData *, int)>;
@@ -86,6 +88,13 @@ template <typename... Args> void string_to_output(DescriptorData *t, std::string
     string_to_output(t, fmt::vformat(str, fmt::make_format_args(args...)));
 }
 int write_to_descriptor(socket_t desc, std::string_view txt);
+int write_to_descriptor(DescriptorData *d, std::string_view txt);
+bool output_backlogged(const DescriptorData *d);
+void stop_mccp(DescriptorData *d);
+bool drain_output(DescriptorData *d, std::chrono::steady_clock::time_point give_up);
+void start_network_threads(void);
+void stop_network_threads(void);
+void nonblock(socket_t s);
 template <typename... Args> int write_to_descriptor(socket_t desc, std::string_view str, Args &&...args) {
     return write_to_descriptor(desc, fmt::vformat(str, fmt::make_format_args(args...)));
 }
@@ -93,7 +102,6 @@ inline void desc_printf(DescriptorData *t, std::string_view txt) { string_to_out
 template <typename... Args> void desc_printf(DescriptorData *t, std::string_view txt, Args &&...args) {
     desc_printf(t, fmt::vformat(txt, fmt::make_format_args(args...)));
 }
-void write_to_q(char *txt, txt_q *queue, int aliased, DescriptorData *d);
 
 typedef RETSIGTYPE sigfunc(int);
 
@@ -106,6 +114,7 @@ extern char comm_buf[MAX_STRING_LENGTH];
 extern txt_block *bufpool;
 extern int buf_largecount;
 extern int buf_overflows;
+extern int output_chatter_dropped;
 extern int buf_switches;
 extern int circle_shutdown;
 extern int circle_reboot;
@@ -115,3 +124,4 @@ extern int tics;
 extern int scheck;
 extern int dg_act_check;
 extern int gossip_channel_active;
+extern int network_thread_count;
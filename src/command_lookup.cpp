@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   File: command_lookup.c                               Part of FieryMUD *
+ *  Usage: finding commands by abbreviation or by typo                     *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "command_lookup.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+CommandTrie::CommandTrie() { nodes_.emplace_back(); }
+
+void CommandTrie::clear() {
+    nodes_.clear();
+    nodes_.emplace_back();
+}
+
+int CommandTrie::child(int node, char c) const {
+    for (const auto &[letter, next] : nodes_[node].children)
+        if (letter == c)
+            return next;
+    return -1;
+}
+
+void CommandTrie::insert(int command, const char *name) {
+    int node = 0, next;
+    char c;
+
+    nodes_[node].commands.push_back(command);
+    for (; *name; ++name) {
+        c = std::tolower((unsigned char)*name);
+        if ((next = child(node, c)) < 0) {
+            next = nodes_.size();
+            nodes_[node].children.emplace_back(c, next);
+            nodes_.emplace_back();
+        }
+        node = next;
+        nodes_[node].commands.push_back(command);
+    }
+    if (nodes_[node].exact < 0)
+        nodes_[node].exact = command;
+}
+
+int CommandTrie::walk(const char *prefix) const {
+    int node = 0;
+
+    for (; *prefix && node >= 0; ++prefix)
+        node = child(node, std::tolower((unsigned char)*prefix));
+    return node;
+}
+
+const std::vector<int> *CommandTrie::matches(const char *prefix) const {
+    int node = walk(prefix);
+
+    return node < 0 || nodes_[node].commands.empty() ? nullptr : &nodes_[node].commands;
+}
+
+int CommandTrie::find(const char *name) const {
+    int node = walk(name);
+
+    return node < 0 ? -1 : nodes_[node].exact;
+}
+
+void CommandBKTree::insert(int command, const char *name) {
+    int node = 0, d;
+
+    if (nodes_.empty()) {
+        nodes_.push_back({command, name, {}});
+        return;
+    }
+
+    for (;;) {
+        d = distance_(name, nodes_[node].name);
+        auto it = std::find_if(nodes_[node].children.begin(), nodes_[node].children.end(),
+                               [d](const auto &edge) { return edge.first == d; });
+        if (it == nodes_[node].children.end()) {
+            nodes_[node].children.emplace_back(d, nodes_.size());
+            nodes_.push_back({command, name, {}});
+            return;
+        }
+        node = it->second;
+    }
+}
+
+std::vector<int> CommandBKTree::within(const char *word, int max_distance) const {
+    std::vector<int> found, pending;
+    int node, d;
+
+    if (!nodes_.empty())
+        pending.push_back(0);
+
+    while (!pending.empty()) {
+        node = pending.back();
+        pending.pop_back();
+
+        d = distance_(word, nodes_[node].name);
+        if (d <= max_distance)
+            found.push_back(nodes_[node].command);
+        for (const auto &[edge, next] : nodes_[node].children)
+            if (edge >= d - max_distance && edge <= d + max_distance)
+                pending.push_back(next);
+    }
+
+    std::sort(found.begin(), found.end());
+    return found;
+}
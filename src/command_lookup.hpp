@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   File: command_lookup.h                               Part of FieryMUD *
+ *  Usage: header file: finding commands by abbreviation or by typo        *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+/*
+ * A trie of command names, ignoring case.  Each node keeps every command
+ * whose name starts with the letters on the path to it, in the order
+ * they were inserted, so finding what an abbreviation could mean is one
+ * step per letter typed, and the first command in the list is the one a
+ * scan of the command table would have found first.
+ */
+class CommandTrie {
+  public:
+    CommandTrie();
+
+    /* Commands must be inserted in the order they should be matched. */
+    void insert(int command, const char *name);
+    void clear();
+
+    /* The commands whose names start with prefix, or nullptr if none do. */
+    const std::vector<int> *matches(const char *prefix) const;
+    /* The first command named exactly name, or -1. */
+    int find(const char *name) const;
+
+  private:
+    struct Node {
+        std::vector<std::pair<char, int>> children; /* letter, node */
+        std::vector<int> commands;
+        int exact = -1;
+    };
+
+    int child(int node, char c) const;
+    int walk(const char *prefix) const;
+
+    std::vector<Node> nodes_;
+};
+
+/*
+ * A BK-tree of command names, for finding the ones within a few edits of
+ * something that isn't a command.  Each child is filed under its distance
+ * from its parent, so by the triangle inequality a search only has to go
+ * down the children whose distance is within range of its own.
+ */
+class CommandBKTree {
+  public:
+    using Distance = int (*)(const char *, const char *);
+
+    explicit CommandBKTree(Distance distance) : distance_(distance) {}
+
+    void insert(int command, const char *name);
+    void clear() { nodes_.clear(); }
+
+    /* The commands within max_distance of word, in increasing order. */
+    std::vector<int> within(const char *word, int max_distance) const;
+
+  private:
+    struct Node {
+        int command;
+        const char *name;
+        std::vector<std::pair<int, int>> children; /* distance, node */
+    };
+
+    Distance distance_;
+    std::vector<Node> nodes_;
+};
@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   File: command_queue.c                                Part of FieryMUD *
+ *  Usage: fixed-capacity queue of typed-ahead commands                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "command_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+void CommandQueue::copy_text(Slot &slot, std::string_view text) {
+    std::size_t len = std::min(text.size(), sizeof(slot.text) - 1);
+
+    memcpy(slot.text, text.data(), len);
+    slot.text[len] = '\0';
+}
+
+bool CommandQueue::commit_back(bool aliased) {
+    if (full())
+        return false;
+
+    slots_[(head_ + count_) % NUM_SLOTS].aliased = aliased;
+    ++count_;
+    return true;
+}
+
+bool CommandQueue::push_back(std::string_view text, bool aliased) {
+    if (full())
+        return false;
+
+    copy_text(slots_[(head_ + count_) % NUM_SLOTS], text);
+    return commit_back(aliased);
+}
+
+bool CommandQueue::push_front(std::string_view text, bool aliased) {
+    if (full())
+        return false;
+
+    head_ = (head_ + NUM_SLOTS - 1) % NUM_SLOTS;
+    copy_text(slots_[head_], text);
+    slots_[head_].aliased = aliased;
+    ++count_;
+    return true;
+}
+
+bool CommandQueue::pop(char *dest, int *aliased) {
+    if (empty())
+        return false;
+
+    strcpy(dest, slots_[head_].text);
+    *aliased = slots_[head_].aliased;
+    head_ = (head_ + 1) % NUM_SLOTS;
+    --count_;
+    return true;
+}
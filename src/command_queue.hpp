@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   File: command_queue.h                                Part of FieryMUD *
+ *  Usage: header file: fixed-capacity queue of typed-ahead commands       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include "defines.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+#define MAX_QUEUED_COMMANDS 64 /* commands a player may type ahead */
+
+/*
+ * A descriptor's typed-ahead commands, oldest first.  Commands live in
+ * fixed slots, so queueing one never allocates.  There is always one
+ * spare slot past the end (back_buffer()) where the next command can be
+ * assembled in place before it is committed.
+ */
+class CommandQueue {
+  public:
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == MAX_QUEUED_COMMANDS; }
+    std::size_t size() const { return count_; }
+    std::size_t space() const { return MAX_QUEUED_COMMANDS - count_; }
+
+    /* MAX_INPUT_LENGTH bytes in which to build the next command. */
+    char *back_buffer() { return slots_[(head_ + count_) % NUM_SLOTS].text; }
+    /* Queue the command built in back_buffer().  Returns false if full. */
+    bool commit_back(bool aliased);
+    /* Queue a command after (or ahead of) all the others.  Returns false if full. */
+    bool push_back(std::string_view text, bool aliased);
+    bool push_front(std::string_view text, bool aliased);
+    /* Copy the oldest command into dest and remove it.  Returns false if empty. */
+    bool pop(char *dest, int *aliased);
+    void clear() { head_ = count_ = 0; }
+
+  private:
+    static constexpr std::size_t NUM_SLOTS = MAX_QUEUED_COMMANDS + 1;
+
+    struct Slot {
+        char text[MAX_INPUT_LENGTH];
+        bool aliased;
+    };
+
+    static void copy_text(Slot &slot, std::string_view text);
+
+    Slot slots_[NUM_SLOTS];
+    std::size_t head_ = 0;  /* slot of the oldest command */
+    std::size_t count_ = 0; /* commands queued */
+};
@@ -146,6 +146,7 @@ ACMD(do_gedit) {
     else
         gedit_setup_new(d);
     STATE(d) = CON_GEDIT;
+    update_zone_occupancy(d);
 
     act("$n starts using OLC.", true, d->character, 0, 0, TO_ROOM);
     SET_FLAG(PLR_FLAGS(ch), PLR_WRITING);
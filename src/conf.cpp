@@ -154,16 +154,10 @@ int max_filesize = 50000;
 int max_bad_pws = 3;
 
 /*
- * Some nameservers are very slow and cause the game to lag terribly every
- * time someone logs in.  The lag is caused by the gethostbyaddr() function
- * which is responsible for resolving numeric IP addresses to alphabetic names.
- * Sometimes, nameservers can be so slow that the incredible lag caused by
- * gethostbyaddr() isn't worth the luxury of having names instead of numbers
- * for players' sitenames.
- *
- * If your nameserver is fast, set the variable below to false.  If your
- * nameserver is slow, of it you would simply prefer to have numbers
- * instead of names for some other reason, set the variable to true.
+ * Sitenames are looked up by a resolver thread, so a slow nameserver no
+ * longer lags the game: players show up under their numeric address until
+ * the name arrives.  If you would simply prefer to have numbers instead of
+ * names for players' sitenames, set the variable below to true.
  *
  * You can experiment with the setting of nameserver_is_slow on-line using
  * the SLOWNS command from within the MUD.
@@ -171,6 +165,27 @@ int max_bad_pws = 3;
 
 int nameserver_is_slow = true;
 
+/* How many resolved sitenames to remember, and for how many seconds. */
+int resolver_cache_size = 4096;
+int resolver_cache_ttl = 6 * 60 * 60;
+
+/*
+ * Output that a player's socket won't accept right away is held in a ring
+ * buffer of output_buffer_size bytes until the socket drains; anything past
+ * that is discarded.  Once more than output_high_water bytes are waiting,
+ * the player is considered backlogged: channel chatter to them is dropped
+ * and long unpaged text is sent through the pager instead.
+ */
+int output_buffer_size = 64 * 1024;
+int output_high_water = 16 * 1024;
+
+/*
+ * Clients that ask for MCCP2 get compressed output, as long as all the
+ * compressors together stay under this many bytes (each takes roughly a
+ * quarter megabyte).  Set it to 0 to turn compression off.
+ */
+int mccp_memory_limit = 32 * 1024 * 1024;
+
 const char *MENU =
     "\n"
     "   ~~~ Welcome to &1&bFieryMUD&0 ~~~\n"
@@ -68,6 +68,9 @@
 /* Define if you have the <string.h> header file.  */
 #define HAVE_STRING_H 1
 
+/* Define if you have the <sys/epoll.h> header file.  */
+#define HAVE_SYS_EPOLL_H 1
+
 /* Define if you have the <sys/fcntl.h> header file.  */
 #define HAVE_SYS_FCNTL_H 1
 
@@ -77,6 +80,9 @@
 /* Define if you have the <sys/time.h> header file.  */
 #define HAVE_SYS_TIME_H 1
 
+/* Define if you have the <sys/timerfd.h> header file.  */
+#define HAVE_SYS_TIMERFD_H 1
+
 /* Define if you have the <sys/types.h> header file.  */
 #define HAVE_SYS_TYPES_H 1
 
@@ -145,6 +151,11 @@ extern int MAX_PLAYERS;
 extern int max_filesize;
 extern int max_bad_pws;
 extern int nameserver_is_slow;
+extern int resolver_cache_size;
+extern int resolver_cache_ttl;
+extern int output_buffer_size;
+extern int output_high_water;
+extern int mccp_memory_limit;
 extern const char *MENU;
 extern const char *GREETINGS;
 extern const char *GREETINGS2;
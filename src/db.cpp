@@ -47,12 +47,16 @@
 #include "sysdep.hpp"
 #include "textfiles.hpp"
 #include "trophy.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
+#include "vnum_index.hpp"
 #include "weather.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <math.h>
 #include <sys/stat.h>
+#include <vector>
 
 void init_clans(void);
 char err_buf[MAX_STRING_LENGTH];
@@ -487,6 +491,8 @@ void free_spell_dams(void) {
 }
 
 void boot_world(void) {
+    int i;
+
     log("Loading attribute bonus tables.");
     load_stat_bonus();
 
@@ -519,6 +525,10 @@ void boot_world(void) {
     log("Renumbering zone table.");
     renum_zone_table();
 
+    log("Compiling zone reset programs.");
+    for (i = 0; i <= top_of_zone_table; i++)
+        compile_zone_program(i);
+
     log("Booting spell_dam's.");
     boot_spell_dams();
 
@@ -668,6 +678,7 @@ void destroy_db(void) {
             ungroup(chtmp, false, false);
         free_char(chtmp);
     }
+    char_uids.clear();
 
     /* Active Objects */
     while (object_list) {
@@ -675,6 +686,7 @@ void destroy_db(void) {
         object_list = object_list->next;
         free_obj(objtmp);
     }
+    obj_uids.clear();
 
     /* Rooms */
     for (cnt = 0; cnt <= top_of_world; cnt++) {
@@ -691,6 +703,7 @@ void destroy_db(void) {
         }
         /* free script proto list */
         free_proto_script(&world[cnt].proto_script);
+        free(world[cnt].triggers);
 
         for (itr = 0; itr < NUM_OF_DIRS; itr++) {
             if (!world[cnt].exits[itr])
@@ -759,6 +772,7 @@ void destroy_db(void) {
             /* then free the command list */
             free(zone_table[cnt].cmd);
         }
+        free(zone_table[cnt].program);
     }
     free(zone_table);
 
@@ -781,6 +795,7 @@ void destroy_db(void) {
             /* free_trigger() doesn't free the command list */
             if (trig_index[cnt]->proto->cmdlist) {
                 CmdlistElement *i, *j;
+                free_compiled_script(trig_index[cnt]->proto->cmdlist);
                 i = trig_index[cnt]->proto->cmdlist;
                 while (i) {
                     j = i->next;
@@ -1010,10 +1025,27 @@ void index_boot(int mode) {
         fscanf(index, "%s\n", buf1);
     }
 
-    /* sort the help index */
-    if (mode == DB_BOOT_HLP) {
+    switch (mode) {
+    case DB_BOOT_TRG:
+        build_trigger_index();
+        break;
+    case DB_BOOT_WLD:
+        build_room_index();
+        break;
+    case DB_BOOT_MOB:
+        build_mobile_index();
+        break;
+    case DB_BOOT_OBJ:
+        build_object_index();
+        break;
+    case DB_BOOT_ZON:
+        build_zone_index();
+        break;
+    case DB_BOOT_HLP:
+        /* sort the help index */
         qsort(help_table, top_of_helpt, sizeof(HelpIndexElement), hsort);
         top_of_helpt--;
+        break;
     }
 }
 
@@ -2079,6 +2111,7 @@ CharData *create_char(void) {
     ch->next = character_list;
     character_list = ch;
     GET_ID(ch) = max_id++;
+    char_uids.add(GET_ID(ch), ch);
     return ch;
 }
 
@@ -2138,6 +2171,7 @@ CharData *read_mobile(int nr, int type) {
 
     mob->next = character_list;
     character_list = mob;
+    char_uids.add(GET_ID(mob), mob);
 
     return mob;
 }
@@ -2151,6 +2185,7 @@ ObjData *create_obj(void) {
     obj->next = object_list;
     object_list = obj;
     GET_ID(obj) = max_id++;
+    obj_uids.add(GET_ID(obj), obj);
     assign_triggers(obj, OBJ_TRIGGER);
 
     return obj;
@@ -2181,6 +2216,7 @@ ObjData *read_object(int nr, int type) {
 
     obj_index[i].number++;
     GET_ID(obj) = max_id++;
+    obj_uids.add(GET_ID(obj), obj);
     assign_triggers(obj, OBJ_TRIGGER);
 
     if (GET_OBJ_TYPE(obj) == ITEM_DRINKCON)
@@ -2190,11 +2226,33 @@ ObjData *read_object(int nr, int type) {
 }
 
 #define ZO_DEAD 999
+#define ZONE_RESET_BUDGET 2000 /* microseconds of zone resetting per pulse */
 
-/* update zone ages, queue for reset if necessary, and dequeue when possible */
+/*
+ * A zone reset that's under way.  run_zone_resets() picks zones off
+ * reset_q and works through their commands, stopping whenever a pulse's
+ * ZONE_RESET_BUDGET is spent and carrying on where it left off the next
+ * pulse.  This keeps what reset_zone()'s loop used to keep in local
+ * variables, except that the last mob loaded is remembered by id, since
+ * it may be gone by the next pulse.
+ */
+struct ZoneReset {
+    int zone;                                  /* rnum, or NOWHERE if nothing is being reset */
+    int zone_vnum;                             /* to find it again if zone_table changes */
+    int cmd_no;                                /* the next command to run */
+    int last_cmd;                              /* whether the last command ran, for if-flags */
+    long mob_id;                               /* GET_ID() of the last mob loaded, or 0 */
+    int pulses;                                /* pulses it's been spread over so far */
+    std::chrono::steady_clock::duration spent; /* time spent on it so far */
+};
+
+static ZoneReset zone_reset = {NOWHERE};
+static int zone_minutes = 0; /* minutes since boot, for ordering reset_q */
+
+/* update zone ages, and queue them for reset if necessary */
 void zone_update(void) {
     int i;
-    ResetQElement *update_u, *temp;
+    ResetQElement *update_u;
     static int timer = 0;
     char buf[128];
 
@@ -2207,6 +2265,9 @@ void zone_update(void) {
          */
 
         timer = 0;
+        ++zone_minutes;
+
+        verify_zone_occupancy();
 
         /* since one minute has passed, increment zone ages */
         for (i = 0; i <= top_of_zone_table; i++) {
@@ -2220,6 +2281,7 @@ void zone_update(void) {
                 CREATE(update_u, ResetQElement, 1);
 
                 update_u->zone_to_reset = i;
+                update_u->queued = zone_minutes;
                 update_u->next = 0;
 
                 if (!reset_q.head)
@@ -2233,27 +2295,42 @@ void zone_update(void) {
             }
         }
     } /* end - one minute has passed */
+}
 
-    /* dequeue zones (if possible) and reset */
-    /* this code is executed every 10 seconds (i.e. PULSE_ZONE) */
-    for (update_u = reset_q.head; update_u; update_u = update_u->next)
-        if (zone_table[update_u->zone_to_reset].reset_mode == 2 || is_empty(update_u->zone_to_reset)) {
-            reset_zone(update_u->zone_to_reset, false);
-            if (update_u == reset_q.head)
-                reset_q.head = reset_q.head->next;
-            else {
-                for (temp = reset_q.head; temp->next != update_u; temp = temp->next)
-                    ;
+/*
+ * Take the zone that most deserves resetting off reset_q and start
+ * resetting it.  Zones that can't be reset now (reset mode 1 with
+ * players in them) wait; of the rest, the ones with the fewest players
+ * go first, and then the ones that have waited longest.
+ */
+static bool start_next_zone_reset(void) {
+    ResetQElement *update_u, *prev, *best = nullptr, *best_prev = nullptr;
+    int zone;
 
-                if (!update_u->next)
-                    reset_q.tail = temp;
+    for (prev = nullptr, update_u = reset_q.head; update_u; prev = update_u, update_u = update_u->next) {
+        zone = update_u->zone_to_reset;
+        if (zone_table[zone].reset_mode != 2 && !is_empty(zone))
+            continue;
+        if (!best || zone_table[zone].players < zone_table[best->zone_to_reset].players ||
+            (zone_table[zone].players == zone_table[best->zone_to_reset].players && update_u->queued < best->queued)) {
+            best = update_u;
+            best_prev = prev;
+        }
+    }
 
-                temp->next = update_u->next;
-            }
+    if (!best)
+        return false;
 
-            free(update_u);
-            break;
-        }
+    if (best_prev)
+        best_prev->next = best->next;
+    else
+        reset_q.head = best->next;
+    if (reset_q.tail == best)
+        reset_q.tail = best_prev;
+
+    zone_reset = {best->zone_to_reset, zone_table[best->zone_to_reset].number};
+    free(best);
+    return true;
 }
 
 void log_zone_error(int zone, int cmd_no, const char *message) {
@@ -2311,189 +2388,622 @@ int reset_door(room_num roomnum, int dir, int resetcmd) {
     return 0;
 }
 
-/* execute the reset command table of a given zone */
-void reset_zone(int zone, byte pop) {
-    int cmd_no, cmd_other, last_cmd = 0;
+/* The last op before op in program that loads rnum as an object, or -1. */
+static int find_obj_loader(ResetOp *program, int op, int rnum) {
+    while (--op >= 0)
+        switch (program[op].type) {
+        case ResetOpType::LoadObj:
+        case ResetOpType::PutObj:
+        case ResetOpType::GiveObj:
+        case ResetOpType::EquipObj:
+            if (program[op].rnum == rnum)
+                return op;
+            break;
+        default:
+            break;
+        }
+    return -1;
+}
+
+/*
+ * Compile a zone's reset commands into its program.  Each command is
+ * checked here, once, rather than at every reset: one that can never
+ * work is logged and compiled to a skip.  Whether a door exists, or a
+ * mob was loaded to give things to, can still change and is checked
+ * when the program runs.
+ */
+void compile_zone_program(int zone) {
+    int cmd_no, count;
+    bool have_mob = false;
+    ResetOp *op;
+
+    for (count = 0; zone_table[zone].cmd[count].command != 'S'; count++)
+        ;
+    free(zone_table[zone].program);
+    CREATE(zone_table[zone].program, ResetOp, count + 1);
+
+    for (cmd_no = 0; cmd_no < count; cmd_no++) {
+        op = &zone_table[zone].program[cmd_no];
+        op->type = ResetOpType::Skip;
+        op->if_flag = ZCMD.if_flag;
+        op->room = NOWHERE;
+        op->loader = -1;
+
+        switch (ZCMD.command) {
+        case '*':
+            break;
+
+        case 'M':
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_mobt || ZCMD.arg3 < 0 || ZCMD.arg3 > top_of_world) {
+                log_zone_error(zone, cmd_no, "invalid mob or room");
+                break;
+            }
+            op->type = ResetOpType::LoadMob;
+            op->rnum = ZCMD.arg1;
+            op->max = ZCMD.arg2;
+            op->room = ZCMD.arg3;
+            have_mob = true;
+            break;
+
+        case 'O':
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_objt || ZCMD.arg3 > top_of_world) {
+                log_zone_error(zone, cmd_no, "invalid obj or room");
+                break;
+            }
+            op->type = ResetOpType::LoadObj;
+            op->rnum = ZCMD.arg1;
+            op->max = ZCMD.arg2;
+            op->room = ZCMD.arg3 >= 0 ? ZCMD.arg3 : NOWHERE;
+            break;
+
+        case 'P':
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_objt || ZCMD.arg3 < 0 || ZCMD.arg3 > top_of_objt) {
+                log_zone_error(zone, cmd_no, "invalid obj or container");
+                break;
+            }
+            op->type = ResetOpType::PutObj;
+            op->rnum = ZCMD.arg1;
+            op->max = ZCMD.arg2;
+            op->container = ZCMD.arg3;
+            op->loader = find_obj_loader(zone_table[zone].program, cmd_no, ZCMD.arg3);
+            break;
+
+        case 'G':
+            if (!have_mob) {
+                log_zone_error(zone, cmd_no, "attempt to give obj to non-existent mob");
+                break;
+            }
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_objt) {
+                log_zone_error(zone, cmd_no, "invalid obj");
+                break;
+            }
+            op->type = ResetOpType::GiveObj;
+            op->rnum = ZCMD.arg1;
+            op->max = ZCMD.arg2;
+            break;
+
+        case 'E':
+            if (!have_mob) {
+                log_zone_error(zone, cmd_no, "trying to equip non-existent mob");
+                break;
+            }
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_objt) {
+                log_zone_error(zone, cmd_no, "invalid obj");
+                break;
+            }
+            if (ZCMD.arg3 < 0 || ZCMD.arg3 >= NUM_WEARS) {
+                log_zone_error(zone, cmd_no, "invalid equipment pos number");
+                break;
+            }
+            op->type = ResetOpType::EquipObj;
+            op->rnum = ZCMD.arg1;
+            op->max = ZCMD.arg2;
+            op->position = ZCMD.arg3;
+            break;
+
+        case 'R':
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_world || ZCMD.arg2 < 0 || ZCMD.arg2 > top_of_objt) {
+                log_zone_error(zone, cmd_no, "invalid room or obj");
+                break;
+            }
+            op->type = ResetOpType::RemoveObj;
+            op->room = ZCMD.arg1;
+            op->rnum = ZCMD.arg2;
+            break;
+
+        case 'D':
+            if (ZCMD.arg1 < 0 || ZCMD.arg1 > top_of_world || ZCMD.arg2 < 0 || ZCMD.arg2 >= NUM_OF_DIRS) {
+                log_zone_error(zone, cmd_no, "door does not exist");
+                break;
+            }
+            if (ZCMD.arg3 < 0 || ZCMD.arg3 > 5) { /* see reset_door() */
+                log_zone_error(zone, cmd_no, "unknown cmd in reset table; cmd disabled");
+                break;
+            }
+            op->type = ResetOpType::SetDoor;
+            op->room = ZCMD.arg1;
+            op->direction = ZCMD.arg2;
+            op->state = ZCMD.arg3;
+            break;
+
+        case 'F':
+            if (!have_mob) {
+                log_zone_error(zone, cmd_no, "attempt to force-command a non-existent mob");
+                break;
+            }
+            if (!ZCMD.sarg) {
+                log_zone_error(zone, cmd_no, "no command to force");
+                break;
+            }
+            op->type = ResetOpType::ForceMob;
+            op->command = ZCMD.sarg;
+            break;
+
+        default:
+            log_zone_error(zone, cmd_no, "unknown cmd in reset table; cmd disabled");
+            break;
+        }
+    }
+
+    zone_table[zone].program[count].type = ResetOpType::End;
+}
+
+/*
+ * Throw away a zone's program, and any reset of it under way, after its
+ * commands or the rnums in them change.  It's compiled again the next
+ * time the zone resets.
+ */
+void invalidate_zone_program(int zone) {
+    cancel_zone_reset(zone);
+    free(zone_table[zone].program);
+    zone_table[zone].program = nullptr;
+}
+
+/* The same for every zone, after OLC renumbers rooms, mobs or objects. */
+void invalidate_zone_programs(void) {
+    int zone;
+
+    for (zone = 0; zone <= top_of_zone_table; zone++)
+        invalidate_zone_program(zone);
+}
+
+/* Find the object a PutObj op should go in. */
+static ObjData *find_reset_container(ResetOp *program, ResetOp *op) {
+    ObjData *obj;
+
+    /* Usually the container was loaded earlier in the same reset. */
+    if (op->loader >= 0 && program[op->loader].loaded && (obj = find_obj(program[op->loader].loaded)) &&
+        GET_OBJ_RNUM(obj) == op->container)
+        return obj;
+
+    return find_obj_in_world(find_by_rnum(op->container));
+}
+
+/*
+ * The door on the other side of one just reset is in another zone, so
+ * set it the way that zone's program would.
+ */
+static void reset_other_side(ResetOp *op) {
+    room_num other_room;
+    ResetOp *ocmd;
+    int other_zone;
+
+    /* Make sure there is an actual destination room */
+    if ((other_room = world[op->room].exits[op->direction]->to_room) == NOWHERE)
+        return;
+
+    /* Make sure the destination room is in a different zone */
+    if ((other_zone = world[other_room].zone) == world[op->room].zone)
+        return;
+
+    /* Make sure the destination room has an exit pointing back to this room */
+    if (!world[other_room].exits[rev_dir[op->direction]] ||
+        world[other_room].exits[rev_dir[op->direction]]->to_room != op->room)
+        return;
+
+    if (!zone_table[other_zone].program)
+        compile_zone_program(other_zone);
+
+    /* Do every door command for that exit */
+    for (ocmd = zone_table[other_zone].program; ocmd->type != ResetOpType::End; ++ocmd)
+        if (ocmd->type == ResetOpType::SetDoor && ocmd->room == other_room &&
+            ocmd->direction == rev_dir[op->direction])
+            reset_door(ocmd->room, ocmd->direction, ocmd->state);
+}
+
+/*
+ * Run a zone's reset program from where the reset left off, until it's
+ * done (returning true) or the deadline passes (returning false).  At
+ * least one command runs each time, so a reset always gets somewhere.
+ */
+static bool run_zone_reset(ZoneReset &reset, std::chrono::steady_clock::time_point deadline) {
+    int zone = reset.zone, cmd_no, last_cmd = reset.last_cmd;
     CharData *mob = nullptr;
     ObjData *obj, *obj_to;
-    room_num other_room;
-    ResetCommand *ocmd;
+    ResetOp *program, *op;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    long took;
+
+    /* OLC may have added zones since the last pulse. */
+    if (zone_table[zone].number != reset.zone_vnum && (zone = real_zone(reset.zone_vnum)) == NOWHERE) {
+        reset.zone = NOWHERE;
+        return true;
+    }
+
+    if (!zone_table[zone].program)
+        compile_zone_program(zone);
+    program = zone_table[zone].program;
+
+    if (!reset.cmd_no)
+        for (op = program; op->type != ResetOpType::End; ++op)
+            op->loaded = 0;
 
-    for (cmd_no = 0; ZCMD.command != 'S'; cmd_no++) {
+    /* Without the mob, nothing that depends on it loading should happen. */
+    if (reset.mob_id && !(mob = find_char(reset.mob_id)))
+        last_cmd = 0;
 
-        if (ZCMD.if_flag && !last_cmd)
+    for (cmd_no = reset.cmd_no; (op = &program[cmd_no])->type != ResetOpType::End; cmd_no++) {
+        if (cmd_no > reset.cmd_no && std::chrono::steady_clock::now() >= deadline) {
+            reset.zone = zone;
+            reset.cmd_no = cmd_no;
+            reset.last_cmd = last_cmd;
+            reset.mob_id = mob ? GET_ID(mob) : 0;
+            reset.pulses++;
+            reset.spent += std::chrono::steady_clock::now() - start;
+            return false;
+        }
+
+        if (op->if_flag && !last_cmd)
             continue;
 
-        switch (ZCMD.command) {
-        case '*': /* ignore command */
+        switch (op->type) {
+        case ResetOpType::End:
+        case ResetOpType::Skip:
             last_cmd = 0;
             break;
 
-        case 'F': /* force mobile to do action */
+        case ResetOpType::ForceMob:
             if (!mob) {
                 ZONE_ERROR("attempt to force-command a non-existent mob");
                 break;
             }
-            command_interpreter(mob, ZCMD.sarg);
+            command_interpreter(mob, op->command);
             break;
 
-        case 'M': /* read a mobile */
-            if (mob_index[ZCMD.arg1].number < ZCMD.arg2) {
-                mob = read_mobile(ZCMD.arg1, REAL);
-                char_to_room(mob, ZCMD.arg3);
+        case ResetOpType::LoadMob:
+            if (mob_index[op->rnum].number < op->max) {
+                mob = read_mobile(op->rnum, REAL);
+                char_to_room(mob, op->room);
                 load_mtrigger(mob);
                 last_cmd = 1;
             } else
                 last_cmd = 0;
             break;
 
-        case 'O': /* read an object */
-
-            if (obj_index[ZCMD.arg1].number < ZCMD.arg2) {
-                obj = read_object(ZCMD.arg1, REAL);
-                if (ZCMD.arg3 >= 0) {
-                    obj_to_room(obj, ZCMD.arg3);
-                    last_cmd = 1;
-                } else {
+        case ResetOpType::LoadObj:
+            if (obj_index[op->rnum].number < op->max) {
+                obj = read_object(op->rnum, REAL);
+                op->loaded = GET_ID(obj);
+                if (op->room != NOWHERE)
+                    obj_to_room(obj, op->room);
+                else
                     obj->in_room = NOWHERE;
-                    last_cmd = 1;
-                }
+                last_cmd = 1;
             } else
                 last_cmd = 0;
             break;
 
-        case 'P': /* object to object */
-            if (obj_index[ZCMD.arg1].number < ZCMD.arg2) {
-                obj = read_object(ZCMD.arg1, REAL);
-                if (!(obj_to = find_obj_in_world(find_by_rnum(ZCMD.arg3)))) {
+        case ResetOpType::PutObj:
+            if (obj_index[op->rnum].number < op->max) {
+                obj = read_object(op->rnum, REAL);
+                if (!(obj_to = find_reset_container(program, op))) {
                     ZONE_ERROR("target obj not found");
                     extract_obj(obj);
                     break;
                 }
+                op->loaded = GET_ID(obj);
                 obj_to_obj(obj, obj_to);
                 last_cmd = 1;
             } else
                 last_cmd = 0;
             break;
 
-        case 'G': /* obj_to_char */
+        case ResetOpType::GiveObj:
             if (!mob) {
                 ZONE_ERROR("attempt to give obj to non-existent mob");
                 break;
             }
-
-            if (obj_index[ZCMD.arg1].number < ZCMD.arg2) {
-                obj = read_object(ZCMD.arg1, REAL);
-
-                if (GET_LEVEL(mob) < GET_OBJ_LEVEL(obj)) {
-                    char error_buf[2048];
-                    sprintf(error_buf,
-                            "Mob %s [%d] in room %d  cannot use object "
-                            "%s [%d] because its level is to low.",
-                            GET_NAME(mob), GET_MOB_VNUM(mob), mob->in_room, obj->short_description, GET_OBJ_VNUM(obj));
-                }
-
+            if (obj_index[op->rnum].number < op->max) {
+                obj = read_object(op->rnum, REAL);
+                op->loaded = GET_ID(obj);
                 obj_to_char(obj, mob);
                 last_cmd = 1;
             } else
                 last_cmd = 0;
             break;
 
-        case 'E': /* object to equipment list */
+        case ResetOpType::EquipObj:
             if (!mob) {
                 ZONE_ERROR("trying to equip non-existent mob");
                 break;
-            } /*was make sure number less then ZCMD.arg2 */
-            if (obj_index[ZCMD.arg1].number < ZCMD.arg2) {
-                if (ZCMD.arg3 < 0 || ZCMD.arg3 >= NUM_WEARS) {
-                    ZONE_ERROR("invalid equipment pos number");
-                } else {
-                    obj = read_object(ZCMD.arg1, REAL);
-                    if (equip_char(mob, obj, ZCMD.arg3) != EQUIP_RESULT_SUCCESS) {
-                        log(LogSeverity::Error, 101,
-                            "EQUIP zone command for {} [{:d}] in room {:d} to equip {} [{:d}] failed.", GET_NAME(mob),
-                            GET_MOB_VNUM(mob), ROOM_RNUM_TO_VNUM(mob->in_room), obj->short_description,
-                            GET_OBJ_VNUM(obj));
-                        extract_obj(obj);
-                    }
-                    last_cmd = 1;
+            }
+            if (obj_index[op->rnum].number < op->max) {
+                obj = read_object(op->rnum, REAL);
+                op->loaded = GET_ID(obj);
+                if (equip_char(mob, obj, op->position) != EQUIP_RESULT_SUCCESS) {
+                    log(LogSeverity::Error, 101,
+                        "EQUIP zone command for {} [{:d}] in room {:d} to equip {} [{:d}] failed.", GET_NAME(mob),
+                        GET_MOB_VNUM(mob), ROOM_RNUM_TO_VNUM(mob->in_room), obj->short_description,
+                        GET_OBJ_VNUM(obj));
+                    op->loaded = 0;
+                    extract_obj(obj);
                 }
+                last_cmd = 1;
             } else
                 last_cmd = 0;
             break;
 
-        case 'R': /* rem obj from room */
-            if ((obj = find_obj_in_list(world[ZCMD.arg1].contents, find_by_rnum(ZCMD.arg2))) != nullptr) {
+        case ResetOpType::RemoveObj:
+            if ((obj = find_obj_in_list(world[op->room].contents, find_by_rnum(op->rnum))) != nullptr) {
                 obj_from_room(obj);
                 extract_obj(obj);
             }
             last_cmd = 1;
             break;
 
-        case 'D': /* set state of door */
-            if (ZCMD.arg2 < 0 || ZCMD.arg2 >= NUM_OF_DIRS || (world[ZCMD.arg1].exits[ZCMD.arg2] == nullptr)) {
+        case ResetOpType::SetDoor:
+            if (!world[op->room].exits[op->direction]) {
                 ZONE_ERROR("door does not exist");
-            } else if (reset_door(ZCMD.arg1, ZCMD.arg2, ZCMD.arg3)) {
-                ZONE_ERROR("unknown cmd in reset table; cmd disabled");
-                ZCMD.command = '*';
-            } else {
-                /* reset_door() has returned 0, indicating success */
-
-                /* If the destination room is in another zone, we must perform
-                 * its door reset commands now, else the opposing sides of the
-                 * door will become unsynchronized. */
-
-                /* Make sure there is an actual destination room */
-                if ((other_room = world[ZCMD.arg1].exits[ZCMD.arg2]->to_room) != NOWHERE) {
-
-                    /* Make sure the destination room is in a different zone */
-                    if (world[other_room].zone != world[ZCMD.arg1].zone) {
-
-                        /* Make sure the destination room has an exit pointing back */
-                        if (world[other_room].exits[rev_dir[ZCMD.arg2]]) {
-
-                            /* Make sure that exit is pointing back to this room */
-                            if (world[other_room].exits[rev_dir[ZCMD.arg2]]->to_room == ZCMD.arg1) {
-
-                                /* Ready to perform its door zone commands */
-
-                                /* Must examine every zone command in that zone */
-                                for (cmd_other = 0;; cmd_other++) {
-                                    ocmd = &(zone_table[world[other_room].zone].cmd[cmd_other]);
-                                    if (ocmd->command == 'S')
-                                        break;
-
-                                    /* if it's a door command */
-                                    if (ocmd->command == 'D' &&
-                                        /* and it's applied to the room opposite this exit */
-                                        ocmd->arg1 == other_room &&
-                                        /* and it's going in the direction toward this room */
-                                        ocmd->arg2 == rev_dir[ZCMD.arg2]) {
-
-                                        /* do the command */
-                                        reset_door(ocmd->arg1, ocmd->arg2, ocmd->arg3);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+                break;
             }
+            reset_door(op->room, op->direction, op->state);
+            /* The other side of the door, if it's in another zone, must be
+             * reset now too, or the two sides will get out of step. */
+            reset_other_side(op);
+            break;
         }
     }
     zone_table[zone].age = 0;
+
+    reset.spent += std::chrono::steady_clock::now() - start;
+    took = std::chrono::duration_cast<std::chrono::microseconds>(reset.spent).count();
+    zone_table[zone].resets++;
+    zone_table[zone].reset_usec_last = took;
+    zone_table[zone].reset_usec_max = std::max(zone_table[zone].reset_usec_max, took);
+    zone_table[zone].reset_usec_total += took;
+    zone_table[zone].reset_pulses_last = reset.pulses + 1;
+
+    reset.zone = NOWHERE;
+    return true;
+}
+
+/* execute the reset command table of a given zone, all at once */
+void reset_zone(int zone, byte pop) {
+    ZoneReset reset = {zone, zone_table[zone].number};
+
+    cancel_zone_reset(zone);
+    run_zone_reset(reset, std::chrono::steady_clock::time_point::max());
+}
+
+/* Work through queued zone resets until this pulse's budget is spent. */
+void run_zone_resets(void) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(ZONE_RESET_BUDGET);
+
+    do {
+        if (zone_reset.zone == NOWHERE && !start_next_zone_reset())
+            return;
+    } while (run_zone_reset(zone_reset, deadline) && std::chrono::steady_clock::now() < deadline);
+}
+
+/*
+ * Drop a reset that's under way, as when OLC replaces the zone's commands.
+ * The zone ages from now as if it had finished, rather than staying off
+ * the queue for good.
+ */
+void cancel_zone_reset(int zone) {
+    if (zone_reset.zone == zone) {
+        zone_reset.zone = NOWHERE;
+        zone_table[zone].age = 0;
+    }
+}
+
+#define ZONE_REPORT_MAX 20 /* zones listed by zone_reset_report() */
+
+/* What the reset scheduler is doing, and the zones slowest to reset. */
+std::string zone_reset_report(void) {
+    std::vector<int> zones;
+    std::string report;
+    ResetQElement *update_u;
+    int i, queued = 0;
+
+    for (update_u = reset_q.head; update_u; update_u = update_u->next)
+        ++queued;
+
+    if (zone_reset.zone == NOWHERE)
+        report = "No zone is being reset.";
+    else
+        report = fmt::format("Resetting zone {:d}, at command {:d}, over {:d} pulses so far.",
+                             zone_table[zone_reset.zone].number, zone_reset.cmd_no, zone_reset.pulses + 1);
+    report += fmt::format("  {:d} zone{} queued.\n\n", queued, queued == 1 ? "" : "s");
+
+    for (i = 0; i <= top_of_zone_table; i++)
+        if (zone_table[i].resets)
+            zones.push_back(i);
+    if (zones.empty())
+        return report + "No zones have been reset since boot.\n";
+    std::sort(zones.begin(), zones.end(),
+              [](int a, int b) { return zone_table[a].reset_usec_max > zone_table[b].reset_usec_max; });
+    if (zones.size() > ZONE_REPORT_MAX)
+        zones.resize(ZONE_REPORT_MAX);
+
+    report += fmt::format("{:>5} {:<30} {:>6} {:>8} {:>8} {:>8} {:>6}\n", "Zone", "Name", "Resets", "Last ms",
+                          "Max ms", "Avg ms", "Pulses");
+    for (int zone : zones)
+        report += fmt::format("{:>5d} {:<30.30} {:>6d} {:>8.2f} {:>8.2f} {:>8.2f} {:>6d}\n", zone_table[zone].number,
+                              zone_table[zone].name, zone_table[zone].resets, zone_table[zone].reset_usec_last / 1000.0,
+                              zone_table[zone].reset_usec_max / 1000.0,
+                              zone_table[zone].reset_usec_total / 1000.0 / zone_table[zone].resets,
+                              zone_table[zone].reset_pulses_last);
+    return report;
+}
+
+/*
+ * Reset every zone rounds times, as fast as possible, and log how long it
+ * took (fierymud -b).  Before each round the world is emptied of mobs
+ * and of objects lying in rooms, as though players had cleared it out,
+ * so that each reset has everything to load again.  Emptying the world
+ * isn't timed.
+ */
+void benchmark_zone_resets(int rounds) {
+    CharData *ch, *next_ch;
+    ObjData *obj, *next_obj;
+    ResetOp *op;
+    std::chrono::steady_clock::duration total{}, fastest = std::chrono::steady_clock::duration::max();
+    long commands = 0;
+    int round, zone, room;
+    double seconds;
+
+    for (zone = 0; zone <= top_of_zone_table; zone++) {
+        if (!zone_table[zone].program)
+            compile_zone_program(zone);
+        for (op = zone_table[zone].program; op->type != ResetOpType::End; ++op)
+            commands++;
+    }
+
+    for (round = 0; round < rounds; round++) {
+        for (room = 0; room <= top_of_world; room++) {
+            for (ch = world[room].people; ch; ch = next_ch) {
+                next_ch = ch->next_in_room;
+                if (IS_NPC(ch))
+                    extract_char(ch);
+            }
+            for (obj = world[room].contents; obj; obj = next_obj) {
+                next_obj = obj->next_content;
+                extract_obj(obj);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (zone = 0; zone <= top_of_zone_table; zone++)
+            reset_zone(zone, false);
+        auto took = std::chrono::steady_clock::now() - start;
+        total += took;
+        fastest = std::min(fastest, took);
+    }
+
+    seconds = std::chrono::duration<double>(total).count();
+    log("Reset {:d} zones ({:d} commands) {:d} times in {:.3f} s: {:.3f} ms per round, {:.3f} ms at best.",
+        top_of_zone_table + 1, commands, rounds, seconds, seconds * 1000 / rounds,
+        std::chrono::duration<double, std::milli>(fastest).count());
+    log("That's {:.0f} zone resets and {:.0f} commands a second, leaving {:d} characters and {:d} objects.",
+        (top_of_zone_table + 1) * rounds / seconds, commands * rounds / seconds, char_uids.size(), obj_uids.size());
 }
 
 /* for use in reset_zone; return true if zone 'nr' is free of PC's  */
-int is_empty(int zone_nr) {
-    DescriptorData *i;
+int is_empty(int zone_nr) { return !zone_table[zone_nr].players; }
+
+/*
+ * Each zone counts the descriptors playing in it and links them through
+ * zone_next, so that is_empty() and zone-wide messages don't have to scan
+ * descriptor_list.  A descriptor counts where its character is while it
+ * is CON_PLAYING.  char_to_room() and char_from_room() keep this up to
+ * date as characters move.  Whatever changes a descriptor's state or its
+ * character (entering the game, OLC, switching, reconnecting, closing)
+ * calls update_zone_occupancy() itself, so nothing has to scan for it.
+ */
+static int occupied_zone(DescriptorData *d) {
+    if (d->connected || !d->character || d->character->in_room == NOWHERE)
+        return NOWHERE;
+    return world[d->character->in_room].zone;
+}
+
+void remove_zone_occupancy(DescriptorData *d) {
+    if (d->zone == NOWHERE)
+        return;
+
+    if (d->zone_prev)
+        d->zone_prev->zone_next = d->zone_next;
+    else
+        zone_table[d->zone].descriptors = d->zone_next;
+    if (d->zone_next)
+        d->zone_next->zone_prev = d->zone_prev;
+    --zone_table[d->zone].players;
+
+    d->zone = NOWHERE;
+    d->zone_next = d->zone_prev = nullptr;
+}
+
+void update_zone_occupancy(DescriptorData *d) {
+    int zone = occupied_zone(d);
+
+    if (zone == d->zone)
+        return;
+
+    remove_zone_occupancy(d);
+
+    if (zone != NOWHERE) {
+        d->zone = zone;
+        d->zone_prev = nullptr;
+        if ((d->zone_next = zone_table[zone].descriptors))
+            d->zone_next->zone_prev = d;
+        zone_table[zone].descriptors = d;
+        ++zone_table[zone].players;
+    }
+}
 
-    for (i = descriptor_list; i; i = i->next)
-        if (!i->connected)
-            if (world[i->character->in_room].zone == zone_nr)
-                return 0;
+/* Count everyone again from scratch, as after the zone table changes. */
+void rebuild_zone_occupancy(void) {
+    DescriptorData *d;
+    int i;
 
-    return 1;
+    for (i = 0; i <= top_of_zone_table; ++i) {
+        zone_table[i].players = 0;
+        zone_table[i].descriptors = nullptr;
+    }
+    for (d = descriptor_list; d; d = d->next) {
+        d->zone = NOWHERE;
+        d->zone_next = d->zone_prev = nullptr;
+        update_zone_occupancy(d);
+    }
+}
+
+/*
+ * Compare the counts with a scan of descriptor_list.  They should never
+ * differ, so a difference is a bug in keeping them: every one is logged,
+ * and only then are the counts rebuilt, so resets aren't misled meanwhile.
+ */
+void verify_zone_occupancy(void) {
+    std::vector<int> players(top_of_zone_table + 1);
+    DescriptorData *d;
+    int i, zone, listed;
+    bool ok = true;
+    auto zone_number = [](int zone) { return zone == NOWHERE ? NOWHERE : zone_table[zone].number; };
+
+    for (d = descriptor_list; d; d = d->next) {
+        if ((zone = occupied_zone(d)) != NOWHERE)
+            ++players[zone];
+        if (zone != d->zone) {
+            log(LogSeverity::Error, LVL_GOD, "SYSERR: {} is counted in zone {:d} but is in zone {:d}",
+                d->character && GET_NAME(d->character) ? GET_NAME(d->character) : d->host, zone_number(d->zone),
+                zone_number(zone));
+            ok = false;
+        }
+    }
+
+    for (i = 0; i <= top_of_zone_table; ++i) {
+        for (listed = 0, d = zone_table[i].descriptors; d; d = d->zone_next)
+            ++listed;
+        if (players[i] != zone_table[i].players || listed != zone_table[i].players) {
+            log(LogSeverity::Error, LVL_GOD, "SYSERR: zone {:d} counts {:d} players ({:d} listed) but has {:d}",
+                zone_table[i].number, zone_table[i].players, listed, players[i]);
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        log(LogSeverity::Error, LVL_GOD, "SYSERR: Zone player counts were wrong; counting everyone again.");
+        rebuild_zone_occupancy();
+    }
 }
 
 /* now scaled for 100 point attribs */
@@ -2689,8 +3199,7 @@ void free_char(CharData *ch) {
      * players are frequently not extracted, we need to remove events
      * when freeing too.
      */
-    if (ch->events)
-        cancel_event_list(&(ch->events));
+    cancel_event_list(&(ch->events));
     for (i = 0; i < EVENT_FLAG_FIELDS; ++i)
         ch->event_flags[i] = 0;
 
@@ -2836,96 +3345,51 @@ void clear_object(ObjData *obj) {
     obj->in_room = NOWHERE;
 }
 
-/* returns the real number of the room with given vnum */
-int real_room(int vnum) {
-    int bot, top, mid;
+/* The rnums of the rooms, mobiles, objects and quests, by vnum. */
+static VnumIndex room_index, mobile_index, object_index, quest_index;
 
-    bot = 0;
-    top = top_of_world;
+void build_room_index(void) {
+    int rnum;
 
-    /* perform binary search on world-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((world + mid)->vnum == vnum)
-            return mid;
-        if (bot >= top)
-            return NOWHERE;
-        if ((world + mid)->vnum > vnum)
-            top = mid - 1;
-        else
-            bot = mid + 1;
-    }
+    room_index.clear();
+    for (rnum = 0; rnum <= top_of_world; rnum++)
+        room_index.set(world[rnum].vnum, rnum);
 }
 
-int real_quest(unsigned short vnum) {
-    int bot, top, mid;
+void build_mobile_index(void) {
+    int rnum;
 
-    if (!all_quests) {
-        return NOWHERE;
-    }
+    mobile_index.clear();
+    for (rnum = 0; rnum <= top_of_mobt; rnum++)
+        mobile_index.set(mob_index[rnum].vnum, rnum);
+}
 
-    bot = 0;
-    top = max_quests;
+void build_object_index(void) {
+    int rnum;
 
-    /* perform binary search on quest-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((all_quests + mid)->quest_id == vnum)
-            return mid;
-        if (bot >= top)
-            return NOWHERE;
-        if ((all_quests + mid)->quest_id > vnum)
-            top = mid - 1;
-        else
-            bot = mid + 1;
-    }
+    object_index.clear();
+    for (rnum = 0; rnum <= top_of_objt; rnum++)
+        object_index.set(obj_index[rnum].vnum, rnum);
 }
 
-/* returns the real number of the monster with given vnum */
-int real_mobile(int vnum) {
-    int bot, top, mid;
-
-    bot = 0;
-    top = top_of_mobt;
+void build_quest_index(void) {
+    int rnum;
 
-    /* perform binary search on mob-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((mob_index + mid)->vnum == vnum)
-            return (mid);
-        if (bot >= top)
-            return (-1);
-        if ((mob_index + mid)->vnum > vnum)
-            top = mid - 1;
-        else
-            bot = mid + 1;
-    }
+    quest_index.clear();
+    for (rnum = 0; rnum < max_quests; rnum++)
+        quest_index.set(all_quests[rnum].quest_id, rnum);
 }
 
-/* returns the real number of the object with given vnum */
-int real_object(int vnum) {
-    int bot, top, mid;
+/* returns the real number of the room with given vnum */
+int real_room(int vnum) { return room_index.get(vnum); }
 
-    bot = 0;
-    top = top_of_objt;
+int real_quest(unsigned short vnum) { return quest_index.get(vnum); }
 
-    /* perform binary search on obj-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((obj_index + mid)->vnum == vnum)
-            return (mid);
-        if (bot >= top)
-            return (-1);
-        if ((obj_index + mid)->vnum > vnum)
-            top = mid - 1;
-        else
-            bot = mid + 1;
-    }
-}
+/* returns the real number of the monster with given vnum */
+int real_mobile(int vnum) { return mobile_index.get(vnum); }
+
+/* returns the real number of the object with given vnum */
+int real_object(int vnum) { return object_index.get(vnum); }
 
 /*
  * Read a number from a file.
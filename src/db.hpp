@@ -19,6 +19,8 @@
 #include "sysdep.hpp"
 #include "zone.hpp"
 
+#include <string>
+
 /* arbitrary constants used by index_boot() (must be unique) */
 #define DB_BOOT_WLD 0
 #define DB_BOOT_MOB 1
@@ -76,8 +78,24 @@ void boot_db(void);
 void destroy_db(void);
 void free_text_files(void);
 void zone_update(void);
+void run_zone_resets(void);
+void cancel_zone_reset(int zone);
+void compile_zone_program(int zone);
+void invalidate_zone_program(int zone);
+void invalidate_zone_programs(void);
+void benchmark_zone_resets(int rounds);
+std::string zone_reset_report(void);
+void update_zone_occupancy(DescriptorData *d);
+void remove_zone_occupancy(DescriptorData *d);
+void rebuild_zone_occupancy(void);
+void verify_zone_occupancy(void);
 int real_room(int vnum);
 int real_quest(unsigned short vnum);
+/* Rebuild the vnum lookups of real_room() and friends after changing their tables. */
+void build_room_index(void);
+void build_mobile_index(void);
+void build_object_index(void);
+void build_quest_index(void);
 char *fread_string(FILE *fl, const char *error);
 int vnum_room(char *searchname, CharData *ch);
 int vnum_zone(char *searchname, CharData *ch);
@@ -0,0 +1,526 @@
+/***************************************************************************
+ *   File: dg_compile.c                                   Part of FieryMUD *
+ *  Usage: compiling trigger scripts ahead of running them                 *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+/*
+ * script_driver() reads each line of a trigger every time it runs it:
+ * it works out what kind of line it is, scans ahead for the else, end,
+ * case or done that goes with it, and splits up its expressions.  None
+ * of that depends on anything but the text, so compile_script() does it
+ * once, when a trigger is loaded or saved in OLC, and leaves the results
+ * on the lines.  Everything here mirrors the text interpreter in
+ * dg_scripts.cpp exactly, quirks included.  Wherever the text
+ * interpreter would complain about the script's structure, the script
+ * isn't compiled, so that it runs from the text and complains as before.
+ */
+
+#include "dg_compile.hpp"
+
+#include "defines.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <vector>
+
+/*
+ * valid operands, in order of priority
+ * each must also be defined in eval_op()
+ */
+const char *script_ops[] = {"||", "&&", "==", "!=", "<=", ">=", "<", ">", "/=", "-", "+", "/", "*", "!", "\n"};
+
+/* returns 1 if string is all digits, else 0 */
+int is_num(char *num) {
+    if (*num == '\0')
+        return false;
+
+    if (*num == '+' || *num == '-')
+        ++num;
+
+    for (; *num != '\0'; ++num)
+        if (!isdigit(*num))
+            return false;
+
+    return true;
+}
+
+/* evaluates 'lhs op rhs', and copies to result */
+void eval_op(const char *op, char *lhs, char *rhs, char *result) {
+    char *p;
+    int n;
+
+    /* strip off extra spaces at begin and end */
+    while (*lhs && isspace(*lhs))
+        lhs++;
+    while (*rhs && isspace(*rhs))
+        rhs++;
+
+    for (p = lhs; *p; p++)
+        ;
+    for (--p; isspace(*p) && (p > lhs); *p-- = '\0')
+        ;
+    for (p = rhs; *p; p++)
+        ;
+    for (--p; isspace(*p) && (p > rhs); *p-- = '\0')
+        ;
+
+    /* find the op, and figure out the value */
+    if (!strcasecmp("||", op)) {
+        if ((!*lhs || (*lhs == '0')) && (!*rhs || (*rhs == '0')))
+            strcpy(result, "0");
+        else
+            strcpy(result, "1");
+    }
+
+    else if (!strcasecmp("&&", op)) {
+        if (!*lhs || (*lhs == '0') || !*rhs || (*rhs == '0'))
+            strcpy(result, "0");
+        else
+            strcpy(result, "1");
+    }
+
+    else if (!strcasecmp("==", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) == atoi(rhs));
+        else
+            sprintf(result, "%d", !strcasecmp(lhs, rhs));
+    }
+
+    else if (!strcasecmp("!=", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) != atoi(rhs));
+        else
+            sprintf(result, "%d", strcasecmp(lhs, rhs));
+    }
+
+    else if (!strcasecmp("<=", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) <= atoi(rhs));
+        else
+            sprintf(result, "%d", strcasecmp(lhs, rhs) <= 0);
+    }
+
+    else if (!strcasecmp(">=", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) >= atoi(rhs));
+        else
+            sprintf(result, "%d", strcasecmp(lhs, rhs) <= 0);
+    }
+
+    else if (!strcasecmp("<", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) < atoi(rhs));
+        else
+            sprintf(result, "%d", strcasecmp(lhs, rhs) < 0);
+    }
+
+    else if (!strcasecmp(">", op)) {
+        if (is_num(lhs) && is_num(rhs))
+            sprintf(result, "%d", atoi(lhs) > atoi(rhs));
+        else
+            sprintf(result, "%d", strcasecmp(lhs, rhs) > 0);
+    }
+
+    else if (!strcasecmp("/=", op))
+        sprintf(result, "%c", strcasestr(lhs, rhs) ? '1' : '0');
+
+    else if (!strcasecmp("*", op))
+        sprintf(result, "%d", atoi(lhs) * atoi(rhs));
+
+    else if (!strcasecmp("/", op))
+        sprintf(result, "%d", (n = atoi(rhs)) ? (atoi(lhs) / n) : 0);
+
+    else if (!strcasecmp("+", op))
+        sprintf(result, "%d", atoi(lhs) + atoi(rhs));
+
+    else if (!strcasecmp("-", op))
+        sprintf(result, "%d", atoi(lhs) - atoi(rhs));
+
+    else if (!strcasecmp("!", op)) {
+        if (is_num(rhs))
+            sprintf(result, "%d", !atoi(rhs));
+        else
+            sprintf(result, "%d", !*rhs);
+    }
+}
+
+/*
+ * p points to the first quote, returns the matching
+ * end quote, or the last non-null char in p.
+ */
+char *matching_quote(char *p) {
+    for (p++; *p && (*p != '"'); p++) {
+        if (*p == '\\')
+            p++;
+    }
+
+    if (!*p)
+        p--;
+
+    return p;
+}
+
+/*
+ * p points to the first paren.  returns a pointer to the
+ * matching closing paren, or the last non-null char in p.
+ */
+char *matching_paren(char *p) {
+    int i;
+
+    for (p++, i = 1; *p && i; p++) {
+        if (*p == '(')
+            i++;
+        else if (*p == ')')
+            i--;
+        else if (*p == '"')
+            p = matching_quote(p);
+    }
+
+    return --p;
+}
+
+static char *skip_blanks(char *p) {
+    while (*p && isspace(*p))
+        p++;
+    return p;
+}
+
+/* The order script_driver() tests lines in. */
+ScriptKeyword script_keyword(const char *p) {
+    if (*p == '*')
+        return ScriptKeyword::Comment;
+    if (!strncasecmp(p, "if ", 3))
+        return ScriptKeyword::If;
+    if (!strncasecmp("elseif ", p, 7))
+        return ScriptKeyword::ElseIf;
+    if (!strncasecmp("else", p, 4))
+        return ScriptKeyword::Else;
+    if (!strncasecmp("while ", p, 6))
+        return ScriptKeyword::While;
+    if (!strncasecmp("switch ", p, 7))
+        return ScriptKeyword::Switch;
+    if (!strncasecmp("end", p, 3))
+        return ScriptKeyword::End;
+    if (!strncasecmp("done", p, 4))
+        return ScriptKeyword::Done;
+    if (!strncasecmp("break", p, 5))
+        return ScriptKeyword::Break;
+    if (!strncasecmp("case", p, 4))
+        return ScriptKeyword::Case;
+    return ScriptKeyword::Command;
+}
+
+static const struct {
+    const char *name;
+    ScriptCommand command;
+} script_commands[] = {{"eval ", ScriptCommand::Eval},     {"halt", ScriptCommand::Halt}, {"global ", ScriptCommand::Global},
+                       {"return ", ScriptCommand::Return}, {"set ", ScriptCommand::Set},  {"unset ", ScriptCommand::Unset},
+                       {"wait ", ScriptCommand::Wait}};
+
+/* The order script_driver() tests substituted lines in. */
+ScriptCommand script_command(const char *cmd) {
+    for (const auto &command : script_commands)
+        if (!strncasecmp(cmd, command.name, strlen(command.name)))
+            return command.command;
+    return ScriptCommand::Other;
+}
+
+/*
+ * What a line will be once it's substituted, if that's certain: the
+ * text up to the first % comes through substitution unchanged, so if
+ * that decides which command it is, the rest doesn't matter.
+ */
+static ScriptCommand static_command(const char *p) {
+    const char *percent = strchr(p, '%');
+    std::size_t literal, length;
+
+    if (!percent)
+        return script_command(p);
+
+    literal = percent - p;
+    for (const auto &command : script_commands) {
+        length = strlen(command.name);
+        if (literal >= length) {
+            if (!strncasecmp(p, command.name, length))
+                return command.command;
+        } else if (!strncasecmp(p, command.name, literal))
+            return ScriptCommand::Unknown;
+    }
+    return ScriptCommand::Other;
+}
+
+static ScriptExpr *make_value(const char *text) {
+    ScriptExpr *expr = new ScriptExpr{-1, nullptr, nullptr, strdup(text), false};
+
+    expr->has_var = strchr(expr->text, '%') != nullptr;
+    return expr;
+}
+
+static void free_expr(ScriptExpr *expr) {
+    if (!expr)
+        return;
+    free_expr(expr->lhs);
+    free_expr(expr->rhs);
+    free(expr->text);
+    delete expr;
+}
+
+static ScriptExpr *compile_expr(char *line);
+
+/* eval_lhs_op_rhs(), splitting the text instead of evaluating it. */
+static ScriptExpr *compile_lhs_op_rhs(char *expr) {
+    std::vector<char> copy(expr, expr + strlen(expr) + 1);
+    std::vector<char *> tokens;
+    char *line = copy.data(), *p = line, lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH], result[MAX_INPUT_LENGTH];
+    ScriptExpr *node;
+    int i;
+
+    while (*p) {
+        tokens.push_back(p);
+        if (*p == '(')
+            p = matching_paren(p) + 1;
+        else if (*p == '"')
+            p = matching_quote(p) + 1;
+        else if (isalnum(*p))
+            for (p++; *p && (isalnum(*p) || isspace(*p)); p++)
+                ;
+        else
+            p++;
+    }
+
+    for (i = 0; *script_ops[i] != '\n'; i++)
+        for (char *token : tokens)
+            if (!strncasecmp(script_ops[i], token, strlen(script_ops[i]))) {
+                *token = '\0';
+                p = token + strlen(script_ops[i]);
+
+                node = new ScriptExpr{i, compile_expr(line), compile_expr(p), nullptr, false};
+                /* Nothing to substitute, so it's the same every time. */
+                if (node->lhs->op < 0 && !node->lhs->has_var && node->rhs->op < 0 && !node->rhs->has_var &&
+                    strlen(node->lhs->text) < sizeof(lhr) && strlen(node->rhs->text) < sizeof(rhr)) {
+                    strcpy(lhr, node->lhs->text);
+                    strcpy(rhr, node->rhs->text);
+                    *result = '\0';
+                    eval_op(script_ops[i], lhr, rhr, result);
+                    free_expr(node);
+                    node = make_value(result);
+                }
+                return node;
+            }
+
+    return nullptr;
+}
+
+/* eval_expr(), splitting the text instead of evaluating it. */
+static ScriptExpr *compile_expr(char *line) {
+    ScriptExpr *expr;
+    char *p;
+
+    line = skip_blanks(line);
+
+    if ((expr = compile_lhs_op_rhs(line)))
+        return expr;
+
+    if (*line == '(') {
+        std::vector<char> copy(line, line + strlen(line) + 1);
+        p = matching_paren(copy.data());
+        *p = '\0';
+        return compile_expr(copy.data() + 1);
+    }
+
+    return make_value(line);
+}
+
+void eval_script_expr(const ScriptExpr *expr, char *result, ScriptSubst subst, void *context) {
+    char lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
+
+    if (expr->op < 0) {
+        if (expr->has_var)
+            subst(context, expr->text, result);
+        else
+            strcpy(result, expr->text);
+        return;
+    }
+
+    eval_script_expr(expr->lhs, lhr, subst, context);
+    eval_script_expr(expr->rhs, rhr, subst, context);
+    eval_op(script_ops[expr->op], lhr, rhr, result);
+}
+
+/*
+ * The scans below are find_end(), find_else_end(), find_done() and
+ * find_case() from dg_scripts.cpp, without the parts that depend on the
+ * variables.  They return nullptr wherever the originals would log an
+ * error or run off the end of the script.
+ */
+
+static CmdlistElement *scan_end(CmdlistElement *cl) {
+    CmdlistElement *c;
+    char *p;
+
+    if (!cl->next)
+        return nullptr;
+
+    for (c = cl->next; c; c = c->next) {
+        p = skip_blanks(c->cmd);
+
+        if (!strncasecmp("if ", p, 3)) {
+            if (!(c = scan_end(c)))
+                return nullptr;
+        } else if (!strncasecmp("end", p, 3))
+            return c;
+
+        if (!c->next)
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
+/* Where find_else_end() would next stop looking, starting at c. */
+static CmdlistElement *scan_else_end(CmdlistElement *c) {
+    char *p;
+
+    for (; c->next; c = c->next) {
+        p = skip_blanks(c->cmd);
+
+        if (!strncasecmp("if ", p, 3)) {
+            if (!(c = scan_end(c)))
+                return nullptr;
+        } else if (!strncasecmp("elseif ", p, 7) || !strncasecmp("else", p, 4) || !strncasecmp("end", p, 3))
+            return c;
+
+        if (!c->next)
+            return nullptr;
+    }
+
+    /* The last line has to be an end. */
+    return strncasecmp("end", skip_blanks(c->cmd), 3) ? nullptr : c;
+}
+
+static CmdlistElement *scan_done(CmdlistElement *cl) {
+    CmdlistElement *c;
+    char *p;
+
+    if (!cl || !(cl->next))
+        return cl;
+
+    for (c = cl->next; c && c->next; c = c->next) {
+        p = skip_blanks(c->cmd);
+
+        if (!strncasecmp("while ", p, 6) || !strncasecmp("switch ", p, 7))
+            c = scan_done(c);
+        else if (!strncasecmp("done", p, 3))
+            return c;
+    }
+
+    return c;
+}
+
+/* Where find_case() would next stop looking, starting at c. */
+static CmdlistElement *scan_case(CmdlistElement *c) {
+    char *p;
+
+    for (; c->next; c = c->next) {
+        p = skip_blanks(c->cmd);
+
+        if (!strncasecmp("while ", p, 6) || !strncasecmp("switch", p, 6)) {
+            if (!(c = scan_done(c)) || !c->next)
+                return nullptr;
+        } else if (!strncasecmp("case ", p, 5) || !strncasecmp("default", p, 7) || !strncasecmp("done", p, 3))
+            return c;
+    }
+
+    return c;
+}
+
+bool compile_script(CmdlistElement *cmdlist) {
+    CmdlistElement *cl;
+    char *p;
+    bool ok = true;
+
+    for (cl = cmdlist; cl; cl = cl->next) {
+        p = skip_blanks(cl->cmd);
+        cl->keyword = script_keyword(p);
+        cl->command = ScriptCommand::Unknown;
+        cl->arg = p;
+
+        switch (cl->keyword) {
+        case ScriptKeyword::If:
+            cl->arg = p + 3;
+            cl->expr = compile_expr(cl->arg);
+            if (!(cl->branch = cl->next ? scan_else_end(cl->next) : cl))
+                ok = false;
+            break;
+        case ScriptKeyword::ElseIf:
+            cl->arg = p + 7;
+            cl->expr = compile_expr(cl->arg);
+            if (!(cl->jump = scan_end(cl)) || !(cl->branch = scan_else_end(cl->next)))
+                ok = false;
+            break;
+        case ScriptKeyword::Else:
+            if (!(cl->jump = scan_end(cl)))
+                ok = false;
+            break;
+        case ScriptKeyword::While:
+            cl->arg = p + 6;
+            cl->expr = compile_expr(cl->arg);
+            if (!(cl->jump = scan_done(cl)))
+                ok = false;
+            break;
+        case ScriptKeyword::Switch:
+            cl->arg = p + 7;
+            cl->expr = compile_expr(cl->arg);
+            if (!(cl->branch = cl->next ? scan_case(cl->next) : cl))
+                ok = false;
+            break;
+        case ScriptKeyword::Break:
+            if (!(cl->jump = scan_done(cl)))
+                ok = false;
+            break;
+        case ScriptKeyword::Case:
+            /* Only a "case " is a case to find_case(). */
+            if (!strncasecmp("case ", p, 5) && cl->next) {
+                cl->arg = p + 5;
+                cl->expr = compile_expr(cl->arg);
+                if (!(cl->branch = scan_case(cl->next)))
+                    ok = false;
+            }
+            break;
+        case ScriptKeyword::Command:
+            cl->command = static_command(p);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!ok)
+        free_compiled_script(cmdlist);
+    return ok;
+}
+
+void free_compiled_script(CmdlistElement *cmdlist) {
+    for (CmdlistElement *cl = cmdlist; cl; cl = cl->next) {
+        free_expr(cl->expr);
+        cl->keyword = ScriptKeyword::Unknown;
+        cl->command = ScriptCommand::Unknown;
+        cl->arg = nullptr;
+        cl->expr = nullptr;
+        cl->jump = cl->branch = nullptr;
+    }
+}
+
+bool script_compiled(const CmdlistElement *cmdlist) {
+    return cmdlist && cmdlist->keyword != ScriptKeyword::Unknown;
+}
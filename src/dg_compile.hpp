@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   File: dg_compile.h                                   Part of FieryMUD *
+ *  Usage: header file: compiling trigger scripts ahead of running them    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+/* What script_driver() takes a line of a trigger to be. */
+enum class ScriptKeyword : unsigned char {
+    Unknown, /* not compiled: read it from the text */
+    Comment,
+    If,
+    ElseIf,
+    Else,
+    While,
+    Switch,
+    End,
+    Done,
+    Break,
+    Case,
+    Command, /* anything else, which is substituted and then run */
+};
+
+/* What a Command line turns out to be once it's substituted. */
+enum class ScriptCommand : unsigned char {
+    Unknown, /* it depends on the substitution */
+    Eval,
+    Halt,
+    Global,
+    Return,
+    Set,
+    Unset,
+    Wait,
+    Other, /* for the mob, object or room to do */
+};
+
+/*
+ * An expression, split up the way eval_expr() splits its text: either
+ * an operator applied to two expressions, or a value, which has its
+ * variables substituted when it's evaluated.  Operators applied to
+ * values without variables are worked out when compiling.
+ */
+struct ScriptExpr {
+    int op;           /* index into script_ops[], or -1 for a value */
+    ScriptExpr *lhs;  /* operands of an operator */
+    ScriptExpr *rhs;
+    char *text;       /* a value */
+    bool has_var;     /* whether the value has any %'s to substitute */
+};
+
+/*
+ * One line of a trigger, and what compile_script() made of it.  If the
+ * script couldn't be compiled, keyword is Unknown on every line and
+ * script_driver() reads the text as it always did.
+ */
+struct CmdlistElement {
+    char *cmd; /* one line of a trigger */
+    CmdlistElement *original;
+    CmdlistElement *next;
+
+    ScriptKeyword keyword;
+    ScriptCommand command;  /* for a Command line */
+    char *arg;              /* cmd after the keyword */
+    ScriptExpr *expr;       /* the condition of an if, elseif, while, switch or case */
+    CmdlistElement *jump;   /* the end or done that an elseif, else, while or break goes to */
+    CmdlistElement *branch; /* the next line an if or switch looks at if this one doesn't match */
+};
+
+/* Substitutes variables into text, into result. */
+using ScriptSubst = void (*)(void *context, char *text, char *result);
+
+extern const char *script_ops[];
+
+/* Compile a trigger's lines, returning false if they can only be run from the text. */
+bool compile_script(CmdlistElement *cmdlist);
+void free_compiled_script(CmdlistElement *cmdlist);
+bool script_compiled(const CmdlistElement *cmdlist);
+
+ScriptKeyword script_keyword(const char *line);
+ScriptCommand script_command(const char *line);
+void eval_script_expr(const ScriptExpr *expr, char *result, ScriptSubst subst, void *context);
+
+/* The pieces of expression evaluation shared with the text interpreter. */
+int is_num(char *num);
+void eval_op(const char *op, char *lhs, char *rhs, char *result);
+char *matching_quote(char *p);
+char *matching_paren(char *p);
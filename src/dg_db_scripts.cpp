@@ -75,6 +75,7 @@ void parse_trigger(FILE *trig_f, int nr) {
     }
 
     free(cmds);
+    compile_script(trig->cmdlist);
 
     trig_index[top_of_trigt++] = index;
 }
@@ -100,21 +101,6 @@ TrigData *read_trigger(int nr) {
     return trig;
 }
 
-/* release memory allocated for a variable list */
-void free_varlist(TriggerVariableData *vd) {
-    TriggerVariableData *i, *j;
-
-    for (i = vd; i;) {
-        j = i;
-        i = i->next;
-        if (j->name)
-            free(j->name);
-        if (j->value)
-            free(j->value);
-        free(j);
-    }
-}
-
 /* release memory allocated for a script */
 void free_script(ScriptData *sc) {
     TrigData *t1, *t2;
@@ -248,6 +234,7 @@ void dg_read_trigger(FILE *fp, void *proto, int type) {
             if (!(room->script))
                 CREATE(room->script, ScriptData, 1);
             add_trigger(SCRIPT(room), read_trigger(rnum), -1);
+            list_random_script(room, WLD_TRIGGER);
         } else {
             log("SYSERR: non-existent trigger #{:d} assigned to room #{:d}", vnum, room->vnum);
         }
@@ -348,8 +335,9 @@ void assign_triggers(void *i, int type) {
         break;
     default:
         log("SYSERR: unknown type for assign_triggers()");
-        break;
+        return;
     }
+    list_random_script(i, type);
 }
 
 void free_proto_script(TriggerPrototypeList **list) {
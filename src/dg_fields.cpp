@@ -0,0 +1,196 @@
+/***************************************************************************
+ *   File: dg_fields.c                                    Part of FieryMUD *
+ *  Usage: the fields of %var.field% in trigger scripts                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "dg_fields.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <strings.h>
+
+/*
+ * The field names are looked up through a perfect hash: the compiler
+ * tries seeds until every name hashes to a slot of its own, so a lookup
+ * is one hash and one strcasecmp to make sure it's really that name.
+ */
+#define FIELD_SLOTS 2048 /* a power of two, sparse enough to find a seed quickly */
+
+struct FieldName {
+    const char *name;
+    ScriptField field;
+};
+
+static constexpr FieldName field_names[] = {
+    {"name", ScriptField::Name},
+    {"p", ScriptField::HisHer},
+    {"hisher", ScriptField::HisHer},
+    {"o", ScriptField::HimHer},
+    {"himher", ScriptField::HimHer},
+    {"n", ScriptField::HeShe},
+    {"heshe", ScriptField::HeShe},
+    {"alias", ScriptField::Alias},
+    {"title", ScriptField::Title},
+    {"vnum", ScriptField::Vnum},
+    {"id", ScriptField::Id},
+    {"sex", ScriptField::Sex},
+    {"gender", ScriptField::Sex},
+    {"class", ScriptField::Class},
+    {"race", ScriptField::Race},
+    {"level", ScriptField::Level},
+    {"weight", ScriptField::Weight},
+    {"height", ScriptField::Height},
+    {"size", ScriptField::Size},
+    {"cha", ScriptField::Cha},
+    {"str", ScriptField::Str},
+    {"int", ScriptField::Int},
+    {"wis", ScriptField::Wis},
+    {"con", ScriptField::Con},
+    {"dex", ScriptField::Dex},
+    {"real_cha", ScriptField::RealCha},
+    {"real_str", ScriptField::RealStr},
+    {"real_int", ScriptField::RealInt},
+    {"real_wis", ScriptField::RealWis},
+    {"real_con", ScriptField::RealCon},
+    {"real_dex", ScriptField::RealDex},
+    {"hit", ScriptField::Hit},
+    {"maxhit", ScriptField::MaxHit},
+    {"move", ScriptField::Move},
+    {"maxmove", ScriptField::MaxMove},
+    {"armor", ScriptField::Armor},
+    {"hitroll", ScriptField::Hitroll},
+    {"damroll", ScriptField::Damroll},
+    {"exp", ScriptField::Exp},
+    {"perception", ScriptField::Perception},
+    {"hiddenness", ScriptField::Hiddenness},
+    {"align", ScriptField::Alignment},
+    {"alignment", ScriptField::Alignment},
+    {"composition", ScriptField::Composition},
+    {"lifeforce", ScriptField::Lifeforce},
+    {"flags", ScriptField::Flags},
+    {"flagged", ScriptField::Flagged},
+    {"aff_flags", ScriptField::EffFlags},
+    {"eff_flags", ScriptField::EffFlags},
+    {"aff_flagged", ScriptField::EffFlagged},
+    {"eff_flagged", ScriptField::EffFlagged},
+    {"spells", ScriptField::Spells},
+    {"has_spell", ScriptField::HasSpell},
+    {"fighting", ScriptField::Fighting},
+    {"hunting", ScriptField::Hunting},
+    {"riding", ScriptField::Riding},
+    {"ridden_by", ScriptField::RiddenBy},
+    {"consented", ScriptField::Consented},
+    {"master", ScriptField::Master},
+    {"next_in_room", ScriptField::NextInRoom},
+    {"group_size", ScriptField::GroupSize},
+    {"group_size_in_room", ScriptField::GroupSizeInRoom},
+    {"group_leader", ScriptField::GroupLeader},
+    {"group_member", ScriptField::GroupMember},
+    {"quest_variable", ScriptField::QuestVariable},
+    {"quest_stage", ScriptField::QuestStage},
+    {"has_completed", ScriptField::HasCompleted},
+    {"has_failed", ScriptField::HasFailed},
+    {"inventory", ScriptField::Inventory},
+    {"worn", ScriptField::Worn},
+    {"wearing", ScriptField::Wearing},
+    {"position", ScriptField::Position},
+    {"stance", ScriptField::Stance},
+    {"room", ScriptField::Room},
+    {"talent", ScriptField::Skill},
+    {"skill", ScriptField::Skill},
+    {"clan", ScriptField::Clan},
+    {"clan_rank", ScriptField::ClanRank},
+    {"can_be_seen", ScriptField::CanBeSeen},
+    {"trophy", ScriptField::Trophy},
+
+    {"shortdesc", ScriptField::ShortDesc},
+    {"description", ScriptField::Description},
+    {"type", ScriptField::Type},
+    {"cost", ScriptField::Cost},
+    {"cost_per_day", ScriptField::Rent},
+    {"rent", ScriptField::Rent},
+    {"val0", ScriptField::Val0},
+    {"val1", ScriptField::Val1},
+    {"val2", ScriptField::Val2},
+    {"val3", ScriptField::Val3},
+    {"timer", ScriptField::Timer},
+    {"decomp", ScriptField::Decomp},
+    {"affect", ScriptField::Effect},
+    {"effect", ScriptField::Effect},
+    {"affect_value", ScriptField::EffectValue},
+    {"effect_value", ScriptField::EffectValue},
+    {"carried_by", ScriptField::CarriedBy},
+    {"worn_by", ScriptField::WornBy},
+    {"worn_on", ScriptField::WornOn},
+    {"contents", ScriptField::Contents},
+    {"next_in_list", ScriptField::NextInList},
+
+    {"is_dark", ScriptField::IsDark},
+    {"effects", ScriptField::Effects},
+    {"affects", ScriptField::Effects},
+    {"has_effect", ScriptField::HasEffect},
+    {"has_affect", ScriptField::HasEffect},
+    {"objects", ScriptField::Objects},
+    {"people", ScriptField::People},
+};
+
+#define NUM_FIELD_NAMES (sizeof(field_names) / sizeof(*field_names))
+
+static_assert(NUM_FIELD_NAMES < 256, "field slots hold an index into field_names[] in a byte");
+
+/* FNV-1a, folding case the cheap way: the name is checked afterwards. */
+static constexpr std::uint32_t field_hash(const char *name, std::uint32_t seed) {
+    std::uint32_t hash = seed;
+
+    for (; *name; name++)
+        hash = (hash ^ (unsigned char)(*name | 0x20)) * 16777619u;
+    return hash ^ (hash >> 16);
+}
+
+static consteval std::uint32_t find_field_seed() {
+    std::uint32_t seed;
+    std::size_t i, slot;
+
+    for (seed = 2166136261u;; seed++) {
+        std::array<bool, FIELD_SLOTS> used{};
+
+        for (i = 0; i < NUM_FIELD_NAMES; i++) {
+            slot = field_hash(field_names[i].name, seed) & (FIELD_SLOTS - 1);
+            if (used[slot])
+                break;
+            used[slot] = true;
+        }
+        if (i == NUM_FIELD_NAMES)
+            return seed;
+    }
+}
+
+static constexpr std::uint32_t field_seed = find_field_seed();
+
+/* Each slot is the index of the name there, plus one, or 0. */
+static consteval std::array<unsigned char, FIELD_SLOTS> make_field_slots() {
+    std::array<unsigned char, FIELD_SLOTS> slots{};
+    std::size_t i;
+
+    for (i = 0; i < NUM_FIELD_NAMES; i++)
+        slots[field_hash(field_names[i].name, field_seed) & (FIELD_SLOTS - 1)] = i + 1;
+    return slots;
+}
+
+static constexpr std::array<unsigned char, FIELD_SLOTS> field_slots = make_field_slots();
+
+ScriptField script_field(const char *name) {
+    int slot = field_slots[field_hash(name, field_seed) & (FIELD_SLOTS - 1)];
+
+    if (slot && !strcasecmp(field_names[slot - 1].name, name))
+        return field_names[slot - 1].field;
+    return ScriptField::Unknown;
+}
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   File: dg_fields.h                                    Part of FieryMUD *
+ *  Usage: header file: the fields of %var.field% in trigger scripts       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+/*
+ * The fields find_replacement() knows for characters, objects and
+ * rooms.  Names that mean the same thing, like p and hisher, are the
+ * same field.  Coin names and directions aren't here: they come from
+ * coindefs[] and dirs[].
+ */
+enum class ScriptField : unsigned char {
+    Unknown,
+
+    /* Characters, and the ones objects and rooms share */
+    Name,
+    HisHer,
+    HimHer,
+    HeShe,
+    Alias,
+    Title,
+    Vnum,
+    Id,
+    Sex,
+    Class,
+    Race,
+    Level,
+    Weight,
+    Height,
+    Size,
+    Cha,
+    Str,
+    Int,
+    Wis,
+    Con,
+    Dex,
+    RealCha,
+    RealStr,
+    RealInt,
+    RealWis,
+    RealCon,
+    RealDex,
+    Hit,
+    MaxHit,
+    Move,
+    MaxMove,
+    Armor,
+    Hitroll,
+    Damroll,
+    Exp,
+    Perception,
+    Hiddenness,
+    Alignment,
+    Composition,
+    Lifeforce,
+    Flags,
+    Flagged,
+    EffFlags,
+    EffFlagged,
+    Spells,
+    HasSpell,
+    Fighting,
+    Hunting,
+    Riding,
+    RiddenBy,
+    Consented,
+    Master,
+    NextInRoom,
+    GroupSize,
+    GroupSizeInRoom,
+    GroupLeader,
+    GroupMember,
+    QuestVariable,
+    QuestStage,
+    HasCompleted,
+    HasFailed,
+    Inventory,
+    Worn,
+    Wearing,
+    Position,
+    Stance,
+    Room,
+    Skill,
+    Clan,
+    ClanRank,
+    CanBeSeen,
+    Trophy,
+
+    /* Objects */
+    ShortDesc,
+    Description,
+    Type,
+    Cost,
+    Rent,
+    Val0,
+    Val1,
+    Val2,
+    Val3,
+    Timer,
+    Decomp,
+    Effect,
+    EffectValue,
+    CarriedBy,
+    WornBy,
+    WornOn,
+    Contents,
+    NextInList,
+
+    /* Rooms */
+    IsDark,
+    Effects,
+    HasEffect,
+    Objects,
+    People,
+};
+
+/* Unknown if name isn't a field of anything; case doesn't matter. */
+ScriptField script_field(const char *name);
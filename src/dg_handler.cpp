@@ -49,6 +49,165 @@ void extract_script(ScriptData *sc) {
     }
     TRIGGERS(sc) = nullptr;
 
+    SCRIPT_TYPES(sc) = 0;
+    place_script(sc, sc->room_type, NOWHERE);
+    unlist_random_script(sc);
+
     free_varlist(sc->global_vars);
     free(sc);
 }
+
+/*
+ * The scripts with random triggers, a list each for mobs, objects and
+ * rooms, so script_trigger_check() only looks at what has them.  It
+ * walks a list with random_iterator pointing at the next script, so
+ * whatever a random trigger extracts, the walk can go on.
+ */
+ScriptData *random_scripts[3] = {nullptr, nullptr, nullptr};
+ScriptData *random_iterator = nullptr;
+
+/* Call after adding triggers to go, a type trigger owner, to list it if any are random. */
+void list_random_script(void *go, int type) {
+    ScriptData *sc;
+
+    switch (type) {
+    case MOB_TRIGGER:
+        sc = SCRIPT((CharData *)go);
+        break;
+    case OBJ_TRIGGER:
+        sc = SCRIPT((ObjData *)go);
+        break;
+    case WLD_TRIGGER:
+        sc = SCRIPT((RoomData *)go);
+        break;
+    default:
+        return;
+    }
+
+    /* The random bit is the same for all three types */
+    if (!sc || sc->random_go || !IS_SET(SCRIPT_TYPES(sc), MTRIG_RANDOM))
+        return;
+
+    sc->random_go = go;
+    sc->random_type = type;
+    sc->random_prev = nullptr;
+    sc->random_next = random_scripts[type];
+    if (random_scripts[type])
+        random_scripts[type]->random_prev = sc;
+    random_scripts[type] = sc;
+}
+
+void unlist_random_script(ScriptData *sc) {
+    if (!sc->random_go)
+        return;
+
+    if (sc == random_iterator)
+        random_iterator = sc->random_next;
+    if (sc->random_prev)
+        sc->random_prev->random_next = sc->random_next;
+    else
+        random_scripts[sc->random_type] = sc->random_next;
+    if (sc->random_next)
+        sc->random_next->random_prev = sc->random_prev;
+
+    sc->random_go = nullptr;
+    sc->random_prev = sc->random_next = nullptr;
+}
+
+/*
+ * Each room counts the trigger types of the mobs in it and of the
+ * objects in it or carried or worn there, so the triggers that search
+ * a room can skip it when nothing there has the type.  The counts only
+ * ever say what might be there: a mob counted may be asleep or have
+ * MOB_NOSCRIPT.
+ */
+static void count_room_triggers(RoomData *room, int type, long types, int change) {
+    RoomTriggers *rt;
+    unsigned short *counts;
+    long *present;
+    int i;
+
+    if (!room->triggers) {
+        if (change < 0)
+            return;
+        CREATE(room->triggers, RoomTriggers, 1);
+    }
+    rt = room->triggers;
+
+    if (type == MOB_TRIGGER) {
+        counts = rt->mob_counts;
+        present = &rt->mob_types;
+    } else {
+        counts = rt->obj_counts;
+        present = &rt->obj_types;
+    }
+
+    for (i = 0; i < NUM_TRIG_TYPE_FLAGS; i++)
+        if (IS_SET(types, 1 << i)) {
+            if (change > 0 || counts[i])
+                counts[i] += change;
+            if (counts[i])
+                SET_BIT(*present, 1 << i);
+            else
+                REMOVE_BIT(*present, 1 << i);
+        }
+
+    if (!rt->mob_types && !rt->obj_types) {
+        free(rt);
+        room->triggers = nullptr;
+    }
+}
+
+/*
+ * Counts the types of sc, a type trigger script, in room rnum instead of
+ * wherever they were counted before.  NOWHERE just stops counting them.
+ */
+void place_script(ScriptData *sc, int type, int rnum) {
+    int old;
+
+    if (rnum != NOWHERE && sc->room_types == SCRIPT_TYPES(sc) && sc->room_type == type && sc->room == world[rnum].vnum)
+        return;
+
+    if (sc->room_types && (old = real_room(sc->room)) != NOWHERE)
+        count_room_triggers(&world[old], sc->room_type, sc->room_types, -1);
+    sc->room_types = 0;
+
+    if (rnum != NOWHERE && SCRIPT_TYPES(sc)) {
+        count_room_triggers(&world[rnum], type, SCRIPT_TYPES(sc), 1);
+        sc->room = world[rnum].vnum;
+        sc->room_type = type;
+        sc->room_types = SCRIPT_TYPES(sc);
+    }
+}
+
+/* Call after obj moves, to count its triggers where it is now. */
+void place_obj_triggers(ObjData *obj) {
+    int rnum;
+
+    if (!SCRIPT(obj))
+        return;
+
+    if (obj->in_room != NOWHERE)
+        rnum = obj->in_room;
+    else if (obj->carried_by)
+        rnum = IN_ROOM(obj->carried_by);
+    else if (obj->worn_by)
+        rnum = IN_ROOM(obj->worn_by);
+    else
+        rnum = NOWHERE;
+    place_script(SCRIPT(obj), OBJ_TRIGGER, rnum);
+}
+
+/* Call after ch moves, to count its triggers and its things' where it is now. */
+void place_char_triggers(CharData *ch) {
+    ObjData *obj;
+    int i;
+
+    if (SCRIPT(ch))
+        place_script(SCRIPT(ch), MOB_TRIGGER, IN_ROOM(ch));
+    for (i = 0; i < NUM_WEARS; i++)
+        if (GET_EQ(ch, i))
+            place_obj_triggers(GET_EQ(ch, i));
+    for (obj = ch->carrying; obj; obj = obj->next_content)
+        place_obj_triggers(obj);
+}
@@ -330,6 +330,7 @@ void trigedit_save(DescriptorData *d) {
 
     if ((trig_rnum = real_trigger(OLC_NUM(d))) != -1) {
         proto = trig_index[trig_rnum]->proto;
+        free_compiled_script(proto->cmdlist);
         for (cmd = proto->cmdlist; cmd; cmd = next_cmd) {
             next_cmd = cmd->next;
             if (cmd->cmd)
@@ -357,6 +358,7 @@ void trigedit_save(DescriptorData *d) {
             }
         } else
             trig->cmdlist->cmd = strdup("* No Script");
+        compile_script(trig->cmdlist);
 
         /* make the prorotype look like what we have */
         trig_data_copy(proto, trig);
@@ -390,6 +392,7 @@ void trigedit_save(DescriptorData *d) {
                 if (GET_TRIG_WAIT(live_trig))
                     event_cancel(GET_TRIG_WAIT(live_trig));
                 free_varlist(live_trig->var_list);
+                live_trig->var_list = nullptr;
             }
 
             live_trig = live_trig->next_in_world;
@@ -415,6 +418,7 @@ void trigedit_save(DescriptorData *d) {
             }
         } else
             trig->cmdlist->cmd = strdup("* No Script");
+        compile_script(trig->cmdlist);
 
         for (i = 0; i < top_of_trigt; i++) {
             if (!found) {
@@ -472,6 +476,7 @@ void trigedit_save(DescriptorData *d) {
 
         trig_index = new_index;
         top_of_trigt++;
+        build_trigger_index();
 
         /* HERE IT HAS TO GO THROUGH AND FIX ALL SCRIPTS/TRIGS OF HIGHER RNUM */
         for (live_trig = trigger_list; live_trig; live_trig = live_trig->next_in_world)
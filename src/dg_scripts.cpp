@@ -10,6 +10,7 @@
 #include "conf.hpp"
 #include "constants.hpp"
 #include "db.hpp"
+#include "dg_fields.hpp"
 #include "events.hpp"
 #include "exits.hpp"
 #include "handler.hpp"
@@ -25,8 +26,11 @@
 #include "string_utils.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
+#include "trigger_profiler.hpp"
 #include "trophy.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
+#include "vnum_index.hpp"
 
 #define PULSES_PER_MUD_HOUR (SECS_PER_MUD_HOUR * PASSES_PER_SEC)
 
@@ -73,41 +77,24 @@ struct WaitEventData {
     int type;
 };
 
-int find_real_zone_by_room(room_num vznum) {
-    int bot, top, mid;
-    int low, high;
+/* The rnums of the zones, by zone number and by the vnums each zone covers. */
+static VnumIndex zone_index, zone_vnum_index;
 
-    bot = 0;
-    top = top_of_zone_table;
+void build_zone_index(void) {
+    int rnum, vnum;
 
-    /* perform binary search on zone-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        /* Upper/lower bounds of the zone. */
-        low = zone_table[mid].number * 100;
-        high = zone_table[mid].top;
-
-        if (low <= vznum && vznum <= high)
-            return mid;
-        if (bot >= top)
-            return NOWHERE;
-        if (low > vznum)
-            top = mid - 1;
-        else
-            bot = mid + 1;
+    zone_index.clear();
+    zone_vnum_index.clear();
+    for (rnum = 0; rnum <= top_of_zone_table; rnum++) {
+        zone_index.set(zone_table[rnum].number, rnum);
+        for (vnum = zone_table[rnum].number * 100; vnum <= zone_table[rnum].top; vnum++)
+            zone_vnum_index.set(vnum, rnum);
     }
 }
 
-int real_zone(int zvnum) {
-    int i;
+int find_real_zone_by_room(room_num vznum) { return zone_vnum_index.get(vznum); }
 
-    for (i = 0; i <= top_of_zone_table; i++)
-        if (zone_table[i].number == zvnum)
-            return i;
-
-    return -1;
-}
+int real_zone(int zvnum) { return zone_index.get(zvnum); }
 
 /************************************************************
  * search by number routines                                *
@@ -115,24 +102,38 @@ int real_zone(int zvnum) {
 
 /* return char with UID n */
 CharData *find_char(int n) {
-    CharData *ch;
+    CharData *ch = (CharData *)char_uids.find(n);
 
-    for (ch = character_list; ch; ch = ch->next)
-        if (GET_ID(ch) == n)
-            return (ch);
+#if defined(CHECK_UID_TABLES)
+    CharData *i;
 
-    return nullptr;
+    for (i = character_list; i; i = i->next)
+        if (GET_ID(i) == n)
+            break;
+    if (i != ch)
+        log("SYSERR: char_uids has {} for UID {:d}, but character_list has {}", ch ? GET_NAME(ch) : "nobody", n,
+            i ? GET_NAME(i) : "nobody");
+#endif
+
+    return ch;
 }
 
 /* return object with UID n */
 ObjData *find_obj(int n) {
+    ObjData *obj = (ObjData *)obj_uids.find(n);
+
+#if defined(CHECK_UID_TABLES)
     ObjData *i;
 
     for (i = object_list; i; i = i->next)
         if (n == GET_ID(i))
-            return i;
+            break;
+    if (i != obj)
+        log("SYSERR: obj_uids has {} for UID {:d}, but object_list has {}", obj ? obj->short_description : "nothing",
+            n, i ? i->short_description : "nothing");
+#endif
 
-    return nullptr;
+    return obj;
 }
 
 /* return room with UID n */
@@ -194,42 +195,34 @@ FindContext find_dg_by_name(char *name) {
     return context;
 }
 
-/* checks every PLUSE_SCRIPT for random triggers */
+/*
+ * checks every PLUSE_SCRIPT for random triggers.  Mobs and rooms only
+ * get them while someone is playing in their zone, unless global.
+ */
 void script_trigger_check(void) {
     CharData *ch;
-    ObjData *obj;
-    RoomData *room = nullptr;
-    int nr;
+    RoomData *room;
     ScriptData *sc;
 
-    for (ch = character_list; ch; ch = ch->next) {
-        if (SCRIPT(ch)) {
-            sc = SCRIPT(ch);
+    for (sc = random_scripts[MOB_TRIGGER]; sc; sc = random_iterator) {
+        random_iterator = sc->random_next;
+        ch = (CharData *)sc->random_go;
 
-            if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-                (!is_empty(world[IN_ROOM(ch)].zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-                random_mtrigger(ch);
-        }
+        if (IN_ROOM(ch) != NOWHERE && (!is_empty(world[IN_ROOM(ch)].zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
+            random_mtrigger(ch);
     }
 
-    for (obj = object_list; obj; obj = obj->next) {
-        if (SCRIPT(obj)) {
-            sc = SCRIPT(obj);
-
-            if (IS_SET(SCRIPT_TYPES(sc), OTRIG_RANDOM))
-                random_otrigger(obj);
-        }
+    for (sc = random_scripts[OBJ_TRIGGER]; sc; sc = random_iterator) {
+        random_iterator = sc->random_next;
+        random_otrigger((ObjData *)sc->random_go);
     }
 
-    for (nr = 0; nr <= top_of_world; nr++) {
-        if (SCRIPT(&world[nr])) {
-            room = &world[nr];
-            sc = SCRIPT(room);
+    for (sc = random_scripts[WLD_TRIGGER]; sc; sc = random_iterator) {
+        random_iterator = sc->random_next;
+        room = (RoomData *)sc->random_go;
 
-            if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-                (!is_empty(room->zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-                random_wtrigger(room);
-        }
+        if (!is_empty(room->zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL))
+            random_wtrigger(room);
     }
 }
 
@@ -254,7 +247,7 @@ void pause_while_casting(void *go, TrigData *trig, int type, CmdlistElement *cl)
     WaitEventData *wait_event_obj;
     long time = 10L;
 
-    CREATE(wait_event_obj, WaitEventData, 1);
+    CREATE_EVENT_OBJ(wait_event_obj, WaitEventData);
     wait_event_obj->trigger = trig;
     wait_event_obj->go = go;
     wait_event_obj->type = type;
@@ -290,6 +283,7 @@ void do_stat_trigger(CharData *ch, TrigData *trig) {
 
     sprintf(sb, "Trigger Type: %s, Numeric Arg: %d, Arg list: %s\n", buf, GET_TRIG_NARG(trig),
             ((GET_TRIG_ARG(trig) && *GET_TRIG_ARG(trig)) ? GET_TRIG_ARG(trig) : "None"));
+    sprintf(sb + strlen(sb), "Compiled: %s\n", script_compiled(trig->cmdlist) ? "Yes" : "No");
 
     strcat(sb, "Commands:\n\n");
 
@@ -319,41 +313,48 @@ void find_uid_name(char *uid, char *name) {
 
 /* general function to display stats on script sc */
 void script_stat(CharData *ch, char *buf, ScriptData *sc) {
-    TriggerVariableData *tv;
     TrigData *t;
-    char name[MAX_INPUT_LENGTH];
+    char name[MAX_INPUT_LENGTH], value[MAX_INPUT_LENGTH];
     int found = 0;
     extern char *t_listdisplay(int nr, int index);
 
     get_char_cols(ch);
 
-    buf += sprintf(buf, "Global Variables: %s\n", sc->global_vars ? "" : "None");
+    if (sc->global_vars)
+        buf += sprintf(buf, "Global Variables: %zu (%zu bytes)\n", sc->global_vars->size(),
+                       varlist_memory(sc->global_vars));
+    else
+        buf += sprintf(buf, "Global Variables: None\n");
 
-    for (tv = sc->global_vars; tv; tv = tv->next) {
-        if (*(tv->value) == UID_CHAR) {
-            find_uid_name(tv->value, name);
-            buf += sprintf(buf, "    %15s:  %s\n", tv->name, name);
-        } else
-            buf += sprintf(buf, "    %15s:  %s\n", tv->name, tv->value);
-    }
+    if (sc->global_vars)
+        for (const ScriptVariable &tv : *sc->global_vars) {
+            if (tv.type == ScriptVarType::Uid) {
+                find_uid_name(tv.text(value), name);
+                buf += sprintf(buf, "    %15s:  %s\n", tv.name, name);
+            } else
+                buf += sprintf(buf, "    %15s:  %s\n", tv.name, tv.text(value));
+        }
 
     for (t = TRIGGERS(sc); t; t = t->next) {
         buf += sprintf(buf, "%s", t_listdisplay(t->nr, ++found));
 
 #if 1
         if (GET_TRIG_WAIT(t)) {
-            buf += sprintf(buf,
-                           "  Wait: %ld, Current line: %s\n"
-                           "  Variables: %s\n",
-                           event_time(GET_TRIG_WAIT(t)), t->curr_state->cmd, GET_TRIG_VARS(t) ? "" : "None");
-
-            for (tv = GET_TRIG_VARS(t); tv; tv = tv->next) {
-                if (*(tv->value) == UID_CHAR) {
-                    find_uid_name(tv->value, name);
-                    buf += sprintf(buf, "    %15s:  %s\n", tv->name, name);
-                } else
-                    buf += sprintf(buf, "    %15s:  %s\n", tv->name, tv->value);
-            }
+            buf += sprintf(buf, "  Wait: %ld, Current line: %s\n", event_time(GET_TRIG_WAIT(t)), t->curr_state->cmd);
+            if (GET_TRIG_VARS(t))
+                buf += sprintf(buf, "  Variables: %zu (%zu bytes)\n", GET_TRIG_VARS(t)->size(),
+                               varlist_memory(GET_TRIG_VARS(t)));
+            else
+                buf += sprintf(buf, "  Variables: None\n");
+
+            if (GET_TRIG_VARS(t))
+                for (const ScriptVariable &tv : *GET_TRIG_VARS(t)) {
+                    if (tv.type == ScriptVarType::Uid) {
+                        find_uid_name(tv.text(value), name);
+                        buf += sprintf(buf, "    %15s:  %s\n", tv.name, name);
+                    } else
+                        buf += sprintf(buf, "    %15s:  %s\n", tv.name, tv.text(value));
+                }
         }
 #endif
     }
@@ -365,6 +366,14 @@ void do_sstat_room(CharData *ch, char *buf, RoomData *rm) {
         script_stat(ch, buf + strlen(buf), SCRIPT(rm));
     else
         strcat(buf, "  None.\n");
+
+    if (rm->triggers) {
+        strcat(buf, "Mob triggers here: ");
+        sprintbit(rm->triggers->mob_types, trig_types, buf + strlen(buf));
+        strcat(buf, "\nObject triggers here: ");
+        sprintbit(rm->triggers->obj_types, otrig_types, buf + strlen(buf));
+        strcat(buf, "\n");
+    }
 }
 
 void do_sstat_object(CharData *ch, char *buf, ObjData *j) {
@@ -409,6 +418,8 @@ void add_trigger(ScriptData *sc, TrigData *t, int loc) {
     }
 
     SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(t);
+    if (sc->room_types)
+        place_script(sc, sc->room_type, real_room(sc->room));
 
     t->next_in_world = trigger_list;
     trigger_list = t;
@@ -444,6 +455,8 @@ ACMD(do_attach) {
                     if (!SCRIPT(victim))
                         CREATE(SCRIPT(victim), ScriptData, 1);
                     add_trigger(SCRIPT(victim), trig, loc);
+                    place_script(SCRIPT(victim), MOB_TRIGGER, IN_ROOM(victim));
+                    list_random_script(victim, MOB_TRIGGER);
 
                     char_printf(ch, "Trigger {:d} ({}) attached to {}.\n", tn, GET_TRIG_NAME(trig), GET_SHORT(victim));
                 } else
@@ -464,6 +477,8 @@ ACMD(do_attach) {
                 if (!SCRIPT(obj))
                     CREATE(SCRIPT(obj), ScriptData, 1);
                 add_trigger(SCRIPT(obj), trig, loc);
+                place_obj_triggers(obj);
+                list_random_script(obj, OBJ_TRIGGER);
 
                 char_printf(ch, "Trigger {:d} ({}) attached to {}.\n", tn, GET_TRIG_NAME(trig),
                             (obj->short_description ? obj->short_description : obj->name));
@@ -484,6 +499,7 @@ ACMD(do_attach) {
                     if (!(world[room].script))
                         CREATE(world[room].script, ScriptData, 1);
                     add_trigger(world[room].script, trig, loc);
+                    list_random_script(&world[room], WLD_TRIGGER);
 
                     char_printf(ch, "Trigger {:d} ({}) attached to room {:d}.\n", tn, GET_TRIG_NAME(trig),
                                 world[room].vnum);
@@ -498,33 +514,6 @@ ACMD(do_attach) {
         char_printf(ch, "Please specify 'mtr', otr', or 'wtr'.\n");
 }
 
-/* adds a variable with given name and value to trigger */
-void add_var(TriggerVariableData **var_list, const char *name, const char *value) {
-    TriggerVariableData *vd;
-
-    for (vd = *var_list; vd && strcasecmp(vd->name, name); vd = vd->next)
-        ;
-
-    if (vd) {
-        free(vd->value);
-        CREATE(vd->value, char, strlen(value) + 1);
-        strcpy(vd->value, value);
-    }
-
-    else {
-        CREATE(vd, TriggerVariableData, 1);
-
-        CREATE(vd->name, char, strlen(name) + 1);
-        strcpy(vd->name, name);
-
-        CREATE(vd->value, char, strlen(value) + 1);
-        strcpy(vd->value, value);
-
-        vd->next = *var_list;
-        *var_list = vd;
-    }
-}
-
 /*
  *  removes the trigger specified by name, and the script of o if
  *  it removes the last trigger.  name can either be a number, or
@@ -578,6 +567,10 @@ int remove_trigger(ScriptData *sc, char *name) {
         SCRIPT_TYPES(sc) = 0;
         for (i = TRIGGERS(sc); i; i = i->next)
             SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(i);
+        if (sc->room_types)
+            place_script(sc, sc->room_type, real_room(sc->room));
+        if (!IS_SET(SCRIPT_TYPES(sc), MTRIG_RANDOM))
+            unlist_random_script(sc);
 
         return 1;
     } else
@@ -700,38 +693,6 @@ ACMD(do_detach) {
     }
 }
 
-/* frees memory associated with var */
-void free_var_el(TriggerVariableData *var) {
-    free(var->name);
-    free(var->value);
-    free(var);
-}
-
-/*
- * remove var name from var_list
- * returns 1 if found, else 0
- */
-int remove_var(TriggerVariableData **var_list, const char *name) {
-    TriggerVariableData *i, *j;
-
-    for (j = nullptr, i = *var_list; i && strcasecmp(name, i->name); j = i, i = i->next)
-        ;
-
-    if (i) {
-        if (j) {
-            j->next = i->next;
-            free_var_el(i);
-        } else {
-            *var_list = i->next;
-            free_var_el(i);
-        }
-
-        return 1;
-    }
-
-    return 0;
-}
-
 /*
  *  Logs any errors caused by scripts to the system log.
  *  Will eventually allow on-line view of script errors.
@@ -778,11 +739,12 @@ int get_random_room_in_zone(int znum) {
 /* sets str to be the value of var.field */
 void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *var, char *field, char *value,
                       char *str) {
-    TriggerVariableData *vd;
+    ScriptVariable *vd;
     CharData *ch, *c = nullptr;
     ObjData *obj, *o = nullptr;
     RoomData *room, *r = nullptr;
-    char *name;
+    char *name, vd_value[MAX_INPUT_LENGTH];
+    ScriptField field_id;
     int num;
 
     if (!value)
@@ -793,9 +755,7 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      * This means that local variables take precedence and can 'mask'
      * globals and static variables.
      */
-    for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-        if (!strcasecmp(vd->name, var))
-            break;
+    vd = find_var(GET_TRIG_VARS(trig), var);
 
     /*
      * If no local variable was matched, see if there is a global variable
@@ -804,9 +764,7 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      * Some waitstates could crash the mud if sent here with sc == NULL.
      */
     if (!vd && sc)
-        for (vd = sc->global_vars; vd; vd = vd->next)
-            if (!strcasecmp(vd->name, var))
-                break;
+        vd = find_var(sc->global_vars, var);
 
     /*
      * Set 'self' variables for use below.  For example, if this is a mob
@@ -841,7 +799,7 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      */
     if (!*field) {
         if (vd)
-            strcpy(str, vd->value);
+            vd->text(str);
         else {
             if (!strcasecmp(var, "self")) {
                 switch (type) {
@@ -871,7 +829,7 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      * being requested, we need to actually locate the character, object,
      * or room.
      */
-    if (vd && (name = vd->value) && *name) {
+    if (vd && *(name = vd->text(vd_value))) {
         switch (type) {
         case MOB_TRIGGER:
             if ((o = find_obj_in_eq(ch, nullptr, find_by_name(name))))
@@ -1123,109 +1081,143 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      * accessing the 'self' variable, and we are trying to access
      * a UID variable subfield, then access the field!
      */
+    field_id = script_field(field);
+
     if (c) {
+        switch (field_id) {
         /* String identifiers */
-        if (!strcasecmp(field, "name"))
+        case ScriptField::Name:
             strcpy(str, GET_SHORT(c) ? GET_SHORT(c) : GET_NAME(c));
-        else if (!strcasecmp(field, "p") || !strcasecmp(field, "hisher"))
+            break;
+        case ScriptField::HisHer:
             strcpy(str, HSHR(c)); /* Possessive pronoun */
-        else if (!strcasecmp(field, "o") || !strcasecmp(field, "himher"))
+            break;
+        case ScriptField::HimHer:
             strcpy(str, HMHR(c)); /* Objective pronoun */
-        else if (!strcasecmp(field, "n") || !strcasecmp(field, "heshe"))
+            break;
+        case ScriptField::HeShe:
             strcpy(str, HSSH(c)); /* Nominative pronoun */
-        else if (!strcasecmp(field, "alias"))
+            break;
+        case ScriptField::Alias:
             strcpy(str, GET_NAME(c));
-        else if (!strcasecmp(field, "title"))
+            break;
+        case ScriptField::Title:
             strcpy(str, GET_TITLE(c) ? GET_TITLE(c) : "");
+            break;
 
         /* Identifying numbers */
-        else if (!strcasecmp(field, "vnum"))
+        case ScriptField::Vnum:
             sprintf(str, "%d", GET_MOB_VNUM(c));
-        else if (!strcasecmp(field, "id"))
+            break;
+        case ScriptField::Id:
             sprintf(str, "%ld", GET_ID(c));
+            break;
 
         /* Attributes */
-        else if (!strcasecmp(field, "sex") || !strcasecmp(field, "gender"))
+        case ScriptField::Sex:
             strcpy(str, genders[(int)GET_SEX(c)]);
-        else if (!strcasecmp(field, "class")) {
+            break;
+        case ScriptField::Class:
             strcpy(str, CLASS_PLAINNAME(c));
             cap_by_color(str);
-        } else if (!strcasecmp(field, "race"))
+            break;
+        case ScriptField::Race:
             strcpy(str, races[(int)GET_RACE(c)].name);
-        else if (!strcasecmp(field, "level"))
+            break;
+        case ScriptField::Level:
             sprintf(str, "%d", GET_LEVEL(c));
+            break;
 
-        else if (!strcasecmp(field, "weight"))
+        case ScriptField::Weight:
             sprintf(str, "%d", GET_WEIGHT(c));
-        else if (!strcasecmp(field, "height"))
+            break;
+        case ScriptField::Height:
             sprintf(str, "%d", GET_HEIGHT(c));
-        else if (!strcasecmp(field, "size"))
+            break;
+        case ScriptField::Size:
             sprintf(str, "%s", SIZE_DESC(c));
+            break;
 
-        else if (!strcasecmp(field, "cha"))
+        case ScriptField::Cha:
             sprintf(str, "%d", GET_VIEWED_CHA(c));
-        else if (!strcasecmp(field, "str"))
+            break;
+        case ScriptField::Str:
             sprintf(str, "%d", GET_VIEWED_STR(c));
-        else if (!strcasecmp(field, "int"))
+            break;
+        case ScriptField::Int:
             sprintf(str, "%d", GET_VIEWED_INT(c));
-        else if (!strcasecmp(field, "wis"))
+            break;
+        case ScriptField::Wis:
             sprintf(str, "%d", GET_VIEWED_WIS(c));
-        else if (!strcasecmp(field, "con"))
+            break;
+        case ScriptField::Con:
             sprintf(str, "%d", GET_VIEWED_CON(c));
-        else if (!strcasecmp(field, "dex"))
+            break;
+        case ScriptField::Dex:
             sprintf(str, "%d", GET_VIEWED_DEX(c));
+            break;
 
-        else if (!strcasecmp(field, "real_cha"))
+        case ScriptField::RealCha:
             sprintf(str, "%d", GET_CHA(c));
-        else if (!strcasecmp(field, "real_str"))
+            break;
+        case ScriptField::RealStr:
             sprintf(str, "%d", GET_STR(c));
-        else if (!strcasecmp(field, "real_int"))
+            break;
+        case ScriptField::RealInt:
             sprintf(str, "%d", GET_INT(c));
-        else if (!strcasecmp(field, "real_wis"))
+            break;
+        case ScriptField::RealWis:
             sprintf(str, "%d", GET_WIS(c));
-        else if (!strcasecmp(field, "real_con"))
+            break;
+        case ScriptField::RealCon:
             sprintf(str, "%d", GET_CON(c));
-        else if (!strcasecmp(field, "real_dex"))
+            break;
+        case ScriptField::RealDex:
             sprintf(str, "%d", GET_DEX(c));
+            break;
 
-        else if (!strcasecmp(field, "hit"))
+        case ScriptField::Hit:
             sprintf(str, "%d", GET_HIT(c));
-        else if (!strcasecmp(field, "maxhit"))
+            break;
+        case ScriptField::MaxHit:
             sprintf(str, "%d", GET_MAX_HIT(c));
-        else if (!strcasecmp(field, "move"))
+            break;
+        case ScriptField::Move:
             sprintf(str, "%d", GET_MOVE(c));
-        else if (!strcasecmp(field, "maxmove"))
+            break;
+        case ScriptField::MaxMove:
             sprintf(str, "%d", GET_MAX_MOVE(c));
-        else if (!strcasecmp(field, "armor"))
+            break;
+        case ScriptField::Armor:
             sprintf(str, "%d", GET_AC(c));
-        else if (!strcasecmp(field, "hitroll"))
+            break;
+        case ScriptField::Hitroll:
             sprintf(str, "%d", GET_HITROLL(c));
-        else if (!strcasecmp(field, "damroll"))
+            break;
+        case ScriptField::Damroll:
             sprintf(str, "%d", GET_DAMROLL(c));
-        else if (!strcasecmp(field, "exp"))
+            break;
+        case ScriptField::Exp:
             sprintf(str, "%ld", GET_EXP(c));
-        else if (!strcasecmp(field, "perception"))
+            break;
+        case ScriptField::Perception:
             sprintf(str, "%ld", GET_PERCEPTION(c));
-        else if (!strcasecmp(field, "hiddenness"))
+            break;
+        case ScriptField::Hiddenness:
             sprintf(str, "%ld", GET_HIDDENNESS(c));
-        else if (!strcasecmp(field, "align") || !strcasecmp(field, "alignment"))
+            break;
+        case ScriptField::Alignment:
             sprintf(str, "%d", GET_ALIGNMENT(c));
-        else if (!strcasecmp(field, "composition"))
+            break;
+        case ScriptField::Composition:
             strcpy(str, compositions[(int)GET_COMPOSITION(c)].name);
-        else if (!strcasecmp(field, "lifeforce"))
+            break;
+        case ScriptField::Lifeforce:
             strcpy(str, lifeforces[(int)GET_LIFEFORCE(c)].name);
-
-        else if (is_coin_name(field, PLATINUM))
-            sprintf(str, "%d", GET_PLATINUM(c));
-        else if (is_coin_name(field, GOLD))
-            sprintf(str, "%d", GET_GOLD(c));
-        else if (is_coin_name(field, SILVER))
-            sprintf(str, "%d", GET_SILVER(c));
-        else if (is_coin_name(field, COPPER))
-            sprintf(str, "%d", GET_COPPER(c));
+            break;
 
         /* Flags */
-        else if (!strcasecmp(field, "flags")) {
+        case ScriptField::Flags:
             *str = '\0';
             if (IS_NPC(c)) /* ACT flags */
                 sprintflag(str, MOB_FLAGS(c), NUM_MOB_FLAGS, action_bits);
@@ -1235,7 +1227,8 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 if (HAS_FLAGS(PRF_FLAGS(c), NUM_PRF_FLAGS))
                     sprintflag(str + strlen(str), PRF_FLAGS(c), NUM_PRF_FLAGS, preference_bits);
             }
-        } else if (!strcasecmp(field, "flagged")) {
+            break;
+        case ScriptField::Flagged:
             if (IS_NPC(c)) {
                 if ((num = search_block(value, action_bits, false)) >= 0)
                     strcpy(str, MOB_FLAGGED(c, num) ? "1" : "0");
@@ -1255,10 +1248,12 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     script_log(trig, buf2);
                 }
             }
-        } else if (!strcasecmp(field, "aff_flags") || !strcasecmp(field, "eff_flags"))
+            break;
+        case ScriptField::EffFlags:
             sprintflag(str, EFF_FLAGS(c), NUM_EFF_FLAGS, effect_flags);
+            break;
 
-        else if (!strcasecmp(field, "aff_flagged") || !strcasecmp(field, "eff_flagged")) {
+        case ScriptField::EffFlagged:
             if ((num = search_block(value, effect_flags, false)) >= 0)
                 strcpy(str, EFF_FLAGGED(c, num) ? "1" : "0");
             else {
@@ -1266,8 +1261,9 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized effect flag '%s' to %%%s.eff_flagged[]%%", value, var);
                 script_log(trig, buf2);
             }
+            break;
 
-        } else if (!strcasecmp(field, "spells")) {
+        case ScriptField::Spells: {
             effect *eff;
             *str = '\0';
             for (eff = c->effects; eff; eff = eff->next)
@@ -1275,7 +1271,8 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     strcat(str, skills[eff->type].name);
                     strcat(str, " ");
                 }
-        } else if (!strcasecmp(field, "has_spell")) {
+        } break;
+        case ScriptField::HasSpell:
             if ((num = find_talent_num(value, 0)) >= 0)
                 strcpy(str, affected_by_spell(c, num) ? "1" : "0");
             else {
@@ -1283,34 +1280,44 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized spell '%s' to %%%s.has_spell[]%%", value, var);
                 script_log(trig, buf2);
             }
-        }
+            break;
 
         /* Character relationships */
-        else if (!strcasecmp(field, "fighting"))
+        case ScriptField::Fighting:
             UID_VAR(str, FIGHTING(c));
-        else if (!strcasecmp(field, "hunting"))
+            break;
+        case ScriptField::Hunting:
             UID_VAR(str, HUNTING(c));
-        else if (!strcasecmp(field, "riding"))
+            break;
+        case ScriptField::Riding:
             UID_VAR(str, RIDING(c));
-        else if (!strcasecmp(field, "ridden_by"))
+            break;
+        case ScriptField::RiddenBy:
             UID_VAR(str, RIDDEN_BY(c));
-        else if (!strcasecmp(field, "consented"))
+            break;
+        case ScriptField::Consented:
             UID_VAR(str, CONSENT(c));
-        else if (!strcasecmp(field, "master"))
+            break;
+        case ScriptField::Master:
             UID_VAR(str, c->master);
-        else if (!strcasecmp(field, "next_in_room")) {
+            break;
+        case ScriptField::NextInRoom:
             /* Skip any wiz-invis folks */
             while (c->next_in_room && GET_INVIS_LEV(c->next_in_room))
                 c = c->next_in_room;
             UID_VAR(str, c->next_in_room);
-        } else if (!strcasecmp(field, "group_size"))
+            break;
+        case ScriptField::GroupSize:
             sprintf(str, "%d", group_size(c, false));
-        else if (!strcasecmp(field, "group_size_in_room"))
+            break;
+        case ScriptField::GroupSizeInRoom:
             sprintf(str, "%d", group_size(c, true));
-        else if (!strcasecmp(field, "group_leader")) {
+            break;
+        case ScriptField::GroupLeader:
             ch = c->group_master ? c->group_master : c;
             UID_VAR(str, ch);
-        } else if (!strcasecmp(field, "group_member")) {
+            break;
+        case ScriptField::GroupMember:
             ch = c->group_master ? c->group_master : c;
 
             num = atoi(value);
@@ -1330,10 +1337,10 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 if (num > 1)
                     strcpy(str, "0");
             }
-        }
+            break;
 
         /* Quests */
-        else if (!strcasecmp(field, "quest_variable")) {
+        case ScriptField::QuestVariable:
             if (!*value) {
                 script_log(trig, "quest_variable called without specifying a quest");
                 strcpy(str, "0");
@@ -1350,9 +1357,9 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 } else
                     strcpy(str, get_quest_variable(c, value, varptr));
             }
-        }
+            break;
 
-        else if (!strcasecmp(field, "quest_stage")) {
+        case ScriptField::QuestStage:
             if (!*value) {
                 script_log(trig, "quest_stage called without specifying a quest");
                 strcpy(str, "0");
@@ -1360,9 +1367,9 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 strcpy(str, "0");
             else
                 sprintf(str, "%d", quest_stage(c, value));
-        }
+            break;
 
-        else if (!strcasecmp(field, "has_completed")) {
+        case ScriptField::HasCompleted:
             if (!*value) {
                 script_log(trig, "has_completed called without specifying a quest");
                 strcpy(str, "0");
@@ -1370,9 +1377,9 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 strcpy(str, "0");
             else
                 strcpy(str, has_completed_quest(value, c) ? "1" : "0");
-        }
+            break;
 
-        else if (!strcasecmp(field, "has_failed")) {
+        case ScriptField::HasFailed:
             if (!*value) {
                 script_log(trig, "has_failed called without specifying a quest");
                 strcpy(str, "0");
@@ -1380,10 +1387,10 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 strcpy(str, "0");
             else
                 strcpy(str, has_failed_quest(value, c) ? "1" : "0");
-        }
+            break;
 
         /* Object relationships */
-        else if (!strcasecmp(field, "inventory")) {
+        case ScriptField::Inventory:
             if (!strcasecmp(value, "count"))
                 sprintf(str, "%d", IS_CARRYING_N(c));
             else if (*value) {
@@ -1399,7 +1406,8 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
             } else
                 /* No argument given: return the first inventory item */
                 UID_VAR(str, c->carrying);
-        } else if (!strcasecmp(field, "worn")) {
+            break;
+        case ScriptField::Worn: {
             int pos;
             if (!strcasecmp(value, "count")) {
                 for (num = pos = 0; pos < NUM_WEARS; ++pos)
@@ -1410,7 +1418,8 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 UID_VAR(str, GET_EQ(c, pos));
             else
                 strcpy(str, "0");
-        } else if (!strcasecmp(field, "wearing")) {
+        } break;
+        case ScriptField::Wearing:
             if (is_positive_integer(value)) {
                 int pos;
                 num = atoi(value);
@@ -1424,40 +1433,45 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     strcpy(str, "0");
             } else
                 strcpy(str, "0");
-        }
+            break;
 
-        else if (!strcasecmp(field, "position")) {
+        case ScriptField::Position:
             strcpy(str, position_types[(int)GET_POS(c)]);
-        } else if (!strcasecmp(field, "stance"))
+            break;
+        case ScriptField::Stance:
             strcpy(str, stance_types[(int)GET_STANCE(c)]);
+            break;
 
-        else if (!strcasecmp(field, "room")) {
+        case ScriptField::Room:
             if (IN_ROOM(c) >= 0 && IN_ROOM(c) <= top_of_world)
                 sprintf(str, "%d", world[IN_ROOM(c)].vnum);
             else
                 strcpy(str, "-1");
-        }
+            break;
 
-        else if (!strcasecmp(field, "talent") || !strcasecmp(field, "skill")) {
+        case ScriptField::Skill: {
             int talent = find_talent_num(value, 0);
             if (talent < 0)
                 strcpy(str, "0");
             else
                 sprintf(str, "%d", GET_SKILL(c, talent));
-        }
+        } break;
 
-        else if (!strcasecmp(field, "clan")) {
+        case ScriptField::Clan:
             if (!IS_NPC(c) && GET_CLAN(c))
                 strcpy(str, GET_CLAN(c)->name);
             else
                 *str = '\0';
-        } else if (!strcasecmp(field, "clan_rank"))
+            break;
+        case ScriptField::ClanRank:
             sprintf(str, "%d", IS_NPC(c) ? 0 : GET_CLAN_RANK(c));
+            break;
 
-        else if (!strcasecmp(field, "can_be_seen"))
+        case ScriptField::CanBeSeen:
             strcpy(str, type == MOB_TRIGGER && !CAN_SEE(ch, c) ? "0" : "1");
+            break;
 
-        else if (!strcasecmp(field, "trophy")) {
+        case ScriptField::Trophy:
             if (IS_NPC(c))
                 *str = '\0';
             else {
@@ -1480,67 +1494,100 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 if (*str == '\0')
                     strcpy(str, "0");
             }
-        }
+            break;
 
-        else {
-            *str = '\0';
-            sprintf(buf2, "Unknown char field: '%s'", field);
-            script_log(trig, buf2);
+        /* Coin names come from coindefs[], so they're checked last */
+        default:
+            if (is_coin_name(field, PLATINUM))
+                sprintf(str, "%d", GET_PLATINUM(c));
+            else if (is_coin_name(field, GOLD))
+                sprintf(str, "%d", GET_GOLD(c));
+            else if (is_coin_name(field, SILVER))
+                sprintf(str, "%d", GET_SILVER(c));
+            else if (is_coin_name(field, COPPER))
+                sprintf(str, "%d", GET_COPPER(c));
+            else {
+                *str = '\0';
+                sprintf(buf2, "Unknown char field: '%s'", field);
+                script_log(trig, buf2);
+            }
+            break;
         }
     }
 
     else if (o) {
+        switch (field_id) {
         /* String identifiers */
-        if (!strcasecmp(field, "name"))
+        case ScriptField::Name:
             strcpy(str, o->name);
-        else if (!strcasecmp(field, "shortdesc"))
+            break;
+        case ScriptField::ShortDesc:
             strcpy(str, o->short_description);
-        else if (!strcasecmp(field, "description"))
+            break;
+        case ScriptField::Description:
             strcpy(str, o->description);
+            break;
 
         /* Identifying numbers */
-        else if (!strcasecmp(field, "vnum"))
+        case ScriptField::Vnum:
             sprintf(str, "%d", GET_OBJ_VNUM(o));
-        else if (!strcasecmp(field, "type"))
+            break;
+        case ScriptField::Type:
             strcpy(str, OBJ_TYPE_NAME(o));
-        else if (!strcasecmp(field, "id"))
+            break;
+        case ScriptField::Id:
             sprintf(str, "%ld", GET_ID(o));
+            break;
 
         /* Numerical attributes */
-        else if (!strcasecmp(field, "weight"))
+        case ScriptField::Weight:
             sprintf(str, "%.2f", o->obj_flags.weight);
-        else if (!strcasecmp(field, "cost"))
+            break;
+        case ScriptField::Cost:
             sprintf(str, "%d", GET_OBJ_COST(o));
-        else if (!strcasecmp(field, "cost_per_day") || !strcasecmp(field, "rent"))
+            break;
+        case ScriptField::Rent:
             strcpy(str, "0");
-        else if (!strcasecmp(field, "level"))
+            break;
+        case ScriptField::Level:
             sprintf(str, "%d", GET_OBJ_LEVEL(o));
-        else if (!strcasecmp(field, "val0"))
+            break;
+        case ScriptField::Val0:
             sprintf(str, "%d", GET_OBJ_VAL(o, 0));
-        else if (!strcasecmp(field, "val1"))
+            break;
+        case ScriptField::Val1:
             sprintf(str, "%d", GET_OBJ_VAL(o, 1));
-        else if (!strcasecmp(field, "val2"))
+            break;
+        case ScriptField::Val2:
             sprintf(str, "%d", GET_OBJ_VAL(o, 2));
-        else if (!strcasecmp(field, "val3"))
+            break;
+        case ScriptField::Val3:
             sprintf(str, "%d", GET_OBJ_VAL(o, 3));
-        else if (!strcasecmp(field, "timer"))
+            break;
+        case ScriptField::Timer:
             sprintf(str, "%d", GET_OBJ_TIMER(o));
-        else if (!strcasecmp(field, "decomp"))
+            break;
+        case ScriptField::Decomp:
             sprintf(str, "%d", GET_OBJ_DECOMP(o));
-        else if (!strcasecmp(field, "hiddenness"))
+            break;
+        case ScriptField::Hiddenness:
             sprintf(str, "%ld", GET_OBJ_HIDDENNESS(o));
-        else if (!strcasecmp(field, "affect") || !strcasecmp(field, "effect")) {
+            break;
+        case ScriptField::Effect:
             if (!is_positive_integer(value) || (num = atoi(value)) > 5)
                 *str = '\0';
             else
                 sprintf(str, "%+d %s", o->applies[num].modifier, apply_types[(int)o->applies[num].location]);
-        } else if (!strcasecmp(field, "affect_value") || !strcasecmp(field, "effect_value"))
+            break;
+        case ScriptField::EffectValue:
             sprintf(str, "%d", is_positive_integer(value) && (num = atoi(value) <= 5) ? o->applies[num].modifier : 0);
+            break;
 
         /* Flags */
-        else if (!strcasecmp(field, "flags"))
+        case ScriptField::Flags:
             sprintflag(str, GET_OBJ_FLAGS(o), NUM_ITEM_FLAGS, extra_bits);
-        else if (!strcasecmp(field, "flagged")) {
+            break;
+        case ScriptField::Flagged:
             if ((num = search_block(value, extra_bits, false)) >= 0)
                 strcpy(str, OBJ_FLAGGED(o, num) ? "1" : "0");
             else {
@@ -1548,10 +1595,12 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized object extra bit '%s' to %%%s.flagged[]%%", value, var);
                 script_log(trig, buf2);
             }
-        } else if (!strcasecmp(field, "spells"))
+            break;
+        case ScriptField::Spells:
             sprintflag(str, GET_OBJ_EFF_FLAGS(o), NUM_EFF_FLAGS, effect_flags);
+            break;
 
-        else if (!strcasecmp(field, "has_spell")) {
+        case ScriptField::HasSpell:
             if ((num = search_block(value, effect_flags, false)) >= 0)
                 strcpy(str, OBJ_EFF_FLAGGED(o, num) ? "1" : "0");
             else {
@@ -1559,25 +1608,29 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized effect flag '%s' to %%%s.has_spell[]%%", value, var);
                 script_log(trig, buf2);
             }
-        }
+            break;
 
         /* Location */
-        else if (!strcasecmp(field, "room")) {
+        case ScriptField::Room:
             num = obj_room(o);
             if (num != NOWHERE)
                 sprintf(str, "%d", world[num].vnum);
             else
                 strcpy(str, "-1");
-        } else if (!strcasecmp(field, "carried_by"))
+            break;
+        case ScriptField::CarriedBy:
             UID_VAR(str, o->carried_by);
-        else if (!strcasecmp(field, "worn_by"))
+            break;
+        case ScriptField::WornBy:
             UID_VAR(str, o->worn_by);
-        else if (!strcasecmp(field, "worn_on")) {
+            break;
+        case ScriptField::WornOn:
             if (o->worn_by)
                 sprinttype(o->worn_on, wear_positions, str);
             else
                 *str = '\0';
-        } else if (!strcasecmp(field, "contents")) {
+            break;
+        case ScriptField::Contents:
             if (!strcasecmp(value, "count")) {
                 for (num = 0, o = o->contains; o; o = o->next_content)
                     ++num;
@@ -1594,13 +1647,16 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     strcpy(str, "0");
             } else
                 UID_VAR(str, o->contains);
-        } else if (!strcasecmp(field, "next_in_list"))
+            break;
+        case ScriptField::NextInList:
             UID_VAR(str, o->next_content);
+            break;
 
-        else {
+        default:
             *str = '\0';
             sprintf(buf2, "trigger type: %d. unknown object field: '%s'", type, field);
             script_log(trig, buf2);
+            break;
         }
     }
 
@@ -1608,19 +1664,22 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
      * Room variables
      */
     else if (r) {
-        if (!strcasecmp(field, "name"))
+        switch (field_id) {
+        case ScriptField::Name:
             strcpy(str, r->name);
+            break;
 
-        else if (!strcasecmp(field, "vnum"))
+        case ScriptField::Vnum:
             sprintf(str, "%d", r->vnum);
-        else if (!strncasecmp(field, "sector", 6))
-            sprintf(str, "%s", sectors[r->sector_type].name);
-        else if (!strcasecmp(field, "is_dark"))
+            break;
+        case ScriptField::IsDark:
             strcpy(str, r->light > 0 ? "1" : "0");
+            break;
 
-        else if (!strcasecmp(field, "flags"))
+        case ScriptField::Flags:
             sprintflag(str, r->room_flags, NUM_ROOM_FLAGS, room_bits);
-        else if (!strcasecmp(field, "flagged")) {
+            break;
+        case ScriptField::Flagged:
             if ((num = search_block(value, room_bits, false)) >= 0)
                 strcpy(str, IS_FLAGGED(r->room_flags, num) ? "1" : "0");
             else {
@@ -1628,9 +1687,11 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized room flag '%s' to %%%s.flagged%%", value, var);
                 script_log(trig, buf2);
             }
-        } else if (!strcasecmp(field, "effects") || !strcasecmp(field, "affects"))
+            break;
+        case ScriptField::Effects:
             sprintflag(str, r->room_effects, NUM_ROOM_EFF_FLAGS, room_effects);
-        else if (!strcasecmp(field, "has_effect") || !strcasecmp(field, "has_affect")) {
+            break;
+        case ScriptField::HasEffect:
             if ((num = search_block(value, room_effects, false)) >= 0)
                 strcpy(str, IS_FLAGGED(r->room_effects, num) ? "1" : "0");
             else {
@@ -1638,9 +1699,9 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                 sprintf(buf2, "unrecognized room effect flag '%s' to %%%s.has_effect%%", value, var);
                 script_log(trig, buf2);
             }
-        }
+            break;
 
-        else if (!strcasecmp(field, "objects")) {
+        case ScriptField::Objects:
             if (!strcasecmp(value, "count")) {
                 for (num = 0, o = r->contents; o; o = o->next_content)
                     ++num;
@@ -1657,7 +1718,8 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     strcpy(str, "0");
             } else
                 UID_VAR(str, r->contents);
-        } else if (!strcasecmp(field, "people")) {
+            break;
+        case ScriptField::People:
             if (!strcasecmp(value, "count")) {
                 for (num = 0, c = r->people; c; c = c->next_in_room)
                     if (!GET_INVIS_LEV(c))
@@ -1680,31 +1742,38 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
                     c = c->next_in_room;
                 UID_VAR(str, c);
             }
-        }
+            break;
 
-        /* Exits can have values (which are actually sub-sub-variables)  */
-        else if ((num = search_block(field, dirs, true)) >= 0) {
-            if (!r->exits[num])
-                strcpy(str, "-1");
-            else if (!*value) /* %room.DIR% is a vnum */
-                sprintf(str, "%d", r->exits[num]->to_room != NOWHERE ? world[r->exits[num]->to_room].vnum : -1);
-            else if (!strcasecmp(value, "room")) { /* %room.DIR[room]% */
-                if (r->exits[num]->to_room != NOWHERE)
-                    ROOM_UID_VAR(str, r->exits[num]->to_room);
+        /* sector takes any suffix, and directions come from dirs[] */
+        default:
+            if (!strncasecmp(field, "sector", 6))
+                sprintf(str, "%s", sectors[r->sector_type].name);
+
+            /* Exits can have values (which are actually sub-sub-variables)  */
+            else if ((num = search_block(field, dirs, true)) >= 0) {
+                if (!r->exits[num])
+                    strcpy(str, "-1");
+                else if (!*value) /* %room.DIR% is a vnum */
+                    sprintf(str, "%d", r->exits[num]->to_room != NOWHERE ? world[r->exits[num]->to_room].vnum : -1);
+                else if (!strcasecmp(value, "room")) { /* %room.DIR[room]% */
+                    if (r->exits[num]->to_room != NOWHERE)
+                        ROOM_UID_VAR(str, r->exits[num]->to_room);
+                    else
+                        strcpy(str, "0");
+                } else if (!strcasecmp(value, "key")) /* %room.DIR[key]% */
+                    sprintf(str, "%d", r->exits[num]->key);
+                else if (!strcasecmp(value, "bits")) /* %room.DIR[bits]% */
+                    sprintbit(r->exits[num]->exit_info, exit_bits, str);
                 else
-                    strcpy(str, "0");
-            } else if (!strcasecmp(value, "key")) /* %room.DIR[key]% */
-                sprintf(str, "%d", r->exits[num]->key);
-            else if (!strcasecmp(value, "bits")) /* %room.DIR[bits]% */
-                sprintbit(r->exits[num]->exit_info, exit_bits, str);
-            else
-                *str = '\0';
-        }
+                    *str = '\0';
+            }
 
-        else {
-            *str = '\0';
-            sprintf(buf2, "trigger type: %d. unknown room field: '%s'", type, field);
-            script_log(trig, buf2);
+            else {
+                *str = '\0';
+                sprintf(buf2, "trigger type: %d. unknown room field: '%s'", type, field);
+                script_log(trig, buf2);
+            }
+            break;
         }
     }
 
@@ -1715,9 +1784,11 @@ void find_replacement(void *go, ScriptData *sc, TrigData *trig, int type, char *
          * located a variable earlier than that.  If we attempted to
          * access a subfield on a non-UID variable, log an error.
          */
-        if (vd && vd->value) {
+        if (vd) {
             sprintf(buf2, "attempt to access field '%s' on %s variable '%s'", field,
-                    !*vd->value ? "empty" : (*vd->value == UID_CHAR ? "previously extracted UID" : "non-UID"), var);
+                    !*vd->text(vd_value) ? "empty"
+                                         : (vd->type == ScriptVarType::Uid ? "previously extracted UID" : "non-UID"),
+                    var);
             script_log(trig, buf2);
         }
     }
@@ -1801,156 +1872,6 @@ void var_subst(void *go, ScriptData *sc, TrigData *trig, int type, char *line, c
     }
 }
 
-/* returns 1 if string is all digits, else 0 */
-int is_num(char *num) {
-    if (*num == '\0')
-        return false;
-
-    if (*num == '+' || *num == '-')
-        ++num;
-
-    for (; *num != '\0'; ++num)
-        if (!isdigit(*num))
-            return false;
-
-    return true;
-}
-
-/* evaluates 'lhs op rhs', and copies to result */
-void eval_op(char *op, char *lhs, char *rhs, char *result, void *go, ScriptData *sc, TrigData *trig) {
-    char *p;
-    int n;
-
-    /* strip off extra spaces at begin and end */
-    while (*lhs && isspace(*lhs))
-        lhs++;
-    while (*rhs && isspace(*rhs))
-        rhs++;
-
-    for (p = lhs; *p; p++)
-        ;
-    for (--p; isspace(*p) && (p > lhs); *p-- = '\0')
-        ;
-    for (p = rhs; *p; p++)
-        ;
-    for (--p; isspace(*p) && (p > rhs); *p-- = '\0')
-        ;
-
-    /* find the op, and figure out the value */
-    if (!strcasecmp("||", op)) {
-        if ((!*lhs || (*lhs == '0')) && (!*rhs || (*rhs == '0')))
-            strcpy(result, "0");
-        else
-            strcpy(result, "1");
-    }
-
-    else if (!strcasecmp("&&", op)) {
-        if (!*lhs || (*lhs == '0') || !*rhs || (*rhs == '0'))
-            strcpy(result, "0");
-        else
-            strcpy(result, "1");
-    }
-
-    else if (!strcasecmp("==", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) == atoi(rhs));
-        else
-            sprintf(result, "%d", !strcasecmp(lhs, rhs));
-    }
-
-    else if (!strcasecmp("!=", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) != atoi(rhs));
-        else
-            sprintf(result, "%d", strcasecmp(lhs, rhs));
-    }
-
-    else if (!strcasecmp("<=", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) <= atoi(rhs));
-        else
-            sprintf(result, "%d", strcasecmp(lhs, rhs) <= 0);
-    }
-
-    else if (!strcasecmp(">=", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) >= atoi(rhs));
-        else
-            sprintf(result, "%d", strcasecmp(lhs, rhs) <= 0);
-    }
-
-    else if (!strcasecmp("<", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) < atoi(rhs));
-        else
-            sprintf(result, "%d", strcasecmp(lhs, rhs) < 0);
-    }
-
-    else if (!strcasecmp(">", op)) {
-        if (is_num(lhs) && is_num(rhs))
-            sprintf(result, "%d", atoi(lhs) > atoi(rhs));
-        else
-            sprintf(result, "%d", strcasecmp(lhs, rhs) > 0);
-    }
-
-    else if (!strcasecmp("/=", op))
-        sprintf(result, "%c", strcasestr(lhs, rhs) ? '1' : '0');
-
-    else if (!strcasecmp("*", op))
-        sprintf(result, "%d", atoi(lhs) * atoi(rhs));
-
-    else if (!strcasecmp("/", op))
-        sprintf(result, "%d", (n = atoi(rhs)) ? (atoi(lhs) / n) : 0);
-
-    else if (!strcasecmp("+", op))
-        sprintf(result, "%d", atoi(lhs) + atoi(rhs));
-
-    else if (!strcasecmp("-", op))
-        sprintf(result, "%d", atoi(lhs) - atoi(rhs));
-
-    else if (!strcasecmp("!", op)) {
-        if (is_num(rhs))
-            sprintf(result, "%d", !atoi(rhs));
-        else
-            sprintf(result, "%d", !*rhs);
-    }
-}
-
-/*
- * p points to the first quote, returns the matching
- * end quote, or the last non-null char in p.
- */
-char *matching_quote(char *p) {
-    for (p++; *p && (*p != '"'); p++) {
-        if (*p == '\\')
-            p++;
-    }
-
-    if (!*p)
-        p--;
-
-    return p;
-}
-
-/*
- * p points to the first paren.  returns a pointer to the
- * matching closing paren, or the last non-null char in p.
- */
-char *matching_paren(char *p) {
-    int i;
-
-    for (p++, i = 1; *p && i; p++) {
-        if (*p == '(')
-            i++;
-        else if (*p == ')')
-            i--;
-        else if (*p == '"')
-            p = matching_quote(p);
-    }
-
-    return --p;
-}
-
 /* evaluates line, and returns answer in result */
 void eval_expr(char *line, char *result, void *go, ScriptData *sc, TrigData *trig, int type) {
     char expr[MAX_INPUT_LENGTH], *p;
@@ -1981,12 +1902,6 @@ int eval_lhs_op_rhs(char *expr, char *result, void *go, ScriptData *sc, TrigData
     char line[MAX_INPUT_LENGTH], lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
     int i, j;
 
-    /*
-     * valid operands, in order of priority
-     * each must also be defined in eval_op()
-     */
-    static char *ops[] = {"||", "&&", "==", "!=", "<=", ">=", "<", ">", "/=", "-", "+", "/", "*", "!", "\n"};
-
     p = strcpy(line, expr);
 
     /*
@@ -2007,15 +1922,15 @@ int eval_lhs_op_rhs(char *expr, char *result, void *go, ScriptData *sc, TrigData
     }
     tokens[j] = nullptr;
 
-    for (i = 0; *ops[i] != '\n'; i++)
+    for (i = 0; *script_ops[i] != '\n'; i++)
         for (j = 0; tokens[j]; j++)
-            if (!strncasecmp(ops[i], tokens[j], strlen(ops[i]))) {
+            if (!strncasecmp(script_ops[i], tokens[j], strlen(script_ops[i]))) {
                 *tokens[j] = '\0';
-                p = tokens[j] + strlen(ops[i]);
+                p = tokens[j] + strlen(script_ops[i]);
 
                 eval_expr(line, lhr, go, sc, trig, type);
                 eval_expr(p, rhr, go, sc, trig, type);
-                eval_op(ops[i], lhr, rhr, result, go, sc, trig);
+                eval_op(script_ops[i], lhr, rhr, result);
 
                 return 1;
             }
@@ -2038,6 +1953,35 @@ int process_if(char *cond, void *go, ScriptData *sc, TrigData *trig, int type) {
         return 1;
 }
 
+/* What script_driver() substitutes a compiled trigger's variables with. */
+struct ScriptContext {
+    void *go;
+    ScriptData *sc;
+    TrigData *trig;
+    int type;
+};
+
+static void script_subst(void *context, char *text, char *result) {
+    ScriptContext *ctx = (ScriptContext *)context;
+
+    var_subst(ctx->go, ctx->sc, ctx->trig, ctx->type, text, result);
+}
+
+/* process_if() for a compiled condition */
+static int compiled_if(const ScriptExpr *cond, ScriptContext *ctx) {
+    char result[MAX_INPUT_LENGTH], *p;
+
+    eval_script_expr(cond, result, script_subst, ctx);
+
+    p = result;
+    skip_spaces(&p);
+
+    if (!*p || *p == '0')
+        return 0;
+    else
+        return 1;
+}
+
 /*
  * scans for end of if-block.
  * returns the line containg 'end', or the last
@@ -2119,6 +2063,53 @@ CmdlistElement *find_else_end(TrigData *trig, CmdlistElement *cl, void *go, Scri
     return c;
 }
 
+/*
+ * find_else_end() for a compiled if, following the elseif, else and
+ * end lines compile_script() found instead of reading the lines between.
+ */
+static CmdlistElement *compiled_else_end(CmdlistElement *cl, ScriptContext *ctx) {
+    CmdlistElement *c;
+
+    if (!(cl->next))
+        return cl;
+
+    for (c = cl->branch; c->next; c = c->branch) {
+        if (c->keyword == ScriptKeyword::ElseIf) {
+            if (compiled_if(c->expr, ctx)) {
+                GET_TRIG_DEPTH(ctx->trig)++;
+                return c;
+            }
+        } else {
+            if (c->keyword == ScriptKeyword::Else)
+                GET_TRIG_DEPTH(ctx->trig)++;
+            return c;
+        }
+    }
+
+    return c;
+}
+
+/* find_case() for a compiled switch */
+static CmdlistElement *compiled_case(CmdlistElement *cl, ScriptContext *ctx) {
+    char cond_expr[MAX_INPUT_LENGTH], case_expr[MAX_STRING_LENGTH];
+    char result[16]; /* == always returns an integer, so it shouuld be safe */
+    CmdlistElement *c;
+
+    if (!(cl->next))
+        return cl;
+
+    eval_script_expr(cl->expr, cond_expr, script_subst, ctx);
+
+    for (c = cl->branch; c->next && c->keyword == ScriptKeyword::Case && c->expr; c = c->branch) {
+        eval_script_expr(c->expr, case_expr, script_subst, ctx);
+        eval_op("==", cond_expr, case_expr, result);
+        if (*result && *result != '0')
+            break;
+    }
+
+    return c;
+}
+
 /* processes any 'wait' commands in a trigger */
 void process_wait(void *go, TrigData *trig, int type, char *cmd, CmdlistElement *cl) {
     char buf[MAX_INPUT_LENGTH], *arg;
@@ -2165,7 +2156,7 @@ void process_wait(void *go, TrigData *trig, int type, char *cmd, CmdlistElement
         }
     }
 
-    CREATE(wait_event_obj, WaitEventData, 1);
+    CREATE_EVENT_OBJ(wait_event_obj, WaitEventData);
     wait_event_obj->trigger = trig;
     wait_event_obj->go = go;
     wait_event_obj->type = type;
@@ -2253,7 +2244,7 @@ void process_unset(ScriptData *sc, TrigData *trig, char *cmd) {
  * makes a local variable into a global variable
  */
 void process_global(ScriptData *sc, TrigData *trig, char *cmd) {
-    TriggerVariableData *vd;
+    ScriptVariable *vd;
     char arg[MAX_INPUT_LENGTH], *varlist;
 
     varlist = any_one_arg(cmd, arg);
@@ -2270,17 +2261,15 @@ void process_global(ScriptData *sc, TrigData *trig, char *cmd) {
         varlist = any_one_arg(varlist, arg);
         skip_spaces(&varlist);
 
-        for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-            if (!strcasecmp(vd->name, arg))
-                break;
-
-        if (!vd) {
+        if (!(vd = find_var(GET_TRIG_VARS(trig), arg))) {
             sprintf(buf2, "Local var '%s' not found in global call", arg);
             script_log(trig, buf2);
             continue;
         }
 
-        add_var(&(sc->global_vars), vd->name, vd->value);
+        if (!sc->global_vars)
+            sc->global_vars = new ScriptVariables;
+        sc->global_vars->set(*vd);
         remove_var(&GET_TRIG_VARS(trig), vd->name);
     }
 }
@@ -2310,6 +2299,9 @@ int script_driver(void *go_address, TrigData *trig, int type, int mode) {
     CmdlistElement *temp;
     unsigned long loops = 0;
     void *go = nullptr;
+    ScriptKeyword keyword;
+    ScriptCommand command;
+    bool compiled;
 
     void obj_command_interpreter(ObjData * obj, TrigData * t, char *argument);
     void wld_command_interpreter(RoomData * room, TrigData * t, char *argument);
@@ -2347,9 +2339,16 @@ int script_driver(void *go_address, TrigData *trig, int type, int mode) {
         break;
     }
 
+    ScriptContext context = {go, sc, trig, type};
+    compiled = script_compiled(trig->cmdlist);
+
+    TriggerProfile &profile = trigger_profile(GET_TRIG_VNUM(trig));
+    TriggerTimer timer(profile);
+
     if (mode == TRIG_NEW) {
         GET_TRIG_DEPTH(trig) = 1;
         GET_TRIG_LOOPS(trig) = 0;
+        ++profile.runs;
     }
 
     trig->running = true;
@@ -2373,70 +2372,76 @@ int script_driver(void *go_address, TrigData *trig, int type, int mode) {
         for (p = cl->cmd; *p && isspace(*p); p++)
             ;
 
-        if (*p == '*')
+        keyword = compiled ? cl->keyword : script_keyword(p);
+
+        if (keyword == ScriptKeyword::Comment)
             continue;
 
-        else if (!strncasecmp(p, "if ", 3)) {
-            if (process_if(p + 3, go, sc, trig, type))
+        ++profile.lines;
+
+        if (keyword == ScriptKeyword::If) {
+            if (compiled ? compiled_if(cl->expr, &context) : process_if(p + 3, go, sc, trig, type))
                 GET_TRIG_DEPTH(trig)++;
             else
-                cl = find_else_end(trig, cl, go, sc, type);
+                cl = compiled ? compiled_else_end(cl, &context) : find_else_end(trig, cl, go, sc, type);
         }
 
-        else if (!strncasecmp("elseif ", p, 7) || !strncasecmp("else", p, 4)) {
+        else if (keyword == ScriptKeyword::ElseIf || keyword == ScriptKeyword::Else) {
             /* If not in an if-block, ignore the extra 'else[if]' and warn about it.
              */
             if (GET_TRIG_DEPTH(trig) == 1) {
                 script_log(trig, "'else' without 'if'.");
                 continue;
             }
-            cl = find_end(trig, cl);
+            cl = compiled ? cl->jump : find_end(trig, cl);
             GET_TRIG_DEPTH(trig)--;
-        } else if (!strncasecmp("while ", p, 6)) {
-            temp = find_done(cl);
+        } else if (keyword == ScriptKeyword::While) {
+            temp = compiled ? cl->jump : find_done(cl);
             if (!temp) {
                 script_log(trig, "'while' without 'done'.");
                 return ret_val;
-            } else if (process_if(p + 6, go, sc, trig, type)) {
+            } else if (compiled ? compiled_if(cl->expr, &context) : process_if(p + 6, go, sc, trig, type)) {
                 temp->original = cl;
             } else {
                 cl = temp;
                 loops = 0;
             }
-        } else if (!strncasecmp("switch ", p, 7)) {
-            cl = find_case(trig, cl, go, sc, type, p + 7);
-        } else if (!strncasecmp("end", p, 3)) {
+        } else if (keyword == ScriptKeyword::Switch) {
+            cl = compiled ? compiled_case(cl, &context) : find_case(trig, cl, go, sc, type, p + 7);
+        } else if (keyword == ScriptKeyword::End) {
             if (GET_TRIG_DEPTH(trig) == 1) {
                 script_log(trig, "'end' without 'if'.");
                 continue;
             }
             GET_TRIG_DEPTH(trig)--;
-        } else if (!strncasecmp("done", p, 4)) {
+        } else if (keyword == ScriptKeyword::Done) {
             /* if in a while loop, cl->original is non-NULL */
             if (cl->original) {
                 char *orig_cmd = cl->original->cmd;
                 while (*orig_cmd && isspace(*orig_cmd))
                     orig_cmd++;
 
-                if (cl->original && process_if(orig_cmd + 6, go, sc, trig, type)) {
+                if (compiled ? compiled_if(cl->original->expr, &context)
+                             : process_if(orig_cmd + 6, go, sc, trig, type)) {
                     cl = cl->original;
-                    temp = find_done(cl);
                     loops++;
                     GET_TRIG_LOOPS(trig)++;
                     if (loops == 30) {
+                        ++profile.waits;
                         process_wait(go, trig, type, "wait 1", cl);
                         depth--;
                         return ret_val;
                     }
                     if (GET_TRIG_LOOPS(trig) >= 100) {
+                        ++profile.loop_limits;
                         script_log(trig, "looped 100 times!!!");
                         break;
                     }
                 }
             }
-        } else if (!strncasecmp("break", p, 5)) {
-            cl = find_done(cl);
-        } else if (!strncasecmp("case", p, 4)) {
+        } else if (keyword == ScriptKeyword::Break) {
+            cl = compiled ? cl->jump : find_done(cl);
+        } else if (keyword == ScriptKeyword::Case) {
             /* Do nothing, this allows multiple cases to a single instance */
         }
 
@@ -2444,25 +2449,29 @@ int script_driver(void *go_address, TrigData *trig, int type, int mode) {
 
             var_subst(go, sc, trig, type, p, cmd);
 
-            if (!strncasecmp(cmd, "eval ", 5))
+            /* A compiled line may already be known not to depend on the substitution */
+            command = cl->command == ScriptCommand::Unknown ? script_command(cmd) : cl->command;
+
+            if (command == ScriptCommand::Eval)
                 process_eval(go, sc, trig, type, cmd);
 
-            else if (!strncasecmp(cmd, "halt", 4))
+            else if (command == ScriptCommand::Halt)
                 break;
 
-            else if (!strncasecmp(cmd, "global ", 7))
+            else if (command == ScriptCommand::Global)
                 process_global(sc, trig, cmd);
 
-            else if (!strncasecmp(cmd, "return ", 7))
+            else if (command == ScriptCommand::Return)
                 ret_val = process_return(trig, cmd);
 
-            else if (!strncasecmp(cmd, "set ", 4))
+            else if (command == ScriptCommand::Set)
                 process_set(sc, trig, cmd);
 
-            else if (!strncasecmp(cmd, "unset ", 6))
+            else if (command == ScriptCommand::Unset)
                 process_unset(sc, trig, cmd);
 
-            else if (!strncasecmp(cmd, "wait ", 5)) {
+            else if (command == ScriptCommand::Wait) {
+                ++profile.waits;
                 process_wait(go, trig, type, cmd, cl);
                 depth--;
                 return ret_val;
@@ -2497,19 +2506,19 @@ int script_driver(void *go_address, TrigData *trig, int type, int mode) {
     return ret_val;
 }
 
-int real_trigger(int vnum) {
-    int rnum;
+/* The rnums of the triggers, by vnum. */
+static VnumIndex trigger_index;
 
-    for (rnum = 0; rnum < top_of_trigt; rnum++) {
-        if (trig_index[rnum]->vnum == vnum)
-            break;
-    }
+void build_trigger_index(void) {
+    int rnum;
 
-    if (rnum == top_of_trigt)
-        rnum = -1;
-    return (rnum);
+    trigger_index.clear();
+    for (rnum = 0; rnum < top_of_trigt; rnum++)
+        trigger_index.set(trig_index[rnum]->vnum, rnum);
 }
 
+int real_trigger(int vnum) { return trigger_index.get(vnum); }
+
 ACMD(do_tstat) {
     int vnum, rnum;
     char str[MAX_INPUT_LENGTH];
@@ -2552,7 +2561,7 @@ CmdlistElement *find_case(TrigData *trig, CmdlistElement *cl, void *go, ScriptDa
             char case_expr[MAX_STRING_LENGTH];
             char result[16]; /* == always returns an integer, so it shouuld be safe */
             eval_expr(p + 5, case_expr, go, sc, trig, type);
-            eval_op("==", cond_expr, case_expr, result, go, sc, trig);
+            eval_op("==", cond_expr, case_expr, result);
             if (*result && *result != '0')
                 return c;
         } else if (!strncasecmp("default", p, 7))
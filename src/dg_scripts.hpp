@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include "dg_compile.hpp"
+#include "dg_variables.hpp"
 #include "fight.hpp"
 #include "rooms.hpp"
 #include "structs.hpp"
@@ -101,38 +103,24 @@
     10 /* maximum depth triggers can                                                                                   \
           recurse into each other */
 
-/* one line of the trigger */
-struct CmdlistElement {
-    char *cmd; /* one line of a trigger */
-    CmdlistElement *original;
-    CmdlistElement *next;
-};
-
-struct TriggerVariableData {
-    char *name;  /* name of variable  */
-    char *value; /* value of variable */
-
-    TriggerVariableData *next;
-};
-
 /* structure for triggers */
 struct TrigData {
-    int nr;                        /* trigger's rnum                  */
-    byte attach_type;              /* mob/obj/wld intentions          */
-    byte data_type;                /* type of game_data for trig      */
-    char *name;                    /* name of trigger                 */
-    long trigger_type;             /* type of trigger (for bitvector) */
-    CmdlistElement *cmdlist;       /* top of command list             */
-    CmdlistElement *curr_state;    /* ptr to current line of trigger  */
-    int narg;                      /* numerical argument              */
-    char *arglist;                 /* argument list                   */
-    int depth;                     /* depth into nest ifs/whiles/etc  */
-    int loops;                     /* loop iteration counter          */
-    Event *wait_event;             /* event to pause the trigger      */
-    ubyte purged;                  /* trigger is set to be purged     */
-    ubyte running;                 /* trigger is running              */
-    int damdone;                   /* Amount of damage done by a *damage command */
-    TriggerVariableData *var_list; /* list of local vars for trigger  */
+    int nr;                     /* trigger's rnum                  */
+    byte attach_type;           /* mob/obj/wld intentions          */
+    byte data_type;             /* type of game_data for trig      */
+    char *name;                 /* name of trigger                 */
+    long trigger_type;          /* type of trigger (for bitvector) */
+    CmdlistElement *cmdlist;    /* top of command list             */
+    CmdlistElement *curr_state; /* ptr to current line of trigger  */
+    int narg;                   /* numerical argument              */
+    char *arglist;              /* argument list                   */
+    int depth;                  /* depth into nest ifs/whiles/etc  */
+    int loops;                  /* loop iteration counter          */
+    Event *wait_event;          /* event to pause the trigger      */
+    ubyte purged;               /* trigger is set to be purged     */
+    ubyte running;              /* trigger is running              */
+    int damdone;                /* Amount of damage done by a *damage command */
+    ScriptVariables *var_list;  /* list of local vars for trigger  */
 
     TrigData *next;
     TrigData *next_in_world; /* next in the global trigger list */
@@ -144,17 +132,43 @@ extern TrigData *trigger_list;
 
 /* a complete script (composed of several triggers) */
 struct ScriptData {
-    long types;                       /* bitvector of trigger types */
-    TrigData *trig_list;              /* list of triggers           */
-    TriggerVariableData *global_vars; /* list of global variables   */
-    ubyte purged;                     /* script is set to be purged */
+    long types;                   /* bitvector of trigger types */
+    TrigData *trig_list;          /* list of triggers           */
+    ScriptVariables *global_vars; /* list of global variables   */
+    ubyte purged;                 /* script is set to be purged */
+    room_num room;                /* vnum of the room counting room_types */
+    int room_type;                /* counted there as MOB_ or OBJ_TRIGGER */
+    long room_types;              /* types counted there, 0 if none */
+    void *random_go;              /* owner, while on a random_scripts list */
+    int random_type;              /* the list: MOB_, OBJ_ or WLD_TRIGGER */
+    ScriptData *random_prev;
+    ScriptData *random_next;
 
     ScriptData *next; /* used for purged_scripts    */
 };
+extern ScriptData *random_scripts[3];
+extern ScriptData *random_iterator;
+
+/*
+ * How many mobs in a room have each type of mob trigger, and how many
+ * objects lying there or carried or worn by someone there have each
+ * type of object trigger.  Rooms with none have no RoomTriggers.
+ */
+struct RoomTriggers {
+    long mob_types; /* types with a nonzero count */
+    long obj_types;
+    unsigned short mob_counts[NUM_TRIG_TYPE_FLAGS];
+    unsigned short obj_counts[NUM_TRIG_TYPE_FLAGS];
+};
 
 /* function prototypes for dg_scripts.c */
 int find_real_zone_by_room(room_num vznum);
 int real_zone(int zvnum);
+/* Rebuild the lookups of find_real_zone_by_room() and real_zone() after changing the zone table. */
+void build_zone_index(void);
+/* The character or object with a given GET_ID(), looked up in the uid tables. */
+CharData *find_char(int n);
+ObjData *find_obj(int n);
 
 /* function prototypes from triggers.c */
 void act_mtrigger(const CharData *ch, const char *str, const CharData *actor, const CharData *victim,
@@ -227,21 +241,21 @@ void assign_triggers(void *i, int type);
 TrigData *read_trigger(int nr);
 void parse_trigger(FILE *trig_f, int nr);
 int real_trigger(int vnum);
+void build_trigger_index(void);
 void extract_script(ScriptData *sc);
+void place_script(ScriptData *sc, int type, int rnum);
+void place_char_triggers(CharData *ch);
+void place_obj_triggers(ObjData *obj);
+void list_random_script(void *go, int type);
+void unlist_random_script(ScriptData *sc);
 void fullpurge_char(CharData *ch);
 void check_time_triggers(void);
 void free_trigger(TrigData *trig);
-void free_varlist(TriggerVariableData *vd);
 void free_proto_script(TriggerPrototypeList **list);
 bool format_script(DescriptorData *d, int indent_quantum);
 
-void add_var(TriggerVariableData **var_list, const char *name, const char *value);
-int remove_var(TriggerVariableData **var_list, const char *name);
-
 /* Macros for scripts */
 
-#define UID_CHAR '\005'
-
 #define GET_TRIG_NAME(t) ((t)->name)
 #define GET_TRIG_RNUM(t) ((t)->nr)
 #define GET_TRIG_VNUM(t) (trig_index[(t)->nr]->vnum)
@@ -264,11 +278,13 @@ int remove_var(TriggerVariableData **var_list, const char *name);
 #define SCRIPT_CHECK(go, type) (SCRIPT(go) && IS_SET(SCRIPT_TYPES(SCRIPT(go)), type))
 #define TRIGGER_CHECK(t, type) (IS_SET(GET_TRIG_TYPE(t), type) && !GET_TRIG_DEPTH(t))
 
-#define ADD_UID_VAR(buf, trig, go, name)                                                                               \
-    {                                                                                                                  \
-        sprintf(buf, "%c%ld", UID_CHAR, GET_ID(go));                                                                   \
-        add_var(&GET_TRIG_VARS(trig), name, buf);                                                                      \
-    }
+/* Whether anything in room rnum might have a trigger of type */
+#define ROOM_MOB_TRIGGERS(rnum) (world[rnum].triggers ? world[rnum].triggers->mob_types : 0)
+#define ROOM_OBJ_TRIGGERS(rnum) (world[rnum].triggers ? world[rnum].triggers->obj_types : 0)
+#define ROOM_HAS_MOB_TRIGGER(rnum, type) IS_SET(ROOM_MOB_TRIGGERS(rnum), type)
+#define ROOM_HAS_OBJ_TRIGGER(rnum, type) IS_SET(ROOM_OBJ_TRIGGERS(rnum), type)
+
+#define ADD_UID_VAR(trig, go, name) add_uid_var(&GET_TRIG_VARS(trig), name, GET_ID(go))
 
 /* typedefs that the dg functions rely on */
 // typedef struct index_data index_data;
@@ -116,7 +116,6 @@ void random_mtrigger(CharData *ch) {
  */
 void bribe_mtrigger(CharData *ch, CharData *actor, int coins[]) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int raw_value;
     int type;
 
@@ -128,13 +127,11 @@ void bribe_mtrigger(CharData *ch, CharData *actor, int coins[]) {
 
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_BRIBE) && (raw_value >= GET_TRIG_NARG(t))) {
-            sprintf(buf, "%d", raw_value);
-            add_var(&GET_TRIG_VARS(t), "value", buf);
+            add_number_var(&GET_TRIG_VARS(t), "value", raw_value);
             for (type = 0; type < NUM_COIN_TYPES; ++type) {
-                sprintf(buf, "%d", coins[type]);
-                add_var(&GET_TRIG_VARS(t), COIN_NAME(type), buf);
+                add_number_var(&GET_TRIG_VARS(t), COIN_NAME(type), coins[type]);
             }
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
             break;
         }
@@ -154,10 +151,9 @@ void bribe_mtrigger(CharData *ch, CharData *actor, int coins[]) {
 int greet_mtrigger(CharData *actor, int dir) {
     TrigData *t;
     CharData *ch, *next_in_room;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val = true;
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_MOB_TRIGGER(IN_ROOM(actor), MTRIG_GREET | MTRIG_GREET_ALL))
         return 1;
 
     for (ch = world[IN_ROOM(actor)].people; ch; ch = next_in_room) {
@@ -171,7 +167,7 @@ int greet_mtrigger(CharData *actor, int dir) {
                  IS_SET(GET_TRIG_TYPE(t), MTRIG_GREET_ALL)) &&
                 !GET_TRIG_DEPTH(t) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
                 add_var(&GET_TRIG_VARS(t), "direction", dirs[rev_dir[dir]]);
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 if (!script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW))
                     ret_val = false;
                 if (!ch || DECEASED(actor))
@@ -196,8 +192,7 @@ int entry_mtrigger(CharData *ch, int destination) {
 
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_ENTRY) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            sprintf(buf, "%d", destination);
-            add_var(&GET_TRIG_VARS(t), "destination", buf);
+            add_number_var(&GET_TRIG_VARS(t), "destination", destination);
             if (!script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW) || !ch)
                 return false;
         }
@@ -217,9 +212,8 @@ int entry_mtrigger(CharData *ch, int destination) {
 int command_mtrigger(CharData *actor, char *cmd, char *argument) {
     CharData *ch, *ch_next;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_MOB_TRIGGER(IN_ROOM(actor), MTRIG_COMMAND))
         return 0;
 
     for (ch = world[IN_ROOM(actor)].people; ch; ch = ch_next) {
@@ -237,7 +231,7 @@ int command_mtrigger(CharData *actor, char *cmd, char *argument) {
                 }
 
                 if (*GET_TRIG_ARG(t) == '*' || !strncasecmp(GET_TRIG_ARG(t), cmd, strlen(cmd))) {
-                    ADD_UID_VAR(buf, t, actor, "actor");
+                    ADD_UID_VAR(t, actor, "actor");
                     skip_spaces(&argument);
                     add_var(&GET_TRIG_VARS(t), "arg", argument);
                     skip_spaces(&cmd);
@@ -255,9 +249,8 @@ int command_mtrigger(CharData *actor, char *cmd, char *argument) {
 void speech_mtrigger(CharData *actor, const char *str) {
     CharData *ch, *ch_next;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_MOB_TRIGGER(IN_ROOM(actor), MTRIG_SPEECH | MTRIG_SPEECHTO))
         return;
 
     for (ch = world[IN_ROOM(actor)].people; ch; ch = ch_next) {
@@ -277,7 +270,7 @@ void speech_mtrigger(CharData *actor, const char *str) {
 
                 if (((GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
                      (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str)))) {
-                    ADD_UID_VAR(buf, t, actor, "actor");
+                    ADD_UID_VAR(t, actor, "actor");
                     add_var(&GET_TRIG_VARS(t), "speech", str);
                     script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
                     break;
@@ -289,7 +282,6 @@ void speech_mtrigger(CharData *actor, const char *str) {
 /* ch is the vict from ask/whisper/tell, ie the mob */
 void speech_to_mtrigger(CharData *actor, CharData *ch, const char *str) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!char_susceptible_to_triggers(actor) || !char_susceptible_to_triggers(ch))
         return;
@@ -308,7 +300,7 @@ void speech_to_mtrigger(CharData *actor, CharData *ch, const char *str) {
 
             if ((GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
                 (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str))) {
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 add_var(&GET_TRIG_VARS(t), "speech", str);
                 script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
                 break;
@@ -319,7 +311,6 @@ void speech_to_mtrigger(CharData *actor, CharData *ch, const char *str) {
 void act_mtrigger(const CharData *ch, const char *str, const CharData *actor, const CharData *victim,
                   const ObjData *obj, const ObjData *target, char *arg, char *arg2) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     extern int circle_shutdown;
 
     /* Don't process triggers during shutdown */
@@ -343,13 +334,13 @@ void act_mtrigger(const CharData *ch, const char *str, const CharData *actor, co
                  (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str)))) {
 
                 if (actor)
-                    ADD_UID_VAR(buf, t, actor, "actor");
+                    ADD_UID_VAR(t, actor, "actor");
                 if (victim)
-                    ADD_UID_VAR(buf, t, victim, "victim");
+                    ADD_UID_VAR(t, victim, "victim");
                 if (obj)
-                    ADD_UID_VAR(buf, t, obj, "object");
+                    ADD_UID_VAR(t, obj, "object");
                 if (target)
-                    ADD_UID_VAR(buf, t, target, "target");
+                    ADD_UID_VAR(t, target, "target");
                 if (arg) {
                     skip_spaces(&arg);
                     add_var(&GET_TRIG_VARS(t), "arg", arg);
@@ -367,7 +358,6 @@ void act_mtrigger(const CharData *ch, const char *str, const CharData *actor, co
 
 void fight_mtrigger(CharData *ch) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!MOB_PERFORMS_SCRIPTS(ch) || !SCRIPT_CHECK(ch, MTRIG_FIGHT) || !FIGHTING(ch))
         return;
@@ -375,7 +365,7 @@ void fight_mtrigger(CharData *ch) {
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_FIGHT) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             if (FIGHTING(ch))
-                ADD_UID_VAR(buf, t, FIGHTING(ch), "actor")
+                ADD_UID_VAR(t, FIGHTING(ch), "actor");
             else
                 add_var(&GET_TRIG_VARS(t), "actor", "nobody");
             script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
@@ -386,7 +376,6 @@ void fight_mtrigger(CharData *ch) {
 
 void hitprcnt_mtrigger(CharData *ch) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!MOB_PERFORMS_SCRIPTS(ch) || !SCRIPT_CHECK(ch, MTRIG_HITPRCNT) || !FIGHTING(ch))
         return;
@@ -396,7 +385,7 @@ void hitprcnt_mtrigger(CharData *ch) {
             (((GET_HIT(ch) * 100) / GET_MAX_HIT(ch)) <= GET_TRIG_NARG(t))) {
 
             if (FIGHTING(ch))
-                ADD_UID_VAR(buf, t, FIGHTING(ch), "actor")
+                ADD_UID_VAR(t, FIGHTING(ch), "actor");
             else
                 add_var(&GET_TRIG_VARS(t), "actor", "nobody");
             script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
@@ -407,7 +396,7 @@ void hitprcnt_mtrigger(CharData *ch) {
 
 int receive_mtrigger(CharData *ch, CharData *actor, ObjData *obj) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH], vnum[20];
+    char vnum[20];
     int ret_val = 1;
 
     sprintf(vnum, "%d", GET_OBJ_VNUM(obj));
@@ -424,8 +413,8 @@ int receive_mtrigger(CharData *ch, CharData *actor, ObjData *obj) {
               ((GET_TRIG_ARG(t) && !word_check(vnum, GET_TRIG_ARG(t)) && !GET_TRIG_NARG(t))) ||
               (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t))) {
 
-                  ADD_UID_VAR(buf, t, actor, "actor");
-                  ADD_UID_VAR(buf, t, obj, "object");
+                  ADD_UID_VAR(t, actor, "actor");
+                  ADD_UID_VAR(t, obj, "object");
                   ret_val = script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
                   if (!ret_val)
                       return ret_val;
@@ -438,7 +427,6 @@ int receive_mtrigger(CharData *ch, CharData *actor, ObjData *obj) {
 
 int death_mtrigger(CharData *ch, CharData *actor) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val = 1;
 
     if (!MOB_PERFORMS_SCRIPTS(ch) || !SCRIPT_CHECK(ch, MTRIG_DEATH) ||
@@ -449,7 +437,7 @@ int death_mtrigger(CharData *ch, CharData *actor) {
         if (TRIGGER_CHECK(t, MTRIG_DEATH)) {
 
             if (actor)
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
             ret_val = script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
         }
     }
@@ -482,9 +470,8 @@ int cast_mtrigger(CharData *actor, CharData *ch, int spellnum) {
 
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_CAST) && random_number(1, 100) <= GET_TRIG_NARG(t)) {
-            ADD_UID_VAR(buf, t, actor, "actor");
-            sprintf(buf, "%d", spellnum);
-            add_var(&GET_TRIG_VARS(t), "spellnum", buf);
+            ADD_UID_VAR(t, actor, "actor");
+            add_number_var(&GET_TRIG_VARS(t), "spellnum", spellnum);
             add_var(&GET_TRIG_VARS(t), "spell", skill_name(spellnum));
             return script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
         }
@@ -496,9 +483,8 @@ int cast_mtrigger(CharData *actor, CharData *ch, int spellnum) {
 int leave_mtrigger(CharData *actor, int dir) {
     TrigData *t;
     CharData *ch;
-    char buf[MAX_INPUT_LENGTH];
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_MOB_TRIGGER(IN_ROOM(actor), MTRIG_LEAVE))
         return 1;
 
     for (ch = world[IN_ROOM(actor)].people; ch; ch = ch->next_in_room) {
@@ -511,7 +497,7 @@ int leave_mtrigger(CharData *actor, int dir) {
                     add_var(&GET_TRIG_VARS(t), "direction", dirs[dir]);
                 else
                     add_var(&GET_TRIG_VARS(t), "direction", "none");
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 return script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
             }
         }
@@ -522,9 +508,8 @@ int leave_mtrigger(CharData *actor, int dir) {
 int door_mtrigger(CharData *actor, int subcmd, int dir) {
     TrigData *t;
     CharData *ch;
-    char buf[MAX_INPUT_LENGTH];
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_MOB_TRIGGER(IN_ROOM(actor), MTRIG_DOOR))
         return 1;
 
     for (ch = world[IN_ROOM(actor)].people; ch; ch = ch->next_in_room) {
@@ -536,7 +521,7 @@ int door_mtrigger(CharData *actor, int subcmd, int dir) {
             if (TRIGGER_CHECK(t, MTRIG_DOOR) && random_number(1, 100) <= GET_TRIG_NARG(t)) {
                 add_var(&GET_TRIG_VARS(t), "cmd", cmd_door[subcmd]);
                 add_var(&GET_TRIG_VARS(t), "direction", dirs[dir]);
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 return script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
             }
         }
@@ -547,7 +532,6 @@ int door_mtrigger(CharData *actor, int subcmd, int dir) {
 
 void time_mtrigger(CharData *ch) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     /* This trigger is called if the hour is the same as specified in Narg. */
     if (!MOB_PERFORMS_SCRIPTS(ch) || !SCRIPT_CHECK(ch, MTRIG_TIME) || !char_susceptible_to_triggers(ch))
@@ -555,8 +539,7 @@ void time_mtrigger(CharData *ch) {
 
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_TIME) && (time_info.hours == GET_TRIG_NARG(t))) {
-            sprintf(buf, "%d", time_info.hours);
-            add_var(&GET_TRIG_VARS(t), "time", buf);
+            add_number_var(&GET_TRIG_VARS(t), "time", time_info.hours);
             script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
             break;
         }
@@ -565,7 +548,6 @@ void time_mtrigger(CharData *ch) {
 
 int look_mtrigger(CharData *ch, CharData *actor, const char *str) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val = 1;
 
     if (!MOB_PERFORMS_SCRIPTS(ch) || !char_susceptible_to_triggers(actor) || !SCRIPT_CHECK(ch, MTRIG_LOOK) || !char_susceptible_to_triggers(ch))
@@ -574,7 +556,7 @@ int look_mtrigger(CharData *ch, CharData *actor, const char *str) {
     for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
         if (TRIGGER_CHECK(t, MTRIG_LOOK) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             if (actor)
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
             if (str) {
                 add_var(&GET_TRIG_VARS(t), "arg", str);
             }
@@ -620,16 +602,15 @@ int timer_otrigger(ObjData *obj) {
 
 int get_otrigger(ObjData *obj, CharData *actor, ObjData *cont) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(obj, OTRIG_GET) || !char_susceptible_to_triggers(actor))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_GET) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             if (cont)
-                ADD_UID_VAR(buf, t, cont, "container");
+                ADD_UID_VAR(t, cont, "container");
             /* Don't allow a get to take place, if the object is purged. */
             return (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj);
         }
@@ -641,7 +622,6 @@ int get_otrigger(ObjData *obj, CharData *actor, ObjData *cont) {
 /* checks for command trigger on specific object. assumes obj has cmd trig */
 int cmd_otrig(ObjData *obj, CharData *actor, char *cmd, char *argument, int type) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (obj && SCRIPT_CHECK(obj, OTRIG_COMMAND))
         for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
@@ -657,7 +637,7 @@ int cmd_otrig(ObjData *obj, CharData *actor, char *cmd, char *argument, int type
             if (IS_SET(GET_TRIG_NARG(t), type) &&
                 (*GET_TRIG_ARG(t) == '*' || !strncasecmp(GET_TRIG_ARG(t), cmd, strlen(cmd)))) {
 
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 skip_spaces(&argument);
                 add_var(&GET_TRIG_VARS(t), "arg", argument);
                 skip_spaces(&cmd);
@@ -677,6 +657,10 @@ int command_otrigger(CharData *actor, char *cmd, char *argument) {
     if (!char_susceptible_to_triggers(actor))
         return 1;
 
+    /* The actor's own things are counted in the room too. */
+    if (!ROOM_HAS_OBJ_TRIGGER(IN_ROOM(actor), OTRIG_COMMAND))
+        return 0;
+
     for (i = 0; i < NUM_WEARS; i++)
         if (cmd_otrig(GET_EQ(actor, i), actor, cmd, argument, OCMD_EQUIP))
             return 1;
@@ -693,7 +677,7 @@ int command_otrigger(CharData *actor, char *cmd, char *argument) {
 }
 
 void attack_otrigger(CharData *actor, CharData *victim, int dam) {
-    char buf[MAX_INPUT_LENGTH], dam_str[MAX_INPUT_LENGTH];
+    char dam_str[MAX_INPUT_LENGTH];
     TrigData *t;
     ObjData *obj;
     int i;
@@ -709,8 +693,8 @@ void attack_otrigger(CharData *actor, CharData *victim, int dam) {
             for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
                 if (TRIGGER_CHECK(t, OTRIG_ATTACK) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
                     add_var(&GET_TRIG_VARS(t), "damage", dam_str);
-                    ADD_UID_VAR(buf, t, actor, "actor");
-                    ADD_UID_VAR(buf, t, victim, "victim");
+                    ADD_UID_VAR(t, actor, "actor");
+                    ADD_UID_VAR(t, victim, "victim");
                     script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW);
                     break;
                 }
@@ -721,8 +705,8 @@ void attack_otrigger(CharData *actor, CharData *victim, int dam) {
             for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
                 if (TRIGGER_CHECK(t, OTRIG_DEFEND) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
                     add_var(&GET_TRIG_VARS(t), "damage", dam_str);
-                    ADD_UID_VAR(buf, t, actor, "actor");
-                    ADD_UID_VAR(buf, t, victim, "victim");
+                    ADD_UID_VAR(t, actor, "actor");
+                    ADD_UID_VAR(t, victim, "victim");
                     script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW);
                     break;
                 }
@@ -733,16 +717,14 @@ void attack_otrigger(CharData *actor, CharData *victim, int dam) {
 
 int wear_otrigger(ObjData *obj, CharData *actor, int where) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(obj, OTRIG_WEAR) || !char_susceptible_to_triggers(actor))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_WEAR)) {
-            sprintf(buf, "%d", where);
-            add_var(&GET_TRIG_VARS(t), "position", buf);
-            ADD_UID_VAR(buf, t, actor, "actor");
+            add_number_var(&GET_TRIG_VARS(t), "position", where);
+            ADD_UID_VAR(t, actor, "actor");
             /* Don't allow a wear to take place, if the object is purged. */
             return (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj);
         }
@@ -754,7 +736,6 @@ int wear_otrigger(ObjData *obj, CharData *actor, int where) {
 int death_otrigger(CharData *actor) {
     TrigData *t;
     ObjData *obj;
-    char buf[MAX_INPUT_LENGTH];
     int i;
 
     for (i = 0; i < NUM_WEARS; ++i) {
@@ -762,7 +743,7 @@ int death_otrigger(CharData *actor) {
         if (obj && SCRIPT_CHECK(obj, OTRIG_DEATH)) {
             for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
                 if (TRIGGER_CHECK(t, OTRIG_DEATH)) {
-                    ADD_UID_VAR(buf, t, actor, "actor");
+                    ADD_UID_VAR(t, actor, "actor");
                     return script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW);
                 }
             }
@@ -773,16 +754,15 @@ int death_otrigger(CharData *actor) {
 
 int drop_otrigger(ObjData *obj, CharData *actor, ObjData *target) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!char_susceptible_to_triggers(actor) || !SCRIPT_CHECK(obj, OTRIG_DROP))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_DROP) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             if (target)
-                ADD_UID_VAR(buf, t, target, "target");
+                ADD_UID_VAR(t, target, "target");
             /* Don't allow a drop to take place, if the object is purged. */
             return (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj);
         }
@@ -793,14 +773,13 @@ int drop_otrigger(ObjData *obj, CharData *actor, ObjData *target) {
 
 int remove_otrigger(ObjData *obj, CharData *actor) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!char_susceptible_to_triggers(actor) || !SCRIPT_CHECK(obj, OTRIG_REMOVE))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_REMOVE) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             /* Don't allow a remove to take place, if the object is purged. */
             return (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj);
         }
@@ -811,15 +790,14 @@ int remove_otrigger(ObjData *obj, CharData *actor) {
 
 int give_otrigger(ObjData *obj, CharData *actor, CharData *victim) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!char_susceptible_to_triggers(actor) || !SCRIPT_CHECK(obj, OTRIG_GIVE))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_GIVE) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
-            ADD_UID_VAR(buf, t, victim, "victim");
+            ADD_UID_VAR(t, actor, "actor");
+            ADD_UID_VAR(t, victim, "victim");
             /* Don't allow a give to take place, if the object is purged. */
             return (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj && obj->carried_by == actor);
         }
@@ -844,7 +822,6 @@ void load_otrigger(ObjData *obj) {
 
 int cast_otrigger(CharData *actor, ObjData *obj, int spellnum) {
     TrigData *t;
-    char buf[16];
 
     if (obj == nullptr || !char_susceptible_to_triggers(actor))
         return 1;
@@ -854,9 +831,8 @@ int cast_otrigger(CharData *actor, ObjData *obj, int spellnum) {
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_CAST) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
-            sprintf(buf, "%d", spellnum);
-            add_var(&GET_TRIG_VARS(t), "spellnum", buf);
+            ADD_UID_VAR(t, actor, "actor");
+            add_number_var(&GET_TRIG_VARS(t), "spellnum", spellnum);
             add_var(&GET_TRIG_VARS(t), "spell", skill_name(spellnum));
             return script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW);
         }
@@ -867,11 +843,10 @@ int cast_otrigger(CharData *actor, ObjData *obj, int spellnum) {
 
 int leave_otrigger(RoomData *room, CharData *actor, int dir) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int final = 1;
     ObjData *obj, *obj_next;
 
-    if (!char_susceptible_to_triggers(actor))
+    if (!char_susceptible_to_triggers(actor) || !ROOM_HAS_OBJ_TRIGGER(real_room(room->vnum), OTRIG_LEAVE))
         return 1;
 
     for (obj = room->contents; obj; obj = obj_next) {
@@ -885,7 +860,7 @@ int leave_otrigger(RoomData *room, CharData *actor, int dir) {
                     add_var(&GET_TRIG_VARS(t), "direction", dirs[dir]);
                 else
                     add_var(&GET_TRIG_VARS(t), "direction", "none");
-                ADD_UID_VAR(buf, t, actor, "actor");
+                ADD_UID_VAR(t, actor, "actor");
                 if (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) == 0)
                     ;
                 final = 0;
@@ -898,14 +873,13 @@ int leave_otrigger(RoomData *room, CharData *actor, int dir) {
 
 int consume_otrigger(ObjData *obj, CharData *actor, int cmd) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!char_susceptible_to_triggers(actor) || !SCRIPT_CHECK(obj, OTRIG_CONSUME))
         return 1;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_CONSUME)) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             switch (cmd) {
                 /*
                  * This is kind of a hack, since eat, drink, and quaff
@@ -932,15 +906,13 @@ int consume_otrigger(ObjData *obj, CharData *actor, int cmd) {
 
 void time_otrigger(ObjData *obj) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(obj, OTRIG_TIME))
         return;
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_TIME) && (time_info.hours == GET_TRIG_NARG(t))) {
-            sprintf(buf, "%d", time_info.hours);
-            add_var(&GET_TRIG_VARS(t), "time", buf);
+            add_number_var(&GET_TRIG_VARS(t), "time", time_info.hours);
             script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW);
             break;
         }
@@ -949,7 +921,6 @@ void time_otrigger(ObjData *obj) {
 
 int look_otrigger(ObjData *obj, CharData *actor, char *name, const char *additional_args) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val = 1;
     FindContext context;
     const char *str;
@@ -972,7 +943,7 @@ int look_otrigger(ObjData *obj, CharData *actor, char *name, const char *additio
           (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t)) && isname(str, obj->name)) {
             if (TRIGGER_CHECK(t, OTRIG_LOOK) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
                 if (actor)
-                    ADD_UID_VAR(buf, t, actor, "actor");
+                    ADD_UID_VAR(t, actor, "actor");
                 if (additional_args)
                     add_var(&GET_TRIG_VARS(t), "arg", additional_args);
 
@@ -990,7 +961,6 @@ int look_otrigger(ObjData *obj, CharData *actor, char *name, const char *additio
 
 int use_otrigger(ObjData *obj, ObjData *tobj, CharData *actor, CharData *victim) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val = 1;
 
 
@@ -1004,11 +974,11 @@ int use_otrigger(ObjData *obj, ObjData *tobj, CharData *actor, CharData *victim)
 
     for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
         if (TRIGGER_CHECK(t, OTRIG_USE) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             if (tobj && (obj != tobj))
-                ADD_UID_VAR(buf, t, tobj, "object");
+                ADD_UID_VAR(t, tobj, "object");
             if (victim && (victim != actor))
-                ADD_UID_VAR(buf, t, victim, "victim");
+                ADD_UID_VAR(t, victim, "victim");
             ret_val = (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW) && obj);
             if (!ret_val)
                 return ret_val;
@@ -1038,7 +1008,6 @@ void random_wtrigger(RoomData *room) {
 
 int preentry_wtrigger(RoomData *room, CharData *actor, int dir) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int rev_dir[] = {SOUTH, WEST, NORTH, EAST, DOWN, UP};
 
     if (!SCRIPT_CHECK(room, WTRIG_PREENTRY) || !char_susceptible_to_triggers(actor))
@@ -1047,7 +1016,7 @@ int preentry_wtrigger(RoomData *room, CharData *actor, int dir) {
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
         if (TRIGGER_CHECK(t, WTRIG_PREENTRY) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             add_var(&GET_TRIG_VARS(t), "direction", dirs[rev_dir[dir]]);
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
         }
     }
@@ -1057,7 +1026,6 @@ int preentry_wtrigger(RoomData *room, CharData *actor, int dir) {
 
 int postentry_wtrigger(CharData *actor, int dir) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int rev_dir[] = {SOUTH, WEST, NORTH, EAST, DOWN, UP};
     struct RoomData *room = &world[IN_ROOM(actor)];
 
@@ -1067,7 +1035,7 @@ int postentry_wtrigger(CharData *actor, int dir) {
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
         if (TRIGGER_CHECK(t, WTRIG_POSTENTRY) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             add_var(&GET_TRIG_VARS(t), "direction", dirs[rev_dir[dir]]);
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
         }
     }
@@ -1092,7 +1060,6 @@ void reset_wtrigger(RoomData *room) {
 int command_wtrigger(CharData *actor, char *cmd, char *argument) {
     RoomData *room;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_COMMAND) || !char_susceptible_to_triggers(actor))
         return 0;
@@ -1108,7 +1075,7 @@ int command_wtrigger(CharData *actor, char *cmd, char *argument) {
         }
 
         if (*GET_TRIG_ARG(t) == '*' || !strncasecmp(GET_TRIG_ARG(t), cmd, strlen(cmd))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             skip_spaces(&argument);
             add_var(&GET_TRIG_VARS(t), "arg", argument);
             skip_spaces(&cmd);
@@ -1123,7 +1090,6 @@ int command_wtrigger(CharData *actor, char *cmd, char *argument) {
 void speech_wtrigger(CharData *actor, const char *str) {
     RoomData *room;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_SPEECH) || !char_susceptible_to_triggers(actor))
         return;
@@ -1140,7 +1106,7 @@ void speech_wtrigger(CharData *actor, const char *str) {
 
         if (((GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
              (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str)))) {
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             add_var(&GET_TRIG_VARS(t), "speech", str);
             script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
             break;
@@ -1151,7 +1117,6 @@ void speech_wtrigger(CharData *actor, const char *str) {
 int drop_wtrigger(ObjData *obj, CharData *actor) {
     RoomData *room;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
     int ret_val;
 
     if (!SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_DROP) || !char_susceptible_to_triggers(actor))
@@ -1161,8 +1126,8 @@ int drop_wtrigger(ObjData *obj, CharData *actor) {
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next)
         if (TRIGGER_CHECK(t, WTRIG_DROP) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
 
-            ADD_UID_VAR(buf, t, actor, "actor");
-            ADD_UID_VAR(buf, t, obj, "object");
+            ADD_UID_VAR(t, actor, "actor");
+            ADD_UID_VAR(t, obj, "object");
             ret_val = script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
             if (obj->carried_by != actor)
                 return 0;
@@ -1176,7 +1141,6 @@ int drop_wtrigger(ObjData *obj, CharData *actor) {
 int cast_wtrigger(CharData *actor, CharData *vict, ObjData *obj, int spellnum) {
     RoomData *room;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_CAST) || !char_susceptible_to_triggers(actor))
         return 1;
@@ -1185,13 +1149,12 @@ int cast_wtrigger(CharData *actor, CharData *vict, ObjData *obj, int spellnum) {
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
         if (TRIGGER_CHECK(t, WTRIG_CAST) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
 
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             if (vict)
-                ADD_UID_VAR(buf, t, vict, "victim");
+                ADD_UID_VAR(t, vict, "victim");
             if (obj)
-                ADD_UID_VAR(buf, t, obj, "object");
-            sprintf(buf, "%d", spellnum);
-            add_var(&GET_TRIG_VARS(t), "spellnum", buf);
+                ADD_UID_VAR(t, obj, "object");
+            add_number_var(&GET_TRIG_VARS(t), "spellnum", spellnum);
             add_var(&GET_TRIG_VARS(t), "spell", skill_name(spellnum));
             return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
         }
@@ -1202,7 +1165,6 @@ int cast_wtrigger(CharData *actor, CharData *vict, ObjData *obj, int spellnum) {
 
 int leave_wtrigger(RoomData *room, CharData *actor, int dir) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(room, WTRIG_LEAVE) || !char_susceptible_to_triggers(actor))
         return 1;
@@ -1210,7 +1172,7 @@ int leave_wtrigger(RoomData *room, CharData *actor, int dir) {
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
         if (TRIGGER_CHECK(t, WTRIG_LEAVE) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             add_var(&GET_TRIG_VARS(t), "direction", dirs[dir]);
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
         }
     }
@@ -1221,7 +1183,6 @@ int leave_wtrigger(RoomData *room, CharData *actor, int dir) {
 int door_wtrigger(CharData *actor, int subcmd, int dir) {
     RoomData *room;
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_DOOR) || !char_susceptible_to_triggers(actor))
         return 1;
@@ -1231,7 +1192,7 @@ int door_wtrigger(CharData *actor, int subcmd, int dir) {
         if (TRIGGER_CHECK(t, WTRIG_DOOR) && (random_number(1, 100) <= GET_TRIG_NARG(t))) {
             add_var(&GET_TRIG_VARS(t), "cmd", cmd_door[subcmd]);
             add_var(&GET_TRIG_VARS(t), "direction", (char *)dirs[dir]);
-            ADD_UID_VAR(buf, t, actor, "actor");
+            ADD_UID_VAR(t, actor, "actor");
             return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
         }
     }
@@ -1241,15 +1202,13 @@ int door_wtrigger(CharData *actor, int subcmd, int dir) {
 
 void time_wtrigger(RoomData *room) {
     TrigData *t;
-    char buf[MAX_INPUT_LENGTH];
 
     if (!SCRIPT_CHECK(room, WTRIG_TIME))
         return;
 
     for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
         if (TRIGGER_CHECK(t, WTRIG_TIME) && (time_info.hours == GET_TRIG_NARG(t))) {
-            sprintf(buf, "%d", time_info.hours);
-            add_var(&GET_TRIG_VARS(t), "time", buf);
+            add_number_var(&GET_TRIG_VARS(t), "time", time_info.hours);
             script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
             break;
         }
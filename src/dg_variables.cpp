@@ -0,0 +1,314 @@
+/***************************************************************************
+ *   File: dg_variables.c                                 Part of FieryMUD *
+ *  Usage: trigger and script variables                                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "dg_variables.hpp"
+
+#include "utils.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#define SCRIPT_VARS_LINEAR 8 /* tables this small have no index */
+#define SCRIPT_VARS_MIN 4    /* initial number of variables */
+
+/* Names are hashed and compared ignoring case, so a name needn't be folded to be looked up. */
+struct ScriptNameHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view name) const {
+        std::size_t hash = 14695981039346656037ULL; /* FNV-1a */
+
+        for (char c : name)
+            hash = (hash ^ (unsigned char)tolower(c)) * 1099511628211ULL;
+        return hash;
+    }
+};
+
+struct ScriptNameEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a.size() == b.size() && !strncasecmp(a.data(), b.data(), a.size());
+    }
+};
+
+/*
+ * Every variable name some table holds, lowercased, with the number of
+ * tables holding it.  Names built by scripts, like visited_%actor.id%,
+ * come and go, so a name is freed when the last table lets go of it.
+ */
+static std::unordered_map<std::string, unsigned, ScriptNameHash, ScriptNameEqual> script_names;
+static std::size_t script_names_bytes = 0;
+
+const char *intern_script_name(const char *name) {
+    auto it = script_names.find(std::string_view(name));
+
+    if (it == script_names.end()) {
+        std::string folded(name);
+
+        for (char &c : folded)
+            c = tolower(c);
+        script_names_bytes += folded.size() + 1;
+        it = script_names.emplace(std::move(folded), 0).first;
+    }
+    ++it->second;
+    return it->first.c_str();
+}
+
+void release_script_name(const char *name) {
+    auto it = script_names.find(std::string_view(name));
+
+    if (it != script_names.end() && !--it->second) {
+        script_names_bytes -= it->first.size() + 1;
+        script_names.erase(it);
+    }
+}
+
+const char *find_script_name(const char *name) {
+    auto it = script_names.find(std::string_view(name));
+
+    return it == script_names.end() ? nullptr : it->first.c_str();
+}
+
+std::size_t script_names_memory(void) { return script_names_bytes; }
+
+/* Whether text is a number that prints back as exactly text. */
+static bool read_number(const char *text, long *number) {
+    const char *p = text, *digits;
+
+    if (*p == '-')
+        p++;
+    if (!isdigit(*p) || (*p == '0' && (p[1] || p != text)))
+        return false;
+    for (digits = p; *p; p++)
+        if (!isdigit(*p))
+            return false;
+    if (p - digits > 18)
+        return false;
+
+    *number = strtol(text, nullptr, 10);
+    return true;
+}
+
+char *ScriptVariable::text(char *buf) const {
+    switch (type) {
+    case ScriptVarType::Number:
+        sprintf(buf, "%ld", number);
+        break;
+    case ScriptVarType::Uid:
+        sprintf(buf, "%c%ld", UID_CHAR, number);
+        break;
+    default:
+        strcpy(buf, string);
+        break;
+    }
+    return buf;
+}
+
+ScriptVariables::~ScriptVariables() {
+    std::size_t i;
+
+    for (i = 0; i < size_; i++) {
+        release_script_name(vars_[i].name);
+        free(vars_[i].string);
+    }
+    free(vars_);
+    free(index_);
+}
+
+/* Names are interned strings, so hash their addresses. */
+std::size_t ScriptVariables::home(const char *name) const {
+    return (std::size_t)(((std::uint64_t)(std::uintptr_t)name * 0x9e3779b97f4a7c15ULL) >> 32) & (index_capacity_ - 1);
+}
+
+void ScriptVariables::index(std::size_t position) {
+    std::size_t i;
+
+    for (i = home(vars_[position].name); index_[i]; i = (i + 1) & (index_capacity_ - 1))
+        ;
+    index_[i] = position + 1;
+}
+
+void ScriptVariables::reindex() {
+    std::size_t i;
+
+    free(index_);
+    index_ = nullptr;
+    index_capacity_ = 0;
+    if (size_ <= SCRIPT_VARS_LINEAR)
+        return;
+
+    for (index_capacity_ = SCRIPT_VARS_LINEAR * 4; index_capacity_ < size_ * 4; index_capacity_ *= 2)
+        ;
+    CREATE(index_, unsigned, index_capacity_);
+    for (i = 0; i < size_; i++)
+        index(i);
+}
+
+ScriptVariable *ScriptVariables::find_interned(const char *name) const {
+    std::size_t i;
+
+    if (!index_) {
+        for (i = 0; i < size_; i++)
+            if (vars_[i].name == name)
+                return &vars_[i];
+        return nullptr;
+    }
+
+    for (i = home(name); index_[i]; i = (i + 1) & (index_capacity_ - 1))
+        if (vars_[index_[i] - 1].name == name)
+            return &vars_[index_[i] - 1];
+    return nullptr;
+}
+
+ScriptVariable *ScriptVariables::find(const char *name) const {
+    const char *interned = find_script_name(name);
+
+    return interned ? find_interned(interned) : nullptr;
+}
+
+/* The variable called name, new or with its old value freed. */
+ScriptVariable *ScriptVariables::add(const char *name) {
+    ScriptVariable *var;
+
+    if ((var = find(name))) {
+        free(var->string);
+        var->string = nullptr;
+        return var;
+    }
+
+    if (size_ == capacity_) {
+        capacity_ = capacity_ ? capacity_ * 2 : SCRIPT_VARS_MIN;
+        RECREATE(vars_, ScriptVariable, capacity_);
+    }
+    var = &vars_[size_++];
+    var->name = intern_script_name(name);
+    var->string = nullptr;
+
+    /* Keep the index at most half full. */
+    if (size_ * 2 > index_capacity_)
+        reindex();
+    else
+        index(size_ - 1);
+
+    return var;
+}
+
+void ScriptVariables::set(const char *name, const char *value) {
+    ScriptVariable *var = add(name);
+
+    if (*value == UID_CHAR && *(value + 1) != '-' && read_number(value + 1, &var->number))
+        var->type = ScriptVarType::Uid;
+    else if (read_number(value, &var->number))
+        var->type = ScriptVarType::Number;
+    else {
+        var->type = ScriptVarType::String;
+        var->string = strdup(value);
+    }
+}
+
+void ScriptVariables::set_number(const char *name, long number) {
+    ScriptVariable *var = add(name);
+
+    var->type = ScriptVarType::Number;
+    var->number = number;
+}
+
+void ScriptVariables::set_uid(const char *name, long id) {
+    ScriptVariable *var = add(name);
+
+    var->type = ScriptVarType::Uid;
+    var->number = id;
+}
+
+void ScriptVariables::set(const ScriptVariable &from) {
+    ScriptVariable *var = add(from.name);
+
+    var->type = from.type;
+    var->number = from.number;
+    if (from.string)
+        var->string = strdup(from.string);
+}
+
+bool ScriptVariables::remove(const char *name) {
+    ScriptVariable *var = find(name);
+    std::size_t position;
+
+    if (!var)
+        return false;
+
+    release_script_name(var->name);
+    free(var->string);
+    position = var - vars_;
+    memmove(var, var + 1, (size_ - position - 1) * sizeof(ScriptVariable));
+    size_--;
+    if (index_)
+        reindex();
+
+    return true;
+}
+
+std::size_t ScriptVariables::memory() const {
+    std::size_t bytes = sizeof(*this) + capacity_ * sizeof(ScriptVariable) + index_capacity_ * sizeof(unsigned), i;
+
+    for (i = 0; i < size_; i++)
+        if (vars_[i].string)
+            bytes += strlen(vars_[i].string) + 1;
+    return bytes;
+}
+
+/* adds a variable with given name and value to trigger */
+void add_var(ScriptVariables **var_list, const char *name, const char *value) {
+    if (!*var_list)
+        *var_list = new ScriptVariables;
+    (*var_list)->set(name, value);
+}
+
+void add_number_var(ScriptVariables **var_list, const char *name, long number) {
+    if (!*var_list)
+        *var_list = new ScriptVariables;
+    (*var_list)->set_number(name, number);
+}
+
+void add_uid_var(ScriptVariables **var_list, const char *name, long id) {
+    if (!*var_list)
+        *var_list = new ScriptVariables;
+    (*var_list)->set_uid(name, id);
+}
+
+/*
+ * remove var name from var_list
+ * returns 1 if found, else 0
+ */
+int remove_var(ScriptVariables **var_list, const char *name) {
+    if (!*var_list || !(*var_list)->remove(name))
+        return 0;
+
+    if (!(*var_list)->size()) {
+        delete *var_list;
+        *var_list = nullptr;
+    }
+    return 1;
+}
+
+ScriptVariable *find_var(const ScriptVariables *var_list, const char *name) {
+    return var_list ? var_list->find(name) : nullptr;
+}
+
+/* release memory allocated for a variable list */
+void free_varlist(ScriptVariables *var_list) { delete var_list; }
+
+std::size_t varlist_memory(const ScriptVariables *var_list) { return var_list ? var_list->memory() : 0; }
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   File: dg_variables.h                                 Part of FieryMUD *
+ *  Usage: header file: trigger and script variables                       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#define UID_CHAR '\005'
+
+/* What a variable holds.  Scripts only ever see text. */
+enum class ScriptVarType : unsigned char {
+    String,
+    Number, /* text that reads back as the same number */
+    Uid,    /* UID_CHAR followed by an id */
+};
+
+struct ScriptVariable {
+    const char *name; /* held from intern_script_name(): lowercase, compared by address */
+    ScriptVarType type;
+    long number;  /* a Number, or the id of a Uid */
+    char *string; /* a String */
+
+    /* Writes the value as scripts see it into buf, and returns buf. */
+    char *text(char *buf) const;
+};
+
+/*
+ * The local variables of a trigger, or the global variables of a
+ * script.  Names are interned, so finding a variable compares
+ * pointers: a handful of variables are just searched in order, and
+ * bigger tables get a hash index on the name as well.  Variables stay
+ * in the order they were first set.
+ */
+class ScriptVariables {
+  public:
+    ScriptVariables() = default;
+    ~ScriptVariables();
+    ScriptVariables(const ScriptVariables &) = delete;
+    ScriptVariables &operator=(const ScriptVariables &) = delete;
+
+    /* nullptr if there's no such variable */
+    ScriptVariable *find(const char *name) const;
+    /* Values that look like numbers or UIDs are stored as such. */
+    void set(const char *name, const char *value);
+    void set_number(const char *name, long number);
+    void set_uid(const char *name, long id);
+    /* A copy of var, under var's name. */
+    void set(const ScriptVariable &var);
+    bool remove(const char *name);
+
+    std::size_t size() const { return size_; }
+    /* Bytes allocated for the table and its strings; names are shared. */
+    std::size_t memory() const;
+
+    const ScriptVariable *begin() const { return vars_; }
+    const ScriptVariable *end() const { return vars_ + size_; }
+
+  private:
+    ScriptVariable *find_interned(const char *name) const;
+    ScriptVariable *add(const char *name);
+    std::size_t home(const char *name) const;
+    void index(std::size_t position);
+    void reindex();
+
+    ScriptVariable *vars_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+    unsigned *index_ = nullptr;      /* positions in vars_ plus one, 0 for a free slot */
+    std::size_t index_capacity_ = 0; /* a power of two, or 0 if there's no index */
+};
+
+/* A name is kept until each intern_script_name() of it is released. */
+const char *intern_script_name(const char *name);
+void release_script_name(const char *name);
+/* nullptr if no table holds name */
+const char *find_script_name(const char *name);
+std::size_t script_names_memory(void);
+
+/*
+ * The variable lists hung off triggers and scripts are nullptr until
+ * something is set in them, and go back to nullptr when emptied.
+ */
+void add_var(ScriptVariables **var_list, const char *name, const char *value);
+void add_number_var(ScriptVariables **var_list, const char *name, long number);
+void add_uid_var(ScriptVariables **var_list, const char *name, long id);
+int remove_var(ScriptVariables **var_list, const char *name);
+ScriptVariable *find_var(const ScriptVariables *var_list, const char *name);
+void free_varlist(ScriptVariables *var_list);
+std::size_t varlist_memory(const ScriptVariables *var_list);
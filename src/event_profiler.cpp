@@ -0,0 +1,126 @@
+/***************************************************************************
+ *   File: event_profiler.c                               Part of FieryMUD *
+ *  Usage: counting and timing events by type                              *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "event_profiler.hpp"
+
+#include "events.hpp"
+#include "latency_histogram.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fmt/format.h>
+
+using namespace std::chrono;
+
+/* Lateness in microseconds, handler time in nanoseconds. */
+struct EventTypeStats {
+    std::uint64_t scheduled;
+    std::uint64_t fired;
+    std::uint64_t cancelled;
+    std::uint64_t late_total;
+    std::uint64_t late_max;
+    std::uint64_t handler_total;
+    LatencyHistogram handler;
+};
+
+static EventTypeStats event_stats[MAX_EVENT];
+
+static steady_clock::time_point pulse_due; /* when the pulse being processed was due */
+static long pulse_peak;                    /* the deepest the queue has been this pulse */
+static long recent_peaks[EVENT_PROFILE_HISTORY];
+static std::uint64_t pulses;
+static long max_peak;
+
+/* Events of unknown type are counted as type 0. */
+static EventTypeStats &stats_of(int type) { return event_stats[type > 0 && type < MAX_EVENT ? type : 0]; }
+
+void event_profile_pulse(steady_clock::time_point due, long queue_depth) {
+    if (pulses)
+        recent_peaks[(pulses - 1) % EVENT_PROFILE_HISTORY] = pulse_peak;
+    ++pulses;
+    pulse_due = due;
+    pulse_peak = queue_depth;
+    max_peak = std::max(max_peak, queue_depth);
+}
+
+void event_profile_scheduled(int type, long queue_depth) {
+    ++stats_of(type).scheduled;
+    pulse_peak = std::max(pulse_peak, queue_depth);
+    max_peak = std::max(max_peak, queue_depth);
+}
+
+void event_profile_cancelled(int type) { ++stats_of(type).cancelled; }
+
+void event_profile_fired(int type, steady_clock::time_point start, steady_clock::time_point end) {
+    EventTypeStats &stats = stats_of(type);
+    std::uint64_t late = std::max<std::int64_t>(duration_cast<microseconds>(start - pulse_due).count(), 0);
+    std::uint64_t took = std::max<std::int64_t>(duration_cast<nanoseconds>(end - start).count(), 0);
+
+    ++stats.fired;
+    stats.late_total += late;
+    stats.late_max = std::max(stats.late_max, late);
+    stats.handler_total += took;
+    stats.handler.record(nanoseconds(took));
+}
+
+void event_profile_reset(void) {
+    for (auto &stats : event_stats) {
+        stats.scheduled = stats.fired = stats.cancelled = 0;
+        stats.late_total = stats.late_max = stats.handler_total = 0;
+        stats.handler.clear();
+    }
+    std::fill(std::begin(recent_peaks), std::end(recent_peaks), 0);
+    pulses = 0;
+    pulse_peak = max_peak = 0;
+}
+
+std::string event_profile_report(void) {
+    extern const char *eventnames[];
+    std::string report = fmt::format("{:<17} {:>9} {:>9} {:>9} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}\n", "Event",
+                                      "Scheduled", "Fired", "Cancelled", "Late avg", "Late max", "Avg us", "P99 us",
+                                      "Max us", "Total s");
+    long recent_max = 0;
+    int i, recent;
+
+    for (i = 0; i < MAX_EVENT; ++i) {
+        const EventTypeStats &stats = event_stats[i];
+
+        if (!stats.scheduled && !stats.fired && !stats.cancelled)
+            continue;
+        report += fmt::format("{:<17} {:>9} {:>9} {:>9} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f}\n",
+                              eventnames[i], stats.scheduled, stats.fired, stats.cancelled,
+                              stats.fired ? stats.late_total / 1000.0 / stats.fired : 0.0, stats.late_max / 1000.0,
+                              stats.fired ? stats.handler_total / 1000.0 / stats.fired : 0.0,
+                              stats.handler.percentile(0.99).count() / 1000.0, stats.handler.max().count() / 1000.0,
+                              stats.handler_total / 1e9);
+    }
+
+    recent = std::min<std::uint64_t>(pulses ? pulses - 1 : 0, EVENT_PROFILE_HISTORY);
+    for (i = 0; i < recent; ++i)
+        recent_max = std::max(recent_max, recent_peaks[i]);
+    report += fmt::format("Late times are in ms.  Queue depth: {} at most, {} at most in the last {} pulses.\n",
+                          max_peak, recent_max, recent);
+
+    return report;
+}
+
+void event_profile_log_report(void) {
+    std::string report = event_profile_report();
+    std::string::size_type start = 0, end;
+
+    log("Event profile:");
+    while ((end = report.find('\n', start)) != std::string::npos) {
+        log("{}", report.substr(start, end - start));
+        start = end + 1;
+    }
+}
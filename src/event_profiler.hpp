@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   File: event_profiler.h                               Part of FieryMUD *
+ *  Usage: header file: counting and timing events by type                 *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#define EVENT_PROFILE_HISTORY 100                             /* recent pulses whose queue depth is kept */
+#define EVENT_PROFILE_LOG_INTERVAL (60 * 60 * PASSES_PER_SEC) /* how often heartbeat() logs the profile */
+
+/*
+ * For each EVENT_* type: how many were scheduled (created or re-queued
+ * by their handler), fired and cancelled, how long after their pulse was
+ * due they fired, and how long their handlers took.  Also the deepest
+ * the event queue got in each pulse.
+ */
+
+/* The pulse about to be processed was due at this time, and starts with this many events queued. */
+void event_profile_pulse(std::chrono::steady_clock::time_point due, long queue_depth);
+void event_profile_scheduled(int type, long queue_depth);
+void event_profile_cancelled(int type);
+/* A handler ran from start to end. */
+void event_profile_fired(int type, std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::time_point end);
+void event_profile_reset(void);
+/* A table of the statistics of every type of event seen, one line per type. */
+std::string event_profile_report(void);
+/* Write event_profile_report() to the log. */
+void event_profile_log_report(void);
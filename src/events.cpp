@@ -16,6 +16,7 @@
 #include "constants.hpp"
 #include "db.hpp"
 #include "dg_scripts.hpp"
+#include "event_profiler.hpp"
 #include "fight.hpp"
 #include "handler.hpp"
 #include "interpreter.hpp"
@@ -30,6 +31,9 @@
 #include "sysdep.hpp"
 #include "utils.hpp"
 
+#include <chrono>
+#include <cstddef>
+
 Queue *event_q; /* the event queue */
 int processing_events = false;
 
@@ -70,20 +74,13 @@ const char *eventnames[MAX_EVENT + 1] = {"!INVALID EVENT!", /* 0 - reserved */
 /*                        EVENT UTILITY FUNCTIONS                        */
 /*************************************************************************/
 
-bool char_has_event(CharData *ch, int eventtype) {
-    Event *e;
-
-    for (e = ch->events; e; e = e->next)
-        if (e->num == eventtype)
-            return true;
-    return false;
-}
+bool char_has_event(CharData *ch, int eventtype) { return find_event(&ch->events, eventtype) != nullptr; }
 
 bool char_has_delayed_command(CharData *ch, const char *command) {
     Event *e;
 
-    for (e = ch->events; e; e = e->next)
-        if (e->num == EVENT_COMMAND && e->event_obj && !strcasecmp(command, ((CommandEventData *)(e->event_obj))->cmd))
+    for (e = find_event(&ch->events, EVENT_COMMAND); e; e = e->next_of_type)
+        if (e->event_obj && !strcasecmp(command, ((CommandEventData *)(e->event_obj))->cmd))
             return true;
     return false;
 }
@@ -266,7 +263,7 @@ EVENTFUNC(extract_event) {
 void sethurtevent(CharData *ch, CharData *vict, int dam) {
     HurtEventData *he;
 
-    CREATE(he, HurtEventData, 1);
+    CREATE_EVENT_OBJ(he, HurtEventData);
     he->victim = vict;
     he->attacker = ch;
     he->damage = dam;
@@ -352,7 +349,7 @@ void delayed_command(CharData *ch, char *command, int delay, bool repeatable) {
     if (!repeatable && char_has_delayed_command(ch, command))
         return;
 
-    CREATE(ce, CommandEventData, 1);
+    CREATE_EVENT_OBJ(ce, CommandEventData);
     ce->ch = ch;
     ce->cmd = strdup(command);
     event_create(EVENT_COMMAND, command_event, ce, true, &(ch->events), delay);
@@ -360,7 +357,7 @@ void delayed_command(CharData *ch, char *command, int delay, bool repeatable) {
 
 void free_command_event_data(void *e) {
     free(((CommandEventData *)e)->cmd);
-    free(e);
+    event_release(e);
 }
 
 EVENTFUNC(command_event) {
@@ -371,6 +368,109 @@ EVENTFUNC(command_event) {
     return EVENT_FINISHED;
 }
 
+/*************************************************************************/
+/*                            EVENT MEMORY                               */
+/*************************************************************************/
+
+/* Every block starts with this; the caller's memory follows it. */
+struct EventBlock {
+    EventBlock *next; /* on a free list, or the next slab */
+    int size_class;   /* index into event_pool, or EVENT_POOL_CLASSES if calloc'd */
+};
+
+static_assert(sizeof(EventBlock) % alignof(std::max_align_t) == 0, "event_alloc() must return aligned memory");
+
+static struct {
+    EventBlock *free;   /* released blocks of this size */
+    char *unused, *end; /* the part of the newest slab not yet handed out */
+} event_pool[EVENT_POOL_CLASSES];
+
+static EventBlock *event_slabs; /* every slab, through next */
+static EventPoolStats pool_stats;
+
+void *event_alloc(size_t size) {
+    EventBlock *block, *slab;
+    int size_class;
+    size_t block_size;
+
+    pool_stats.allocations++;
+    pool_stats.in_use++;
+
+    if (size > EVENT_POOL_MAX) {
+        pool_stats.large++;
+        block = (EventBlock *)calloc(1, sizeof(EventBlock) + size);
+        if (!block) {
+            perror("malloc failure");
+            abort();
+        }
+        block->size_class = EVENT_POOL_CLASSES;
+        return block + 1;
+    }
+
+    size_class = size ? (size - 1) / EVENT_POOL_GRAIN : 0;
+    block_size = sizeof(EventBlock) + (size_class + 1) * EVENT_POOL_GRAIN;
+    auto &pool = event_pool[size_class];
+
+    if (pool.free) {
+        block = pool.free;
+        pool.free = block->next;
+        pool_stats.reuses++;
+    } else {
+        if ((size_t)(pool.end - pool.unused) < block_size) {
+            /* The first block of each slab links the slabs together. */
+            if (!(slab = (EventBlock *)malloc(EVENT_SLAB_SIZE))) {
+                perror("malloc failure");
+                abort();
+            }
+            slab->next = event_slabs;
+            event_slabs = slab;
+            pool_stats.slabs++;
+            pool.unused = (char *)(slab + 1);
+            pool.end = (char *)slab + EVENT_SLAB_SIZE;
+        }
+        block = (EventBlock *)pool.unused;
+        pool.unused += block_size;
+    }
+
+    block->next = nullptr;
+    block->size_class = size_class;
+    memset(block + 1, 0, block_size - sizeof(EventBlock));
+    return block + 1;
+}
+
+void event_release(void *ptr) {
+    EventBlock *block;
+
+    if (!ptr)
+        return;
+
+    block = (EventBlock *)ptr - 1;
+    pool_stats.in_use--;
+
+    if (block->size_class == EVENT_POOL_CLASSES) {
+        pool_stats.large--;
+        free(block);
+        return;
+    }
+
+    block->next = event_pool[block->size_class].free;
+    event_pool[block->size_class].free = block;
+}
+
+const EventPoolStats &event_pool_stats(void) { return pool_stats; }
+
+/* Gives all slabs back; nothing may still be using them. */
+static void event_pool_free(void) {
+    EventBlock *slab, *next_slab;
+
+    for (slab = event_slabs; slab; slab = next_slab) {
+        next_slab = slab->next;
+        free(slab);
+    }
+    event_slabs = nullptr;
+    memset(event_pool, 0, sizeof(event_pool));
+}
+
 /*************************************************************************/
 /*                         EVENT INFRASTRUCTURE                          */
 /*************************************************************************/
@@ -378,24 +478,61 @@ EVENTFUNC(command_event) {
 /* initializes the event queue */
 void event_init(void) { event_q = queue_init(); }
 
+/* Puts the event at the front of list, and of its type's chain in the list's index. */
+static void event_link(Event *event, EventList *list) {
+    event->eventlist = list;
+
+    event->prev = nullptr;
+    if ((event->next = list->head))
+        event->next->prev = event;
+    list->head = event;
+
+    if (!list->by_type)
+        CREATE(list->by_type, Event *, MAX_EVENT);
+    event->prev_of_type = nullptr;
+    if ((event->next_of_type = list->by_type[event->num]))
+        event->next_of_type->prev_of_type = event;
+    list->by_type[event->num] = event;
+}
+
+/* Takes the event out of its list. */
+static void event_unlink(Event *event) {
+    EventList *list = event->eventlist;
+
+    if (event->prev)
+        event->prev->next = event->next;
+    else
+        list->head = event->next;
+    if (event->next)
+        event->next->prev = event->prev;
+
+    if (event->prev_of_type)
+        event->prev_of_type->next_of_type = event->next_of_type;
+    else
+        list->by_type[event->num] = event->next_of_type;
+    if (event->next_of_type)
+        event->next_of_type->prev_of_type = event->prev_of_type;
+
+    event->eventlist = nullptr;
+    event->next = event->prev = nullptr;
+    event->next_of_type = event->prev_of_type = nullptr;
+}
+
 /* creates an event and returns it */
-Event *event_create(int eventnum, EVENTFUNC(*func), void *event_obj, bool free_obj, Event **list, long when) {
+Event *event_create(int eventnum, EVENTFUNC(*func), void *event_obj, bool free_obj, EventList *list, long when) {
     Event *new_event;
 
-    CREATE(new_event, Event, 1);
+    CREATE_EVENT_OBJ(new_event, Event);
     new_event->num = eventnum;
     new_event->func = func;
     new_event->event_obj = event_obj;
     new_event->free_obj = free_obj;
     new_event->q_el = queue_enq(event_q, new_event, when + pulse);
+    event_profile_scheduled(eventnum, event_q->size);
 
     /* Add this event to the provided event list (if any) */
-    if (list) {
-        new_event->eventlist = list;
-        if (*list)
-            new_event->next = *list;
-        *list = new_event;
-    }
+    if (list)
+        event_link(new_event, list);
 
     return new_event;
 }
@@ -406,15 +543,13 @@ void free_event_obj(Event *event) {
         if (event->num == EVENT_COMMAND)
             free_command_event_data(event->event_obj);
         else
-            free(event->event_obj);
+            event_release(event->event_obj);
         event->event_obj = nullptr;
     }
 }
 
 /* removes the event from the system */
 void event_cancel(Event *event) {
-    Event *temp;
-
     if (!event) {
         log("SYSERR:  Attempted to cancel a NULL event");
         return;
@@ -423,30 +558,34 @@ void event_cancel(Event *event) {
     if (event->num == EVENT_GRAVITY)
         printf("DELETING GRAVITY EVENT\n");
     queue_deq(event_q, event->q_el);
+    event_profile_cancelled(event->num);
 
     /* Remove it from its event list (if any) */
-    if (event->eventlist) {
-        REMOVE_FROM_LIST(event, *(event->eventlist), next);
-    }
+    if (event->eventlist)
+        event_unlink(event);
 
     if (event->free_obj && event->event_obj)
         free_event_obj(event);
-    free(event);
+    event_release(event);
 }
 
+/* returns the newest event of a type in the list, if any */
+Event *find_event(EventList *list, int eventtype) { return list->by_type ? list->by_type[eventtype] : nullptr; }
+
 /* removes an event based on type */
-void cancel_event(Event *eventlist, int eventtype) {
-    while (eventlist && eventlist->num != eventtype)
-        eventlist = eventlist->next;
-    if (eventlist)
-        event_cancel(eventlist);
+void cancel_event(EventList *list, int eventtype) {
+    Event *event;
+
+    if ((event = find_event(list, eventtype)))
+        event_cancel(event);
 }
 
 /* Process any events whose time has come. */
 void event_process(void) {
-    Event *the_event, *temp;
-    Event **list;
+    Event *the_event;
+    EventList *list;
     long new_time;
+    std::chrono::steady_clock::time_point start;
 
     while ((long)pulse >= queue_key(event_q)) {
         if (!(the_event = (Event *)queue_head(event_q))) {
@@ -458,27 +597,24 @@ void event_process(void) {
          * Then the event will not be in any list during its execution, which
          * occurs next. Therefore, the object/character whose list this event
          * is in may be destroyed during the event without adverse consequences. */
-        if (the_event->eventlist) {
-            list = the_event->eventlist;
-            REMOVE_FROM_LIST(the_event, *(the_event->eventlist), next);
-        } else {
-            list = nullptr;
-        }
+        if ((list = the_event->eventlist))
+            event_unlink(the_event);
 
         /* call event func, reenqueue event if retval > 0 */
-        if ((new_time = (the_event->func)(the_event->event_obj)) > 0) {
+        start = std::chrono::steady_clock::now();
+        new_time = (the_event->func)(the_event->event_obj);
+        event_profile_fired(the_event->num, start, std::chrono::steady_clock::now());
+
+        if (new_time > 0) {
             the_event->q_el = queue_enq(event_q, the_event, new_time + pulse);
+            event_profile_scheduled(the_event->num, event_q->size);
             /* Re-add it to the list. */
-            if (list) {
-                the_event->eventlist = list;
-                if (*list)
-                    the_event->next = *list;
-                *list = the_event;
-            }
+            if (list)
+                event_link(the_event, list);
         } else {
             if ((the_event->free_obj && new_time != EVENT_PREVENT_FREE_OBJ) || new_time == EVENT_FORCE_FREE_OBJ)
                 free_event_obj(the_event);
-            free(the_event);
+            event_release(the_event);
         }
     }
 }
@@ -492,33 +628,37 @@ long event_time(Event *event) {
     return (when - pulse);
 }
 
+/* frees an event still in the queue at shutdown */
+static void free_queued_event(void *data) {
+    Event *the_event = (Event *)data;
+
+    if (the_event->free_obj && the_event->event_obj)
+        free_event_obj(the_event);
+    event_release(the_event);
+}
+
 /* frees all events in the queue */
 void event_free_all(void) {
-    Event *the_event;
-
-    while ((the_event = (Event *)queue_head(event_q))) {
-        if (the_event->free_obj && the_event->event_obj)
-            free_event_obj(the_event);
-        free(the_event);
-    }
+    queue_free(event_q, free_queued_event);
+    event_q = nullptr;
 
-    queue_free(event_q);
+    event_pool_free();
 }
 
 /* Cancel all events in a list. Probably because the character or object
  * that owns the list is being extracted. */
-void cancel_event_list(Event **list) {
+void cancel_event_list(EventList *list) {
     Event *e, *next_e;
 
-    e = *list;
-    while (e) {
+    for (e = list->head; e; e = next_e) {
         next_e = e->next;
-        e->next = nullptr;
-        e->eventlist = nullptr; /* Prevents cancel_event() from messing with the list */
+        e->eventlist = nullptr; /* Prevents event_cancel() from messing with the list */
         event_cancel(e);
-        e = next_e;
     }
-    *list = nullptr;
+    list->head = nullptr;
+
+    free(list->by_type);
+    list->by_type = nullptr;
 }
 
 /* should be removed eventually so that event lists are attached to
@@ -549,7 +689,7 @@ const char *eventname(Event *e) {
 GenericEventData *mkgenericevent(CharData *ch, CharData *vict, ObjData *obj) {
     GenericEventData *d;
 
-    CREATE(d, GenericEventData, 1);
+    CREATE_EVENT_OBJ(d, GenericEventData);
     d->ch = ch;
     d->vict = vict;
     d->obj = obj;
@@ -32,9 +32,37 @@ struct Event {
     void *event_obj;
     bool free_obj;
     QElement *q_el;
-    Event **eventlist, *next;
+    EventList *eventlist;
+    Event *next, *prev;                 /* in eventlist */
+    Event *next_of_type, *prev_of_type; /* in eventlist->by_type[num] */
 };
 
+/*
+ * Events and their event_objs come from slabs of fixed-size blocks, which
+ * are kept on free lists and reused instead of going back to malloc.
+ * Blocks larger than EVENT_POOL_MAX bytes are calloc'd.
+ */
+#define EVENT_POOL_GRAIN 16                                    /* block sizes are multiples of this */
+#define EVENT_POOL_MAX 256                                     /* largest block kept on a free list */
+#define EVENT_POOL_CLASSES (EVENT_POOL_MAX / EVENT_POOL_GRAIN) /* free lists */
+#define EVENT_SLAB_SIZE 16384                                  /* bytes malloc'd at a time */
+
+struct EventPoolStats {
+    long allocations; /* event_alloc() calls */
+    long reuses;      /* ...that were given a released block */
+    long in_use;      /* blocks not yet released */
+    long large;       /* ...of which were too large for a slab */
+    long slabs;       /* slabs allocated */
+};
+
+/* Zeroed memory for an Event or an event_obj; give it back with event_release(). */
+void *event_alloc(size_t size);
+void event_release(void *ptr);
+const EventPoolStats &event_pool_stats(void);
+
+/* Like CREATE(result, type, 1), for event_objs that will be freed with their event. */
+#define CREATE_EVENT_OBJ(result, type) ((result) = (type *)event_alloc(sizeof(type)))
+
 void sethurtevent(CharData *ch, CharData *vict, int dam);
 void overweight_check(CharData *ch);
 
@@ -43,15 +71,16 @@ bool char_has_delayed_command(CharData *ch, const char *command);
 
 /* function protos need by other modules */
 void event_init(void);
-Event *event_create(int eventnum, EVENTFUNC(*func), void *event_obj, bool free_obj, Event **list, long when);
+Event *event_create(int eventnum, EVENTFUNC(*func), void *event_obj, bool free_obj, EventList *list, long when);
 
-void cancel_event(Event *eventlist, int eventtype);
+Event *find_event(EventList *list, int eventtype);
+void cancel_event(EventList *list, int eventtype);
 void event_cancel(Event *event);
 void event_process(void);
 long event_time(Event *event);
 void event_free_all(void);
 const char *eventname(Event *e);
-void cancel_event_list(Event **list);
+void cancel_event_list(EventList *list);
 GenericEventData *mkgenericevent(CharData *ch, CharData *vict, ObjData *obj);
 void delayed_command(CharData *ch, char *command, int delay, bool repeatable);
 
@@ -970,8 +970,7 @@ void die(CharData *ch, CharData *killer) {
     abort_casting(ch);
 
     /* Cancel events */
-    if (ch->events)
-        cancel_event_list(&(ch->events));
+    cancel_event_list(&(ch->events));
     for (i = 0; i < EVENT_FLAG_FIELDS; ++i)
         ch->event_flags[i] = 0;
 
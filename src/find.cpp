@@ -372,6 +372,12 @@ ObjData *find_obj_in_eq(CharData *ch, int *where, FindContext context) {
 ObjData *find_obj_in_world(FindContext context) {
     ObjData *obj = object_list;
 
+    /* Scripts search by id a lot; those can go straight to the uid table. */
+    if (context.obj_func == match_obj_by_id || context.obj_func == match_vis_obj_by_id) {
+        obj = find_obj(context.number);
+        return obj && OBJ_MATCH(context, obj) ? obj : nullptr;
+    }
+
     while (obj) {
         if (OBJ_MATCH(context, obj))
             return obj;
@@ -520,9 +526,18 @@ CharData *find_char_in_room(RoomData *room, FindContext context) {
 CharData *find_char_in_world(FindContext context) {
     CharData *ch = character_list;
 
+    extern MATCH_CHAR_FUNC(match_dg_vis_char_by_id);
+
     if (context.override)
         return context.ch;
 
+    /* Scripts search by id a lot; those can go straight to the uid table. */
+    if (context.char_func == match_char_by_id || context.char_func == match_vis_char_by_id ||
+        context.char_func == match_dg_vis_char_by_id) {
+        ch = find_char(context.number);
+        return ch && CHAR_MATCH(context, ch) ? ch : nullptr;
+    }
+
     while (ch) {
         if (CHAR_MATCH(context, ch))
             return ch;
@@ -578,7 +578,7 @@ bool call_track(bool hunt, TrackInfo track, CharData *ch, CharData *victim, bool
     } else {
         /* In range.  Let the tracking commence. */
         char_printf(ch, "You begin to search for tracks...\n");
-        CREATE(track_event, TrackDelayedEventObj, 1);
+        CREATE_EVENT_OBJ(track_event, TrackDelayedEventObj);
         track_event->ch = ch;
         track_event->victim = victim;
         track_event->track = track;
@@ -41,6 +41,7 @@
 #include "structs.hpp"
 #include "sysdep.hpp"
 #include "trophy.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
 
 ObjData *go_iterator = nullptr;
@@ -564,6 +565,10 @@ void char_from_room(CharData *ch) {
     REMOVE_FROM_LIST(ch, world[ch->in_room].people, next_in_room);
     ch->in_room = NOWHERE;
     ch->next_in_room = nullptr;
+    place_char_triggers(ch);
+
+    if (ch->desc)
+        update_zone_occupancy(ch->desc);
 }
 
 /* place a character in a room */
@@ -581,14 +586,20 @@ void char_to_room(CharData *ch, int room) {
         ch->next_in_room = world[room].people;
         world[room].people = ch;
         ch->in_room = room;
+        place_char_triggers(ch);
 
         world[room].light += char_lightlevel(ch);
+        if (ch->desc)
+            update_zone_occupancy(ch->desc);
     } else {
         ch->next_in_room = world[room].people;
         world[room].people = ch;
         ch->in_room = room;
+        place_char_triggers(ch);
 
         world[room].light += char_lightlevel(ch);
+        if (ch->desc)
+            update_zone_occupancy(ch->desc);
 
         /* Kill flames immediately upon entering a water room */
         if (EFF_FLAGGED(ch, EFF_ON_FIRE) && IS_WATER(IN_ROOM(ch))) {
@@ -616,6 +627,7 @@ void obj_to_char(ObjData *obj, CharData *ch) {
         if (GET_OBJ_TYPE(obj) == ITEM_LIGHT && GET_OBJ_VAL(obj, VAL_LIGHT_LIT))
             world[ch->in_room].light++;
         obj->in_room = NOWHERE;
+        place_obj_triggers(obj);
         IS_CARRYING_W(ch) += GET_OBJ_EFFECTIVE_WEIGHT(obj);
         IS_CARRYING_N(ch)++;
 
@@ -651,6 +663,7 @@ void obj_from_char(ObjData *obj) {
     IS_CARRYING_N(obj->carried_by)--;
     obj->carried_by = nullptr;
     obj->next_content = nullptr;
+    place_obj_triggers(obj);
 }
 
 /* Return the effect of a piece of armor in position eq_pos */
@@ -911,6 +924,7 @@ enum equip_result equip_char(CharData *ch, ObjData *obj, int pos) {
     GET_EQ(ch, pos) = obj;
     obj->worn_by = ch;
     obj->worn_on = pos;
+    place_obj_triggers(obj);
 
     if (GET_OBJ_TYPE(obj) == ITEM_ARMOR || GET_OBJ_TYPE(obj) == ITEM_TREASURE)
         GET_AC(ch) -= apply_ac(ch, pos);
@@ -941,6 +955,7 @@ ObjData *unequip_char(CharData *ch, int pos) {
     obj = GET_EQ(ch, pos);
     obj->worn_by = nullptr;
     obj->worn_on = -1;
+    place_obj_triggers(obj);
 
     if (GET_OBJ_TYPE(obj) == ITEM_ARMOR || GET_OBJ_TYPE(obj) == ITEM_TREASURE)
         GET_AC(ch) += apply_ac(ch, pos);
@@ -997,6 +1012,7 @@ void obj_to_room(ObjData *obj, int room) {
         world[room].contents = obj;
         obj->in_room = room;
         obj->carried_by = nullptr;
+        place_obj_triggers(obj);
         if (GET_OBJ_TYPE(obj) == ITEM_LIGHT && GET_OBJ_VAL(obj, VAL_LIGHT_LIT))
             world[obj->in_room].light++;
 
@@ -1005,7 +1021,7 @@ void obj_to_room(ObjData *obj, int room) {
             /* Will the object sink in water? */
             if ((SECT(room) == SECT_SHALLOWS || SECT(room) == SECT_WATER) && (!OBJ_FLAGGED(obj, ITEM_FLOAT))) {
                 /* Yep, say goodbye. */
-                CREATE(sinkdata, SinkAndLose, 1);
+                CREATE_EVENT_OBJ(sinkdata, SinkAndLose);
                 sinkdata->room = room;
                 sinkdata->obj = obj;
                 event_create(EVENT_SINK_AND_LOSE, &sink_and_lose_event, sinkdata, true, &(obj->events), 2);
@@ -1044,6 +1060,7 @@ void obj_from_room(ObjData *object) {
         SET_FLAG(ROOM_FLAGS(object->in_room), ROOM_HOUSE_CRASH);
     object->in_room = NOWHERE;
     object->next_content = nullptr;
+    place_obj_triggers(object);
 }
 
 /* put an object in an object (quaint)  */
@@ -1173,12 +1190,12 @@ void extract_obj(ObjData *obj) {
         go_iterator = obj->next;
 
     REMOVE_FROM_LIST(obj, object_list, next);
+    obj_uids.remove(GET_ID(obj), obj);
 
     if (GET_OBJ_RNUM(obj) != NOTHING)
         (obj_index[GET_OBJ_RNUM(obj)].number)--;
 
-    if (obj->events)
-        cancel_event_list(&(obj->events));
+    cancel_event_list(&(obj->events));
 
     free_obj(obj);
 }
@@ -1297,13 +1314,13 @@ void extract_char(CharData *ch) {
 
     /* pull the char from the list */
     REMOVE_FROM_LIST(ch, character_list, next);
+    char_uids.remove(GET_ID(ch), ch);
 
     /*
      * Take out events now, since the character may not be freed
      * below (in the case of players).
      */
-    if (ch->events)
-        cancel_event_list(&(ch->events));
+    cancel_event_list(&(ch->events));
     for (i = 0; i < EVENT_FLAG_FIELDS; ++i)
         ch->event_flags[i] = 0;
 
@@ -1321,6 +1338,7 @@ void extract_char(CharData *ch) {
 
     if (!freed && ch->desc != nullptr) {
         STATE(ch->desc) = CON_MENU;
+        update_zone_occupancy(ch->desc);
         string_to_output(ch->desc, MENU);
     } else { /* if a player gets purged from within the game */
         if (!freed)
@@ -17,6 +17,8 @@
 #include "clan.hpp"
 #include "class.hpp"
 #include "comm.hpp"
+#include "command_lookup.hpp"
+#include "command_queue.hpp"
 #include "commands.hpp"
 #include "conf.hpp"
 #include "constants.hpp"
@@ -42,6 +44,7 @@
 #include "structs.hpp"
 #include "sysdep.hpp"
 #include "textfiles.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
 #include "version.hpp"
 
@@ -338,6 +341,10 @@ ACMD(do_summon_mount);
 int num_of_cmds;
 SortStruct *cmd_sort_info = nullptr;
 
+/* Built from cmd_info by sort_commands(). */
+static CommandTrie command_trie;
+static CommandBKTree command_typos(levenshtein_distance);
+
 /* This is the Master Command List(tm).
 
  * You can put new commands in, take commands out, change the order
@@ -1002,27 +1009,20 @@ const char *fill[] = {"in", "from", "with", "the", "on", "at", "to", "\n"};
 const char *reserved[] = {"self", "me", "all", "room", "someone", "something", "\n"};
 
 void list_similar_commands(CharData *ch, char *arg) {
-    int found = false, cmd;
+    int found = false;
 
     if (!PRF_FLAGGED(ch, PRF_NOHINTS)) {
-        /* Display similar commands. */
-        for (cmd = 0; *cmd_info[cmd].command != '\n'; ++cmd) {
+        /* Display similar commands.  Socials aren't in command_typos. */
+        for (int cmd : command_typos.within(arg, 2)) {
             if (*arg != *cmd_info[cmd].command)
                 continue;
             if (!can_use_command(ch, cmd))
                 continue;
-            if (cmd_info[cmd].minimum_level < 0)
-                continue;
-            /* skip socials */
-            if (cmd_info[cmd].command_pointer == do_action)
-                continue;
-            if (levenshtein_distance(arg, cmd_info[cmd].command) <= 2) {
-                if (!found) {
-                    char_printf(ch, "\nDid you mean:\n");
-                    found = true;
-                }
-                char_printf(ch, "  {}\n", cmd_info[cmd].command);
+            if (!found) {
+                char_printf(ch, "\nDid you mean:\n");
+                found = true;
             }
+            char_printf(ch, "  {}\n", cmd_info[cmd].command);
         }
     }
 }
@@ -1033,7 +1033,8 @@ void list_similar_commands(CharData *ch, char *arg) {
  * then calls the appropriate function.
  */
 void command_interpreter(CharData *ch, char *argument) {
-    int cmd, length;
+    int cmd;
+    const std::vector<int> *matches;
     extern int no_specials;
     char *line;
 
@@ -1060,10 +1061,14 @@ void command_interpreter(CharData *ch, char *argument) {
         (command_wtrigger(ch, arg, line) || command_mtrigger(ch, arg, line) || command_otrigger(ch, arg, line)))
         return; /* command trigger took over */
 
-    for (length = strlen(arg), cmd = 1; *cmd_info[cmd].command != '\n'; cmd++)
-        if (!strncasecmp(cmd_info[cmd].command, arg, length))
-            if (can_use_command(ch, cmd))
+    /* The first command (after RESERVED) that arg abbreviates and ch can use. */
+    cmd = num_of_cmds;
+    if ((matches = command_trie.matches(arg)))
+        for (int match : *matches)
+            if (match > 0 && can_use_command(ch, match)) {
+                cmd = match;
                 break;
+            }
 
     if (IS_HIDDEN(ch) && !IS_SET(cmd_info[cmd].flags, CMD_HIDE)) {
         effect_from_char(ch, SPELL_NATURES_EMBRACE);
@@ -1258,10 +1263,9 @@ ACMD(do_alias) {
  */
 #define NUM_TOKENS 9
 
-void perform_complex_alias(CharData *ch, txt_q *input_q, char *orig, AliasData *alias) {
-    txt_q temp_queue;
-    char *tokens[NUM_TOKENS], *temp, *write_point;
-    int num_of_tokens = 0, num;
+void perform_complex_alias(CharData *ch, CommandQueue *input_q, char *orig, AliasData *alias) {
+    char *commands[MAX_QUEUED_COMMANDS + 1], *tokens[NUM_TOKENS], *temp, *write_point;
+    int num_of_tokens = 0, num, num_of_commands = 0, queued;
 
     /* First, parse the original string */
     temp = strtok(strcpy(buf2, orig), " ");
@@ -1270,41 +1274,39 @@ void perform_complex_alias(CharData *ch, txt_q *input_q, char *orig, AliasData *
         temp = strtok(nullptr, " ");
     }
 
-    /* initialize */
-    write_point = buf;
-    temp_queue.head = temp_queue.tail = nullptr;
-
-    /* now parse the alias */
-    for (temp = alias->replacement; *temp; temp++) {
-        if (*temp == ALIAS_SEP_CHAR) {
-            *write_point = '\0';
-            buf[MAX_INPUT_LENGTH - 1] = '\0';
-            write_to_q(buf, &temp_queue, 1, ch->desc);
-            write_point = buf;
-        } else if (*temp == ALIAS_VAR_CHAR) {
+    /* Find where each command of the alias starts; no more fit in the queue. */
+    commands[num_of_commands++] = alias->replacement;
+    for (temp = alias->replacement; *temp && num_of_commands <= MAX_QUEUED_COMMANDS; temp++) {
+        if (*temp == ALIAS_VAR_CHAR && temp[1])
             temp++;
-            if ((num = *temp - '1') < num_of_tokens && num >= 0) {
-                strcpy(write_point, tokens[num]);
-                write_point += strlen(tokens[num]);
-            } else if (*temp == ALIAS_GLOB_CHAR) {
-                strcpy(write_point, orig);
-                write_point += strlen(orig);
-            } else if ((*(write_point++) = *temp) == '$') /* redouble $ for act safety */
-                *(write_point++) = '$';
-        } else
-            *(write_point++) = *temp;
+        else if (*temp == ALIAS_SEP_CHAR)
+            commands[num_of_commands++] = temp + 1;
     }
 
-    *write_point = '\0';
-    buf[MAX_INPUT_LENGTH - 1] = '\0';
-    write_to_q(buf, &temp_queue, 1, ch->desc);
-
-    /* push our temp_queue on to the _front_ of the input queue */
-    if (input_q->head == nullptr)
-        *input_q = temp_queue;
-    else {
-        temp_queue.tail->next = input_q->head;
-        input_q->head = temp_queue.head;
+    queued = std::min<int>(num_of_commands, input_q->space());
+    if (queued < num_of_commands)
+        char_printf(ch, "You have typed too far ahead; only part of that alias will be run.\n");
+
+    /* push the commands on to the _front_ of the input queue, last first */
+    while (queued--) {
+        write_point = buf;
+        for (temp = commands[queued]; *temp && *temp != ALIAS_SEP_CHAR; temp++) {
+            if (*temp == ALIAS_VAR_CHAR && temp[1]) {
+                temp++;
+                if ((num = *temp - '1') < num_of_tokens && num >= 0) {
+                    strcpy(write_point, tokens[num]);
+                    write_point += strlen(tokens[num]);
+                } else if (*temp == ALIAS_GLOB_CHAR) {
+                    strcpy(write_point, orig);
+                    write_point += strlen(orig);
+                } else if ((*(write_point++) = *temp) == '$') /* redouble $ for act safety */
+                    *(write_point++) = '$';
+            } else
+                *(write_point++) = *temp;
+        }
+        *write_point = '\0';
+        buf[MAX_INPUT_LENGTH - 1] = '\0';
+        input_q->push_front(buf, true);
     }
 }
 
@@ -1343,7 +1345,7 @@ int perform_alias(DescriptorData *d, char *orig) {
         strcpy(orig, alias->replacement);
         return 0;
     } else {
-        perform_complex_alias(d->character, &d->input, ptr, alias);
+        perform_complex_alias(d->character, d->input, ptr, alias);
         return 1;
     }
 }
@@ -1756,24 +1758,12 @@ void half_chop(char *str, char *arg1, char *arg2) {
 }
 
 /* Used in specprocs, mostly.  (Exactly) matches "command" to cmd number */
-int find_command(const char *command) {
-    int cmd;
-
-    for (cmd = 0; *cmd_info[cmd].command != '\n'; ++cmd)
-        if (!strcasecmp(cmd_info[cmd].command, command))
-            return cmd;
-
-    return -1;
-}
+int find_command(const char *command) { return command_trie.find(command); }
 
 int parse_command(char *command) {
-    int cmd, length = strlen(command);
-
-    for (cmd = 0; *cmd_info[cmd].command != '\n'; ++cmd)
-        if (!strncasecmp(cmd_info[cmd].command, command, length))
-            return cmd;
+    const std::vector<int> *matches = command_trie.matches(command);
 
-    return -1;
+    return matches ? matches->front() : -1;
 }
 
 int special(CharData *ch, int cmd, char *arg) {
@@ -1818,16 +1808,7 @@ int special(CharData *ch, int cmd, char *arg) {
  ************************************************************************* */
 
 /* locate entry in p_table with entry->name == name. -1 mrks failed search */
-int find_name(const char *name) {
-    int i;
-
-    for (i = 0; i <= top_of_p_table; i++) {
-        if (!strcasecmp((player_table + i)->name, name))
-            return i;
-    }
-
-    return -1;
-}
+int find_name(const char *name) { return get_ptable_by_name(name); }
 
 #define RECON 1
 #define USURP 2
@@ -1866,6 +1847,7 @@ int perform_dupe_check(DescriptorData *d) {
                 k->character->desc = nullptr;
             k->character = nullptr;
             k->original = nullptr;
+            update_zone_occupancy(k);
         } else if (k->character && (GET_IDNUM(k->character) == id)) {
             if (!target && STATE(k) == CON_PLAYING) {
                 string_to_output(k, "\nThis body has been usurped!\n");
@@ -1877,6 +1859,7 @@ int perform_dupe_check(DescriptorData *d) {
             k->original = nullptr;
             string_to_output(k, "\nMultiple login detected -- disconnecting.\n");
             STATE(k) = CON_CLOSE;
+            update_zone_occupancy(k);
         }
     }
 
@@ -1933,6 +1916,7 @@ int perform_dupe_check(DescriptorData *d) {
     REMOVE_FLAG(PLR_FLAGS(d->character), PLR_WRITING);
     REMOVE_FLAG(PLR_FLAGS(d->character), PLR_MAILING);
     STATE(d) = CON_PLAYING;
+    update_zone_occupancy(d);
 
     switch (mode) {
     case RECON:
@@ -2004,6 +1988,7 @@ int enter_player_game(DescriptorData *d) {
     GET_ID(d->character) = GET_IDNUM(d->character);
     d->character->next = character_list;
     character_list = d->character;
+    char_uids.add(GET_ID(d->character), d->character);
 
     // send_save_description() will use this actual, error-checked value for the load room
     GET_LOADROOM(d->character) = load_room == NOWHERE ? NOWHERE : world[load_room].vnum;
@@ -3200,6 +3185,7 @@ void nanny(DescriptorData *d, char *arg) {
             act("$n has entered the game.", true, d->character, 0, 0, TO_ROOM);
 
             STATE(d) = CON_PLAYING;
+            update_zone_occupancy(d);
             if (!GET_LEVEL(d->character)) {
                 start_player(d->character);
                 char_printf(d->character, START_MESSG);
@@ -3431,6 +3417,15 @@ void sort_commands(void) {
     while (*cmd_info[num_of_cmds].command != '\n')
         ++num_of_cmds;
 
+    /* find_command() needs these, so build them first. */
+    command_trie.clear();
+    command_typos.clear();
+    for (a = 0; a < num_of_cmds; a++) {
+        command_trie.insert(a, cmd_info[a].command);
+        if (cmd_info[a].minimum_level >= 0 && cmd_info[a].command_pointer != do_action)
+            command_typos.insert(a, cmd_info[a].command);
+    }
+
     /* create data array */
     CREATE(cmd_sort_info, SortStruct, num_of_cmds);
 
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   File: lag_profiler.c                                 Part of FieryMUD *
+ *  Usage: timing the phases of each pulse                                 *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "lag_profiler.hpp"
+
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fmt/format.h>
+
+static const char *lag_phase_names[NUM_LAG_PHASES] = {
+    "input",    "commands",     "cmd events", "output",  "events", "scripts", "zones", "mobiles",
+    "violence", "mob violence", "sickness",   "effects", "points", "time",    "saves", "houses",
+};
+
+/* All times in microseconds. */
+struct LagStats {
+    std::uint64_t runs;
+    std::uint64_t total;
+    std::uint64_t max;
+    std::uint32_t recent[LAG_HISTORY]; /* the last LAG_HISTORY runs, oldest overwritten first */
+};
+
+static LagStats lag_stats[NUM_LAG_PHASES];
+
+LagTimer::~LagTimer() {
+    lag_record(phase_, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_));
+}
+
+void lag_record(LagPhase phase, std::chrono::microseconds took) {
+    LagStats &stats = lag_stats[phase];
+    std::uint64_t us = std::max<std::int64_t>(took.count(), 0);
+
+    stats.recent[stats.runs % LAG_HISTORY] = std::min<std::uint64_t>(us, UINT32_MAX);
+    ++stats.runs;
+    stats.total += us;
+    stats.max = std::max(stats.max, us);
+}
+
+void lag_reset(void) { std::fill(std::begin(lag_stats), std::end(lag_stats), LagStats{}); }
+
+std::string lag_report(void) {
+    std::string report = fmt::format("{:<13} {:>9} {:>9} {:>9} {:>9} {:>9} {:>10}\n", "Phase", "Runs", "Avg ms",
+                                      "Max ms", "Last avg", "Last max", "Total s");
+    std::uint64_t recent_total, recent_max;
+    int i, j, recent;
+
+    for (i = 0; i < NUM_LAG_PHASES; ++i) {
+        const LagStats &stats = lag_stats[i];
+
+        recent = std::min<std::uint64_t>(stats.runs, LAG_HISTORY);
+        recent_total = recent_max = 0;
+        for (j = 0; j < recent; ++j) {
+            recent_total += stats.recent[j];
+            recent_max = std::max<std::uint64_t>(recent_max, stats.recent[j]);
+        }
+
+        report += fmt::format("{:<13} {:>9} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>10.2f}\n", lag_phase_names[i],
+                              stats.runs, stats.runs ? stats.total / 1000.0 / stats.runs : 0.0, stats.max / 1000.0,
+                              recent ? recent_total / 1000.0 / recent : 0.0, recent_max / 1000.0,
+                              stats.total / 1000000.0);
+    }
+
+    return report;
+}
+
+void lag_log_report(void) {
+    std::string report = lag_report();
+    std::string::size_type start = 0, end;
+
+    log("Pulse phase timings (\"Last\" is the last {:d} runs of each):", LAG_HISTORY);
+    while ((end = report.find('\n', start)) != std::string::npos) {
+        log("{}", report.substr(start, end - start));
+        start = end + 1;
+    }
+}
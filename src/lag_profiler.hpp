@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   File: lag_profiler.h                                 Part of FieryMUD *
+ *  Usage: header file: timing the phases of each pulse                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/* The parts of a pulse that are timed separately.  Keep lag_phase_names in step. */
+enum LagPhase {
+    LAG_INPUT,        /* reading sockets and parsing telnet */
+    LAG_COMMANDS,     /* interpreting one command per descriptor */
+    LAG_CMD_EVENTS,   /* event_process() after each descriptor's command */
+    LAG_OUTPUT,       /* compressing and writing output, prompts */
+    LAG_EVENTS,       /* event_process() before and during the heartbeat */
+    LAG_SCRIPTS,      /* script_trigger_check() and time triggers */
+    LAG_ZONES,        /* zone_update() */
+    LAG_MOBILES,      /* mobile_activity() */
+    LAG_VIOLENCE,     /* perform_violence() and mobile_spec_activity() */
+    LAG_MOB_VIOLENCE, /* perform_mob_violence() */
+    LAG_SICKNESS,     /* sick_update() */
+    LAG_EFFECTS,      /* effect_update() */
+    LAG_POINTS,       /* point_update() */
+    LAG_TIME,         /* weather and game time */
+    LAG_SAVES,        /* auto_save_all() */
+    LAG_HOUSES,       /* House_save_all() */
+    NUM_LAG_PHASES
+};
+
+#define LAG_HISTORY 100 /* recent runs of each phase kept for show lag */
+
+/*
+ * Times the rest of the enclosing scope and charges it to a phase:
+ *
+ *     {
+ *         LagTimer timer(LAG_ZONES);
+ *         zone_update();
+ *     }
+ *
+ * Two reads of the monotonic clock, so cheap enough to leave on.
+ */
+class LagTimer {
+  public:
+    explicit LagTimer(LagPhase phase) : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+    ~LagTimer();
+    LagTimer(const LagTimer &) = delete;
+    LagTimer &operator=(const LagTimer &) = delete;
+
+  private:
+    LagPhase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+void lag_record(LagPhase phase, std::chrono::microseconds took);
+void lag_reset(void);
+/* A table of every phase's statistics, one line per phase. */
+std::string lag_report(void);
+/* Write lag_report() to the log. */
+void lag_log_report(void);
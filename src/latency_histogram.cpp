@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   File: latency_histogram.c                            Part of FieryMUD *
+ *  Usage: fixed-size histograms of durations                              *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+/*
+ * Values below SUB_BUCKETS get a bucket each.  Above that, a value in
+ * [2^m, 2^(m+1)) keeps its top SUB_BITS + 1 bits: the leading one picks
+ * the row for m, and the SUB_BITS after it the bucket within the row.
+ */
+int LatencyHistogram::bucket_of(std::uint64_t value) {
+    int shift;
+
+    if (value < SUB_BUCKETS)
+        return value;
+    shift = std::bit_width(value) - 1 - SUB_BITS;
+    return (shift + 1) * SUB_BUCKETS + (int)((value >> shift) - SUB_BUCKETS);
+}
+
+/* The largest value that lands in a bucket */
+std::uint64_t LatencyHistogram::bucket_top(int bucket) {
+    int shift = bucket / SUB_BUCKETS - 1;
+
+    if (shift < 0)
+        return bucket;
+    return ((std::uint64_t)(SUB_BUCKETS + bucket % SUB_BUCKETS + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds value) {
+    std::uint64_t ns = std::max<std::int64_t>(value.count(), 0);
+
+    ++counts_[bucket_of(ns)];
+    ++count_;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::clear() {
+    std::fill(std::begin(counts_), std::end(counts_), 0);
+    count_ = max_ = 0;
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double p) const {
+    std::uint64_t wanted, seen = 0;
+    int i;
+
+    if (!count_)
+        return std::chrono::nanoseconds(0);
+
+    wanted = std::clamp<std::uint64_t>(std::ceil(p * count_), 1, count_);
+    for (i = 0; i < NUM_BUCKETS; ++i)
+        if ((seen += counts_[i]) >= wanted)
+            break;
+    return std::chrono::nanoseconds(std::min(bucket_top(i), max_));
+}
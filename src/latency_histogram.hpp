@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   File: latency_histogram.h                            Part of FieryMUD *
+ *  Usage: header file: fixed-size histograms of durations                 *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Counts of durations, in buckets that widen as the values grow (as in
+ * an HDR histogram): every power of two is split into 16 buckets, so a
+ * percentile read back is within about 6% of the truth over the whole
+ * range, and recording is a couple of shifts and an increment.  Values
+ * are kept in nanoseconds, so durations well under a microsecond (most
+ * event handlers) still tell apart.
+ */
+class LatencyHistogram {
+  public:
+    void record(std::chrono::nanoseconds value);
+    void clear();
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(max_); }
+    /* The duration that fraction p (0 to 1) of the recorded ones didn't exceed. */
+    std::chrono::nanoseconds percentile(double p) const;
+
+  private:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static int bucket_of(std::uint64_t value);
+    static std::uint64_t bucket_top(int bucket);
+
+    std::uint64_t counts_[NUM_BUCKETS] = {};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0; /* nanoseconds */
+};
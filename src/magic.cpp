@@ -3904,6 +3904,7 @@ void mod_for_lvldiff(CharData *mob, CharData *ch) {
 CharData *create_undead(CharData *orig, CharData *caster, bool ISPC) {
     char short_buf[160], long_buf[160], alias_buf[160];
     CharData *new_mob, *next_mob;
+    long new_id;
     enum undead_type new_mob_type;
 
     extern PlayerSpecialData dummy_mob;
@@ -3924,8 +3925,10 @@ CharData *create_undead(CharData *orig, CharData *caster, bool ISPC) {
     new_mob = create_char();
 
     next_mob = new_mob->next; /* it's about to get overwritten */
+    new_id = GET_ID(new_mob); /* so is this, and char_uids knows it */
     *new_mob = *orig;
     new_mob->next = next_mob; /* put it back */
+    GET_ID(new_mob) = new_id;
     new_mob->player_specials = &dummy_mob;
 
     /* make sure it has no money in case the proto does */
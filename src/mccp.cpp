@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   File: mccp.c                                         Part of FieryMUD *
+ *  Usage: MCCP2 output compression                                        *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "mccp.hpp"
+
+#include <cstdlib>
+
+/* zlib's own estimate of what deflate needs at the default settings (memLevel 8) */
+#define MCCP_STREAM_MEMORY ((1 << (MAX_WBITS + 2)) + (1 << (8 + 9)) + 8 * 1024)
+
+/* Generous upper bound on what a sync flush adds */
+#define MCCP_FLUSH_OVERHEAD 16
+
+int MccpStream::streams_ = 0;
+std::size_t MccpStream::memory_in_use_ = 0;
+unsigned long long MccpStream::total_in_ = 0;
+unsigned long long MccpStream::total_out_ = 0;
+
+MccpStream::MccpStream() : zs_{} {
+    zs_.zalloc = zalloc;
+    zs_.zfree = zfree;
+    zs_.opaque = nullptr;
+    ok_ = deflateInit(&zs_, Z_DEFAULT_COMPRESSION) == Z_OK;
+    if (ok_)
+        ++streams_;
+}
+
+MccpStream::~MccpStream() {
+    if (ok_) {
+        deflateEnd(&zs_);
+        --streams_;
+    }
+}
+
+/*
+ * zlib allocates through here so that memory_in_use_ is what the
+ * compressors really hold, not an estimate.
+ */
+voidpf MccpStream::zalloc(voidpf, uInt items, uInt size) {
+    std::size_t bytes = (std::size_t)items * size;
+    auto *block = (std::size_t *)malloc(bytes + sizeof(std::size_t));
+
+    if (!block)
+        return Z_NULL;
+    *block = bytes;
+    memory_in_use_ += bytes;
+    return block + 1;
+}
+
+void MccpStream::zfree(voidpf, voidpf address) {
+    auto *block = (std::size_t *)address - 1;
+
+    memory_in_use_ -= *block;
+    free(block);
+}
+
+bool MccpStream::can_start(std::size_t limit) { return memory_in_use_ + MCCP_STREAM_MEMORY <= limit; }
+
+std::string_view MccpStream::deflate_into_scratch(std::string_view data, int mode) {
+    char chunk[4096];
+    int result;
+
+    scratch_.clear();
+    zs_.next_in = (Bytef *)data.data();
+    zs_.avail_in = data.size();
+    do {
+        zs_.next_out = (Bytef *)chunk;
+        zs_.avail_out = sizeof(chunk);
+        result = deflate(&zs_, mode);
+        scratch_.append(chunk, sizeof(chunk) - zs_.avail_out);
+    } while (result != Z_STREAM_ERROR && (zs_.avail_out == 0 || zs_.avail_in > 0));
+
+    bytes_in_ += data.size();
+    bytes_out_ += scratch_.size();
+    total_in_ += data.size();
+    total_out_ += scratch_.size();
+    unflushed_in_ += data.size();
+    unflushed_out_ += scratch_.size();
+    return scratch_;
+}
+
+std::string_view MccpStream::compress(std::string_view data) {
+    if (data.empty())
+        return {};
+    return deflate_into_scratch(data, Z_NO_FLUSH);
+}
+
+std::string_view MccpStream::flush() {
+    auto out = deflate_into_scratch({}, Z_SYNC_FLUSH);
+
+    unflushed_in_ = unflushed_out_ = 0;
+    return out;
+}
+
+std::string_view MccpStream::finish() {
+    auto out = deflate_into_scratch({}, Z_FINISH);
+
+    unflushed_in_ = unflushed_out_ = 0;
+    return out;
+}
+
+std::size_t MccpStream::room(std::size_t space) const {
+    auto *zs = const_cast<z_stream *>(&zs_);
+    std::size_t need, fits = space;
+
+    /*
+     * deflateBound() grows at least one byte per byte of input, so backing
+     * off by the overshoot is always enough.
+     */
+    need = deflateBound(zs, unflushed_in_ + fits) + MCCP_FLUSH_OVERHEAD - unflushed_out_;
+    if (need <= space)
+        return fits;
+    if (need - space >= fits)
+        return 0;
+    return fits - (need - space);
+}
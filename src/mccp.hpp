@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   File: mccp.h                                         Part of FieryMUD *
+ *  Usage: header file: MCCP2 output compression                           *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+#define MCCP2 86 /* telnet option: Mud Client Compression Protocol v2 */
+
+/*
+ * One descriptor's compressed output stream.  Everything sent after
+ * IAC SB MCCP2 IAC SE goes through compress(); flush() makes all of it
+ * decodable by the client without ending the stream, and finish() ends
+ * the stream so the connection can go back to plain text.
+ *
+ * Each returned view points into a scratch buffer owned by the stream
+ * and is only good until the next call.
+ */
+class MccpStream {
+  public:
+    MccpStream();
+    ~MccpStream();
+    MccpStream(const MccpStream &) = delete;
+    MccpStream &operator=(const MccpStream &) = delete;
+
+    /* Whether zlib accepted the stream; if not, it must not be used. */
+    bool ok() const { return ok_; }
+
+    std::string_view compress(std::string_view data);
+    std::string_view flush();
+    std::string_view finish();
+
+    /* Whether anything has been compressed since the last flush. */
+    bool unflushed() const { return unflushed_in_ > 0; }
+    /*
+     * The most plain text that can still be compressed (and then flushed)
+     * without producing more than space bytes of output in total.
+     */
+    std::size_t room(std::size_t space) const;
+
+    unsigned long long bytes_in() const { return bytes_in_; }
+    unsigned long long bytes_out() const { return bytes_out_; }
+
+    /* Whether one more stream fits under a memory limit of limit bytes. */
+    static bool can_start(std::size_t limit);
+    static int streams() { return streams_; }
+    static std::size_t memory_in_use() { return memory_in_use_; }
+    static unsigned long long total_in() { return total_in_; }
+    static unsigned long long total_out() { return total_out_; }
+
+  private:
+    std::string_view deflate_into_scratch(std::string_view data, int mode);
+
+    static voidpf zalloc(voidpf opaque, uInt items, uInt size);
+    static void zfree(voidpf opaque, voidpf address);
+
+    z_stream zs_;
+    bool ok_;
+    std::string scratch_;
+    std::size_t unflushed_in_ = 0;  /* plain bytes since the last flush */
+    std::size_t unflushed_out_ = 0; /* compressed bytes since the last flush */
+    unsigned long long bytes_in_ = 0, bytes_out_ = 0;
+
+    static int streams_;
+    static std::size_t memory_in_use_;
+    static unsigned long long total_in_, total_out_;
+};
@@ -321,6 +321,7 @@ void medit_save_internally(DescriptorData *d) {
 #endif
             mob_index = new_index;
             mob_proto = new_proto;
+            build_mobile_index();
             /*
              * Update live mobile rnums.
              */
@@ -336,6 +337,7 @@ void medit_save_internally(DescriptorData *d) {
                     if (ZCMD.command == 'M')
                         if (ZCMD.arg1 >= rmob_num)
                             ZCMD.arg1--;
+            invalidate_zone_programs();
 
             /*
              * Update shop keepers.
@@ -448,6 +450,7 @@ void medit_save_internally(DescriptorData *d) {
         mob_index = new_index;
         mob_proto = new_proto;
         top_of_mobt++;
+        build_mobile_index();
 #if defined(DEBUG)
         fprintf(stderr, "Free ok.\n");
 #endif
@@ -467,6 +470,7 @@ void medit_save_internally(DescriptorData *d) {
                 if (ZCMD.command == 'M')
                     if (ZCMD.arg1 >= new_mob_num)
                         ZCMD.arg1++;
+        invalidate_zone_programs();
 
         /*
          * Update shop keepers.
@@ -1463,6 +1467,7 @@ bool delete_mobile(obj_num rnum) {
     top_of_mobt--;
     RECREATE(mob_index, IndexData, top_of_mobt + 1);
     RECREATE(mob_proto, CharData, top_of_mobt + 1);
+    build_mobile_index();
 
     /* Renumber zone table. */
     for (zone = 0; zone <= top_of_zone_table; zone++) {
@@ -1501,6 +1506,7 @@ bool delete_mobile(obj_num rnum) {
             olc_add_to_save_list(zone_table[zone].number, OLC_SAVE_ZONE);
         }
     }
+    invalidate_zone_programs();
 
     olc_add_to_save_list(zone_table[zrnum].number, OLC_SAVE_MOB);
 
@@ -719,6 +719,7 @@ void string_add(DescriptorData *d, char *str) {
             if (terminator != 1)
                 string_to_output(d, "Description aborted.\n");
             STATE(d) = CON_PLAYING;
+            update_zone_occupancy(d);
         } else if (!d->connected && d->character && !IS_NPC(d->character)) {
             if (terminator == 1) {
                 if (strlen(*d->str) == 0) {
@@ -851,6 +852,9 @@ static int get_page_length(DescriptorData *d) {
             page_length = GET_PAGE_LENGTH(d->character);
         if (page_length <= 0 || page_length > 50)
             page_length = 0;
+        /* Don't pile unpaged text onto a connection that can't keep up. */
+        if (!page_length && (output_backlogged(d) || (d->page_outbuf && !d->page_outbuf->empty())))
+            page_length = 22;
     }
 
     return page_length;
@@ -188,7 +188,7 @@ bool too_heavy_to_fly(CharData *ch) {
 void start_char_falling(CharData *ch) {
     GravityEventObj *event_obj;
     if (!EVENT_FLAGGED(ch, EVENT_GRAVITY)) {
-        CREATE(event_obj, GravityEventObj, 1);
+        CREATE_EVENT_OBJ(event_obj, GravityEventObj);
         event_obj->ch = ch;
         event_obj->start_room = IN_ROOM(ch);
         event_create(EVENT_GRAVITY, gravity_event, event_obj, true, &(ch->events), 0);
@@ -199,7 +199,7 @@ void start_char_falling(CharData *ch) {
 void start_obj_falling(ObjData *obj) {
     GravityEventObj *event_obj;
     if (!EVENT_FLAGGED(obj, EVENT_GRAVITY)) {
-        CREATE(event_obj, GravityEventObj, 1);
+        CREATE_EVENT_OBJ(event_obj, GravityEventObj);
         event_obj->obj = obj;
         event_obj->start_room = IN_ROOM(obj);
         event_create(EVENT_GRAVITY, gravity_event, event_obj, true, &(obj->events), 0);
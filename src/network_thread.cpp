@@ -0,0 +1,448 @@
+/***************************************************************************
+ *   File: network_thread.c                               Part of FieryMUD *
+ *  Usage: socket I/O threads feeding the game thread                      *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "network_thread.hpp"
+
+#include "comm.hpp"
+#include "logging.hpp"
+#include "output_queue.hpp"
+#include "telnet_parser.hpp"
+#include "utils.hpp"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET -1
+#endif
+
+/* How long to wait before retrying when the game thread has fallen behind */
+#define NET_BACKLOG_RETRY_MS 10
+
+NetworkThread::Slot NetworkThread::slots_[MAX_DESC_NUM];
+std::atomic<int> NetworkThread::last_desc_num_{0};
+
+/* Hands what the telnet parser finds in one connection's input to the game. */
+class NetworkThread::Parser : public TelnetHandler {
+  public:
+    Parser(NetworkThread *thread, int desc_num) : thread_(thread), desc_num_(desc_num) {}
+
+    void line(std::string_view text) override { post(NET_LINE, 0, 0, text); }
+    bool long_line(std::string_view text) override {
+        post(NET_LONG_LINE, 0, 0, text);
+        return true;
+    }
+    void negotiation(unsigned char command, unsigned char option) override {
+        post(NET_NEGOTIATE, command, option, {});
+    }
+    void subnegotiation(unsigned char option, std::string_view data) override {
+        post(NET_SUBNEGOTIATE, 0, option, data);
+    }
+    void protocol_error(std::string_view what) override { post(NET_ERROR, 0, 0, what); }
+
+  private:
+    void post(int type, unsigned char command, unsigned char option, std::string_view text) {
+        thread_->post({type, desc_num_, INVALID_SOCKET, {}, command, option, std::string(text)});
+    }
+
+    NetworkThread *thread_;
+    int desc_num_;
+};
+
+NetworkThread::NetworkThread(socket_t mother) : mother_(mother), poller_(make_descriptor_poller()) {
+    if (pipe(wake_pipe_) < 0 || pipe(notify_pipe_) < 0) {
+        perror("SYSERR: NetworkThread: pipe");
+        exit(1);
+    }
+    for (int fd : {wake_pipe_[0], wake_pipe_[1], notify_pipe_[0], notify_pipe_[1]}) {
+        nonblock(fd);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    if (!poller_->add(wake_pipe_[0], this) || (mother_ != INVALID_SOCKET && !poller_->add(mother_, nullptr))) {
+        log("SYSERR: An I/O thread is unable to watch its sockets.");
+        exit(1);
+    }
+    thread_ = std::thread(&NetworkThread::run, this);
+}
+
+NetworkThread::~NetworkThread() {
+    stop();
+    /* Whatever is still open goes back to the game thread, which numbers it anew. */
+    for (auto &[desc_num, conn] : connections_)
+        slots_[desc_num].taken.store(false, std::memory_order_release);
+    for (int fd : {wake_pipe_[0], wake_pipe_[1], notify_pipe_[0], notify_pipe_[1]})
+        close(fd);
+}
+
+void NetworkThread::stop() {
+    if (!thread_.joinable())
+        return;
+
+    /* Everything the game has sent has to reach the thread first. */
+    while (congested()) {
+        wake();
+        std::this_thread::yield();
+    }
+    stopping_.store(true, std::memory_order_release);
+    poke(wake_pipe_[1]);
+    thread_.join();
+}
+
+int NetworkThread::claim_desc_num() {
+    int i, num;
+
+    for (i = 1; i < MAX_DESC_NUM; ++i) {
+        num = last_desc_num_.fetch_add(1, std::memory_order_relaxed) % (MAX_DESC_NUM - 1) + 1;
+        if (!slots_[num].taken.exchange(true, std::memory_order_acq_rel))
+            return num;
+    }
+    return 0;
+}
+
+/* Pipes are used for signalling so they work with any DescriptorPoller. */
+void NetworkThread::poke(int fd) {
+    char c = 0;
+
+    /* A full pipe already means "look at the queue". */
+    while (write(fd, &c, 1) < 0 && errno == EINTR)
+        ;
+}
+
+void NetworkThread::drain(int fd) {
+    char junk[64];
+
+    while (read(fd, junk, sizeof(junk)) > 0)
+        ;
+}
+
+/*
+ * Game thread side
+ */
+
+void NetworkThread::clear_notify() { drain(notify_pipe_[0]); }
+
+void NetworkThread::send(NetMessage &&msg) {
+    if (!overflow_.empty() || !to_io_.push(std::move(msg)))
+        overflow_.push_back(std::move(msg));
+}
+
+bool NetworkThread::send_output(int desc_num, std::string_view bytes) {
+    if (congested())
+        return false;
+
+    /* Counted before the thread can see it, so the count never goes negative. */
+    slots_[desc_num].unsent.fetch_add(bytes.size(), std::memory_order_relaxed);
+    if (!to_io_.push({NET_OUTPUT, desc_num, INVALID_SOCKET, {}, 0, 0, std::string(bytes)})) {
+        slots_[desc_num].unsent.fetch_sub(bytes.size(), std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void NetworkThread::disconnect(int desc_num) { send({NET_CLOSE, desc_num, INVALID_SOCKET, {}, 0, 0, {}}); }
+
+void NetworkThread::adopt(int desc_num, socket_t fd) { send({NET_ADOPT, desc_num, fd, {}, 0, 0, {}}); }
+
+void NetworkThread::wake() {
+    while (!overflow_.empty() && to_io_.push(std::move(overflow_.front())))
+        overflow_.pop_front();
+    poke(wake_pipe_[1]);
+}
+
+/*
+ * I/O thread side
+ */
+
+/* Queue a message for the game, keeping it here if the game has fallen behind. */
+void NetworkThread::post(NetMessage &&msg) {
+    if (!backlog_.empty() || !to_game_.push(std::move(msg)))
+        backlog_.push_back(std::move(msg));
+    posted_ = true;
+}
+
+void NetworkThread::flush_to_game() {
+    while (!backlog_.empty() && to_game_.push(std::move(backlog_.front())))
+        backlog_.pop_front();
+}
+
+void NetworkThread::notify_game() {
+    if (std::exchange(posted_, false))
+        poke(notify_pipe_[1]);
+}
+
+void NetworkThread::run() {
+    PollEvent events[MAX_POLL_EVENTS];
+    NetMessage msg;
+    Connection *conn;
+    sigset_t signals;
+    int i, count;
+
+    /* Signals are for the game thread to handle. */
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    while (!stopping_.load(std::memory_order_acquire)) {
+        flush_to_game();
+
+        /* While the game is behind, check back soon rather than waiting on sockets. */
+        if ((count = poller_->wait(events, MAX_POLL_EVENTS, backlog_.empty() ? -1 : NET_BACKLOG_RETRY_MS)) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("SYSERR: NetworkThread: poll");
+            break;
+        }
+
+        for (i = 0; i < count; ++i) {
+            if (!events[i].data) {
+                if (IS_SET(events[i].events, POLL_READ))
+                    accept_connections();
+            } else if (events[i].data == this)
+                drain(wake_pipe_[0]);
+            else {
+                conn = (Connection *)events[i].data;
+                SET_BIT(conn->events, events[i].events);
+                mark_busy(conn);
+            }
+        }
+
+        while (to_io_.pop(msg))
+            handle_message(msg);
+
+        /*
+         * Readiness is sticky (as in the game loop), but only connections
+         * that became ready or were given output are looked at.  Input is
+         * left in the socket while the game is behind; nothing is lost, and
+         * the client is slowed down instead.  Such a connection stays busy
+         * so it is read once the game catches up.
+         */
+        visiting_.swap(busy_);
+        for (int desc_num : visiting_) {
+            auto found = connections_.find(desc_num);
+            if (found == connections_.end())
+                continue; /* closed since */
+            conn = found->second.get();
+            conn->busy = false;
+            if (conn->lost)
+                continue;
+            if (IS_SET(conn->events, POLL_ERROR)) {
+                lose_connection(conn, "Socket error");
+                continue;
+            }
+            if (IS_SET(conn->events, POLL_WRITE) && !conn->output.empty())
+                write_connection(conn);
+            if (IS_SET(conn->events, POLL_READ) && backlog_.empty())
+                read_connection(conn);
+            if (!conn->lost && IS_SET(conn->events, POLL_READ))
+                mark_busy(conn);
+        }
+        visiting_.clear();
+
+        flush_to_game();
+        notify_game();
+    }
+
+    /* The game thread is waiting in stop(), so this is the last of its messages. */
+    while (to_io_.pop(msg))
+        handle_message(msg);
+    for (auto &[desc_num, conn] : connections_)
+        if (!conn->lost && !conn->output.empty()) {
+            SET_BIT(conn->events, POLL_WRITE);
+            write_connection(conn.get());
+        }
+}
+
+/* Have run() look at the connection on its next pass. */
+void NetworkThread::mark_busy(Connection *conn) {
+    if (!std::exchange(conn->busy, true))
+        busy_.push_back(conn->desc_num);
+}
+
+void NetworkThread::accept_connections() {
+    sockaddr_in peer;
+    socklen_t len;
+    socket_t fd;
+    Connection *conn;
+    int desc_num;
+
+    while (true) {
+        len = sizeof(peer);
+        if ((fd = accept(mother_, (sockaddr *)&peer, &len)) == INVALID_SOCKET) {
+#ifdef EWOULDBLOCK
+            if (errno == EWOULDBLOCK)
+                errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+            if (errno == EINTR)
+                continue;
+            /* Another I/O thread may have taken it: that's fine. */
+            if (errno != EAGAIN)
+                perror("accept");
+            return;
+        }
+        nonblock(fd);
+
+        if (!(desc_num = claim_desc_num())) {
+            write_to_descriptor(fd, "Sorry, FieryMUD is full right now... please try again later!\n");
+            CLOSE_SOCKET(fd);
+            continue;
+        }
+
+        conn = open_connection(desc_num, fd);
+        post({NET_CONNECTED, desc_num, fd, peer.sin_addr, 0, 0, {}});
+        if (!poller_->add(fd, conn))
+            lose_connection(conn, "Unable to watch socket");
+    }
+}
+
+NetworkThread::Connection *NetworkThread::open_connection(int desc_num, socket_t fd) {
+    auto &conn = connections_[desc_num];
+
+    conn = std::make_unique<Connection>();
+    conn->desc_num = desc_num;
+    conn->fd = fd;
+    slots_[desc_num].unsent.store(0, std::memory_order_relaxed);
+    return conn.get();
+}
+
+void NetworkThread::close_connection(Connection *conn) {
+    int desc_num = conn->desc_num;
+
+    if (!conn->lost)
+        poller_->remove(conn->fd);
+    CLOSE_SOCKET(conn->fd);
+    slots_[desc_num].unsent.store(0, std::memory_order_relaxed);
+    connections_.erase(desc_num);
+    slots_[desc_num].taken.store(false, std::memory_order_release);
+}
+
+/*
+ * The socket is no good any more.  It stays open (so its number isn't
+ * reused) until the game, having heard about it, sends NET_CLOSE.
+ */
+void NetworkThread::lose_connection(Connection *conn, std::string_view why) {
+    if (conn->lost)
+        return;
+    conn->lost = true;
+    poller_->remove(conn->fd);
+    conn->output.clear();
+    conn->offset = 0;
+    slots_[conn->desc_num].unsent.store(0, std::memory_order_relaxed);
+    post({NET_LOST, conn->desc_num, INVALID_SOCKET, {}, 0, 0, std::string(why)});
+}
+
+void NetworkThread::read_connection(Connection *conn) {
+    Parser parser(this, conn->desc_num);
+    TelnetInput *tn = &conn->telnet;
+    ssize_t bytes_read;
+
+    while (backlog_.empty()) {
+        bytes_read = read(conn->fd, conn->inbuf + tn->line_len, MAX_RAW_INPUT_LENGTH - tn->line_len);
+        if (bytes_read < 0) {
+#ifdef EWOULDBLOCK
+            if (errno == EWOULDBLOCK)
+                errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
+                REMOVE_BIT(conn->events, POLL_READ);
+            else
+                lose_connection(conn, "process_input: about to lose connection");
+            return;
+        } else if (bytes_read == 0) {
+            lose_connection(conn, "EOF on socket read (connection broken by peer)");
+            return;
+        }
+        parse_telnet(tn, conn->inbuf, bytes_read, parser);
+    }
+}
+
+void NetworkThread::write_connection(Connection *conn) {
+    iovec iov[MAX_OUTPUT_IOVECS];
+    ssize_t bytes_written;
+    std::size_t total, left;
+    int count;
+
+    while (!conn->output.empty()) {
+        total = 0;
+        count = 0;
+        for (auto &chunk : conn->output) {
+            if (count == MAX_OUTPUT_IOVECS)
+                break;
+            iov[count].iov_base = chunk.data() + (count ? 0 : conn->offset);
+            iov[count].iov_len = chunk.size() - (count ? 0 : conn->offset);
+            total += iov[count++].iov_len;
+        }
+
+        if ((bytes_written = writev(conn->fd, iov, count)) < 0) {
+#ifdef EWOULDBLOCK
+            if (errno == EWOULDBLOCK)
+                errno = EAGAIN;
+#endif /* EWOULDBLOCK */
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                REMOVE_BIT(conn->events, POLL_WRITE);
+                poller_->want_write(conn->fd);
+            } else {
+                perror("Write to socket");
+                lose_connection(conn, "Write to socket failed");
+            }
+            return;
+        }
+
+        slots_[conn->desc_num].unsent.fetch_sub(bytes_written, std::memory_order_relaxed);
+        for (left = bytes_written; left > 0;) {
+            if (left < conn->output.front().size() - conn->offset) {
+                conn->offset += left;
+                break;
+            }
+            left -= conn->output.front().size() - conn->offset;
+            conn->output.pop_front();
+            conn->offset = 0;
+        }
+
+        /* A short write means the socket buffer is full. */
+        if ((std::size_t)bytes_written < total) {
+            REMOVE_BIT(conn->events, POLL_WRITE);
+            poller_->want_write(conn->fd);
+            return;
+        }
+    }
+}
+
+void NetworkThread::handle_message(NetMessage &msg) {
+    auto found = connections_.find(msg.desc_num);
+    Connection *conn = found == connections_.end() ? nullptr : found->second.get();
+
+    switch (msg.type) {
+    case NET_OUTPUT:
+        if (conn && !conn->lost) {
+            conn->output.push_back(std::move(msg.text));
+            mark_busy(conn);
+        } else
+            slots_[msg.desc_num].unsent.fetch_sub(msg.text.size(), std::memory_order_relaxed);
+        break;
+    case NET_CLOSE:
+        if (!conn)
+            break;
+        if (!conn->lost && !conn->output.empty())
+            write_connection(conn);
+        close_connection(conn);
+        break;
+    case NET_ADOPT:
+        conn = open_connection(msg.desc_num, msg.fd);
+        if (!poller_->add(msg.fd, conn))
+            lose_connection(conn, "Unable to watch socket");
+        break;
+    }
+}
@@ -0,0 +1,169 @@
+/***************************************************************************
+ *   File: network_thread.h                               Part of FieryMUD *
+ *  Usage: header file: socket I/O threads feeding the game thread         *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include "poller.hpp"
+#include "spsc_queue.hpp"
+#include "structs.hpp"
+#include "sysdep.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Messages from an I/O thread to the game thread */
+#define NET_CONNECTED 0    /* accepted a new socket (fd, addr) */
+#define NET_LINE 1         /* a complete line of input (text) */
+#define NET_LONG_LINE 2    /* the part of an overlong line that fit (text) */
+#define NET_NEGOTIATE 3    /* IAC command option */
+#define NET_SUBNEGOTIATE 4 /* IAC SB option text IAC SE */
+#define NET_ERROR 5        /* something worth logging (text) */
+#define NET_LOST 6         /* the connection broke (text says how) */
+
+/* Messages from the game thread to an I/O thread */
+#define NET_OUTPUT 7 /* finished bytes to write (text) */
+#define NET_CLOSE 8  /* write what can be written, then close */
+#define NET_ADOPT 9  /* take over an open socket (fd), e.g. after a hotboot */
+
+/* Messages each queue holds before the sender has to wait */
+#define NET_QUEUE_SIZE 4096
+
+/* desc_num is always below this, so it can index a table */
+#define MAX_DESC_NUM 1000
+
+struct NetMessage {
+    int type;          /* NET_x */
+    int desc_num;      /* the connection it concerns */
+    socket_t fd;       /* NET_CONNECTED, NET_ADOPT */
+    in_addr addr;      /* NET_CONNECTED */
+    unsigned char command, option;
+    std::string text;
+};
+
+/*
+ * An I/O thread owns a share of the player sockets: it accepts them,
+ * reads them, runs the telnet parser and writes whatever output the game
+ * has finished.  It talks to the game thread only through two lock-free
+ * queues of NetMessages keyed by desc_num, so the game thread never
+ * waits on a socket and the I/O thread never touches a DescriptorData.
+ *
+ * Every I/O thread accepts from the same (non-blocking) mother socket;
+ * whichever thread wins the race owns the connection for its lifetime.
+ * A connection lives until the game sends NET_CLOSE, even if the I/O
+ * thread has already reported it NET_LOST, so a desc_num is never reused
+ * while either side still knows it.
+ */
+class NetworkThread {
+  public:
+    /* mother may be INVALID_SOCKET if this thread should not accept. */
+    explicit NetworkThread(socket_t mother);
+    ~NetworkThread();
+    NetworkThread(const NetworkThread &) = delete;
+    NetworkThread &operator=(const NetworkThread &) = delete;
+
+    /*
+     * Write out everything the game has handed over (as far as the
+     * sockets will take it without waiting) and end the thread.  Sockets
+     * the game hasn't closed are left open, so a hotboot can pass them on.
+     */
+    void stop();
+
+    /* Game thread: the next message, if any. */
+    bool receive(NetMessage &msg) { return to_game_.pop(msg); }
+    /* Game thread: becomes readable when there are messages to receive. */
+    int notify_fd() const { return notify_pipe_[0]; }
+    /* Game thread: call before receive()ing, so no notification is lost. */
+    void clear_notify();
+
+    /* Game thread: hand over finished output.  Returns false (keeping nothing) if the queue is full. */
+    bool send_output(int desc_num, std::string_view bytes);
+    /* Game thread: these never fail; they wait in an overflow list if they must. */
+    void disconnect(int desc_num);
+    void adopt(int desc_num, socket_t fd);
+    /* Game thread: let the I/O thread know about everything sent since the last wake(). */
+    void wake();
+    /* Game thread: whether send_output() may be refused (stop handing over output for now). */
+    bool congested() const { return !overflow_.empty(); }
+
+    /* Output bytes handed over for desc_num that haven't reached its socket yet. */
+    static std::size_t unsent(int desc_num) { return slots_[desc_num].unsent.load(std::memory_order_relaxed); }
+    /* A desc_num not in use by any connection, or 0 if they are all taken. */
+    static int claim_desc_num();
+
+  private:
+    struct Connection {
+        int desc_num;
+        socket_t fd;
+        int events; /* POLL_x readiness not yet acted upon */
+        bool lost;  /* reported NET_LOST; waiting for NET_CLOSE */
+        bool busy;  /* listed in busy_ */
+        TelnetInput telnet;
+        char inbuf[MAX_RAW_INPUT_LENGTH];
+        std::deque<std::string> output; /* handed over but not yet written */
+        std::size_t offset = 0;         /* bytes of output.front() already written */
+    };
+
+    /* Shared by all the threads, indexed by desc_num */
+    struct Slot {
+        std::atomic<bool> taken{false};
+        std::atomic<std::size_t> unsent{0};
+    };
+
+    class Parser;
+
+    void run();
+    void accept_connections();
+    Connection *open_connection(int desc_num, socket_t fd);
+    void close_connection(Connection *conn);
+    void lose_connection(Connection *conn, std::string_view why);
+    void read_connection(Connection *conn);
+    void write_connection(Connection *conn);
+    void handle_message(NetMessage &msg);
+    void mark_busy(Connection *conn);
+    void post(NetMessage &&msg);
+    void flush_to_game();
+    void notify_game();
+    static void poke(int fd);
+    static void drain(int fd);
+    void send(NetMessage &&msg);
+
+    socket_t mother_;
+    std::unique_ptr<DescriptorPoller> poller_;
+    int wake_pipe_[2];   /* the game thread signals this thread */
+    int notify_pipe_[2]; /* this thread signals the game thread */
+    std::atomic<bool> stopping_{false};
+
+    SpscQueue<NetMessage, NET_QUEUE_SIZE> to_game_;
+    SpscQueue<NetMessage, NET_QUEUE_SIZE> to_io_;
+
+    /* I/O thread only */
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::deque<NetMessage> backlog_; /* for the game, waiting for room in to_game_ */
+    std::vector<int> busy_;          /* desc_nums of connections with something to do */
+    std::vector<int> visiting_;      /* busy_ as run() takes it, kept for its capacity */
+    bool posted_ = false;            /* something was queued since the game was notified */
+
+    /* Game thread only */
+    std::deque<NetMessage> overflow_; /* for this thread, waiting for room in to_io_ */
+
+    std::thread thread_;
+
+    static Slot slots_[MAX_DESC_NUM];
+    static std::atomic<int> last_desc_num_;
+};
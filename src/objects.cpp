@@ -212,6 +212,7 @@ bool delete_object(obj_num rnum) {
     top_of_objt--;
     RECREATE(obj_index, IndexData, top_of_objt + 1);
     RECREATE(obj_proto, ObjData, top_of_objt + 1);
+    build_object_index();
 
     /* Renumber shop products. */
     printf("top_shop is %d\n", top_shop);
@@ -253,6 +254,7 @@ bool delete_object(obj_num rnum) {
             olc_add_to_save_list(zone_table[zone].number, OLC_SAVE_ZONE);
         }
     }
+    invalidate_zone_programs();
 
     olc_add_to_save_list(zone_table[zrnum].number, OLC_SAVE_OBJ);
 
@@ -93,7 +93,7 @@ struct ObjData {
     SpellBookList *spell_book; /* list of all spells in book if obj is spellbook */
 
     CharData *casters; /* Characters who are casting spells at this */
-    Event *events;     /* List of events related to this object */
+    EventList events;  /* List of events related to this object */
     int event_flags[EVENT_FLAG_FIELDS];
     /* Bitfield of events active on this object */
 };
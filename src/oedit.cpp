@@ -34,6 +34,7 @@
 #include "string_utils.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
 
 /* external variables */
@@ -199,6 +200,7 @@ void oedit_save_internally(DescriptorData *d) {
 #endif
             obj_index = new_obj_index;
             obj_proto = new_obj_proto;
+            build_object_index();
             /*. Renumber live objects . */
             for (obj = object_list; obj; obj = obj->next)
                 if (GET_OBJ_RNUM(obj) != NOTHING && GET_OBJ_RNUM(obj) >= robj_num)
@@ -225,6 +227,7 @@ void oedit_save_internally(DescriptorData *d) {
                             ZCMD.arg2--;
                         break;
                     }
+            invalidate_zone_programs();
 
             /*. Renumber shop produce . */
             for (shop = 0; shop < top_shop; shop++)
@@ -264,6 +267,7 @@ void oedit_save_internally(DescriptorData *d) {
                     obj->contains = swap->contains;
                     obj->next_content = swap->next_content;
                     obj->next = swap->next;
+                    obj->id = swap->id;
                     obj->proto_script = OLC_SCRIPT(d);
                 }
             }
@@ -348,6 +352,7 @@ void oedit_save_internally(DescriptorData *d) {
         obj_proto = new_obj_proto;
         obj_index = new_obj_index;
         top_of_objt++;
+        build_object_index();
 
         /*. Renumber live objects . */
         for (obj = object_list; obj; obj = obj->next)
@@ -375,6 +380,7 @@ void oedit_save_internally(DescriptorData *d) {
                         ZCMD.arg2++;
                     break;
                 }
+        invalidate_zone_programs();
 
         /*. Renumber shop produce . */
         for (shop = 0; shop < top_shop; shop++)
@@ -1261,6 +1267,7 @@ void oedit_parse(DescriptorData *d, char *arg) {
                     GET_NAME(d->character), OLC_IOBJ(d)->short_description);
                 REMOVE_FLAG(PLR_FLAGS(d->character), PLR_WRITING);
                 STATE(d) = CON_PLAYING;
+                update_zone_occupancy(d);
             } else {
                 char_printf(d->character, "Saving object to memory.\n");
                 oedit_save_internally(d);
@@ -1728,6 +1735,7 @@ void iedit_setup_existing(DescriptorData *d, ObjData *obj) {
     /* So there's no way for this obj to get extracted (by point_update
      * for example) */
     REMOVE_FROM_LIST(obj, object_list, next);
+    obj_uids.remove(GET_ID(obj), obj);
 
     /* free any assigned scripts */
     if (SCRIPT(obj))
@@ -1789,4 +1797,5 @@ ACMD(do_iedit) {
     act("$n starts using OLC.", true, ch, 0, 0, TO_ROOM);
 
     STATE(ch->desc) = CON_IEDIT;
+    update_zone_occupancy(ch->desc);
 }
@@ -28,6 +28,7 @@
 #include "skills.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
+#include "uid_table.hpp"
 #include "utils.hpp"
 
 const char *nrm, *grn, *cyn, *yel, *blk, *red;
@@ -546,6 +547,7 @@ ACMD(do_olc) {
         return;
     }
 
+    update_zone_occupancy(d);
     act("$n starts using OLC.", true, d->character, 0, 0, TO_ROOM);
     SET_FLAG(PLR_FLAGS(ch), PLR_WRITING);
 }
@@ -673,6 +675,7 @@ void cleanup_olc(DescriptorData *d, byte cleanup_type) {
         if (OLC_IOBJ(d)) {
             OLC_IOBJ(d)->next = object_list;
             object_list = OLC_IOBJ(d);
+            obj_uids.add(GET_ID(OLC_IOBJ(d)), OLC_IOBJ(d));
             if (d->character)
                 obj_to_char(OLC_IOBJ(d), d->character);
         }
@@ -754,6 +757,7 @@ void cleanup_olc(DescriptorData *d, byte cleanup_type) {
         if (d->character) {
             REMOVE_FLAG(PLR_FLAGS(d->character), PLR_WRITING);
             STATE(d) = CON_PLAYING;
+            update_zone_occupancy(d);
             act("$n stops using OLC.", true, d->character, 0, 0, TO_ROOM);
         }
         free(d->olc);
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   File: output_queue.c                                 Part of FieryMUD *
+ *  Usage: pending descriptor output, shared or private                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "output_queue.hpp"
+
+#include <algorithm>
+
+void OutputQueue::append(std::string_view text) {
+    if (text.empty())
+        return;
+
+    /* Private text can simply be tacked onto a private tail. */
+    if (segments_.empty() || segments_.back().shared)
+        segments_.push_back({nullptr, std::string(text), 0});
+    else
+        segments_.back().own += text;
+    size_ += text.size();
+}
+
+void OutputQueue::append(SharedText text) {
+    if (!text || text->empty())
+        return;
+
+    size_ += text->size();
+    segments_.push_back({std::move(text), {}, 0});
+}
+
+int OutputQueue::peek(iovec *iov, int max) const {
+    int count = 0;
+
+    for (auto it = segments_.begin(); it != segments_.end() && count < max; ++it, ++count) {
+        auto text = it->text();
+        iov[count].iov_base = const_cast<char *>(text.data());
+        iov[count].iov_len = text.size();
+    }
+
+    return count;
+}
+
+void OutputQueue::consume(std::size_t len) {
+    len = std::min(len, size_);
+    size_ -= len;
+
+    while (len) {
+        auto &front = segments_.front();
+        std::size_t left = front.text().size();
+
+        if (len < left) {
+            front.offset += len;
+            return;
+        }
+        len -= left;
+        segments_.pop_front();
+    }
+}
+
+void OutputQueue::clear() {
+    segments_.clear();
+    size_ = 0;
+}
+
+std::string OutputQueue::str() const {
+    std::string all;
+
+    all.reserve(size_);
+    for (const auto &segment : segments_)
+        all += segment.text();
+    return all;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   File: output_queue.h                                 Part of FieryMUD *
+ *  Usage: header file: pending descriptor output, shared or private       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+
+#define MAX_OUTPUT_IOVECS 16 /* queued segments handed to one writev() */
+
+/* Processed text that several descriptors may have queued at once. */
+using SharedText = std::shared_ptr<const std::string>;
+
+/*
+ * The output a descriptor has accumulated during this pulse, in order.
+ * Text sent to just this descriptor is copied in; broadcast text is held
+ * by reference, so a message sent to a whole room exists only once no
+ * matter how many people are waiting to receive it.
+ */
+class OutputQueue {
+  public:
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+
+    /* Append text for this descriptor only. */
+    void append(std::string_view text);
+    /* Append a broadcast without copying it. */
+    void append(SharedText text);
+
+    /* Fill up to max iovecs with the queued bytes in order; returns the count. */
+    int peek(iovec *iov, int max) const;
+    /* Discard up to len bytes from the front. */
+    void consume(std::size_t len);
+    void clear();
+
+    /* The whole queue as one string (for snooping). */
+    std::string str() const;
+
+  private:
+    struct Segment {
+        SharedText shared;  /* set for a broadcast */
+        std::string own;    /* otherwise the text lives here */
+        std::size_t offset; /* bytes already consumed */
+
+        std::string_view text() const {
+            return std::string_view(shared ? *shared : own).substr(offset);
+        }
+    };
+
+    std::deque<Segment> segments_;
+    std::size_t size_ = 0;
+};
@@ -174,7 +174,7 @@ static bool write_object_record(ObjData *obj, FILE *fl, int location) {
     ExtraDescriptionData *desc;
     SpellBookList *spell;
     TrigData *trig;
-    TriggerVariableData *var;
+    char value[MAX_INPUT_LENGTH];
 
     fprintf(fl, "vnum: %d\n", GET_OBJ_VNUM(obj));
     fprintf(fl, "location: %d\n", location);
@@ -248,9 +248,9 @@ static bool write_object_record(ObjData *obj, FILE *fl, int location) {
         /* Global variables */
         if (SCRIPT(obj)->global_vars) {
             fprintf(fl, "variables:\n");
-            for (var = SCRIPT(obj)->global_vars; var; var = var->next)
-                if (*var->name != '~')
-                    fprintf(fl, "%s %s\n", var->name, filter_chars(buf, var->value, "\n"));
+            for (const ScriptVariable &var : *SCRIPT(obj)->global_vars)
+                if (*var.name != '~')
+                    fprintf(fl, "%s %s\n", var.name, filter_chars(buf, var.text(value), "\n"));
             fprintf(fl, "~\n");
         }
     }
@@ -765,6 +765,7 @@ bool build_object(FILE *fl, ObjData **objp, int *location) {
                         if (num != NOTHING && (trig = read_trigger(num)))
                             add_trigger(SCRIPT(obj), trig, -1);
                     }
+                    list_random_script(obj, OBJ_TRIGGER);
                 } else
                     goto bad_tag;
                 break;
@@ -43,6 +43,8 @@
 #include "utils.hpp"
 
 #include <algorithm>
+#include <string>
+#include <unordered_map>
 
 /* local functions */
 static void load_effects(FILE *fl, CharData *ch);
@@ -167,10 +169,77 @@ void reset_weight(CharData *ch) {
         IS_CARRYING_W(ch) += calculate_object_weight(obj);
 }
 
+/*
+ * The player index file is a log.  Each line is either one player's
+ * whole entry ("id name level flags last") or a deletion ("-id"), and
+ * when it's read back, a later line for an id replaces the earlier
+ * ones.  A change to one player is appended as a single line, and once
+ * the log is more than twice as long as the index it's compacted by
+ * rewriting it with one line per player.
+ */
+#define PINDEX_COMPACT_MIN 1000 /* don't bother compacting shorter logs */
+
+static int ptable_allocated = 0; /* entries allocated in player_table */
+static int pindex_log_lines = 0; /* lines in the player index file */
+
+/*
+ * Lookups into player_table by lowercased name and by id.  Whatever
+ * changes a name or id in player_table has to update these.
+ */
+static std::unordered_map<std::string, int> ptable_by_name;
+static std::unordered_map<long, int> ptable_by_id;
+
+static std::string ptable_key(const char *name) {
+    std::string key{name};
+
+    for (auto &c : key)
+        c = LOWER(c);
+    return key;
+}
+
+static void index_ptable_entry(int pos) {
+    if (*player_table[pos].name)
+        ptable_by_name.emplace(ptable_key(player_table[pos].name), pos);
+    if (player_table[pos].id)
+        ptable_by_id.emplace(player_table[pos].id, pos);
+}
+
+static void unindex_ptable_name(int pos) {
+    if (!player_table[pos].name)
+        return;
+
+    auto it = ptable_by_name.find(ptable_key(player_table[pos].name));
+
+    if (it != ptable_by_name.end() && it->second == pos)
+        ptable_by_name.erase(it);
+}
+
+/* Rebuild the name and id lookups, e.g. after player_table is replaced. */
+void index_player_table(void) {
+    int i;
+
+    ptable_by_name.clear();
+    ptable_by_id.clear();
+    for (i = 0; i <= top_of_p_table; i++)
+        index_ptable_entry(i);
+
+    /* The table may be new, so only count on room for what's in it. */
+    ptable_allocated = top_of_p_table + 1;
+}
+
+static void write_ptable_entry(FILE *fl, int pos) {
+    char bits[64];
+
+    sprintascii(bits, player_table[pos].flags);
+    fprintf(fl, "%ld %s %d %s %ld\n", player_table[pos].id, player_table[pos].name, player_table[pos].level,
+            *bits ? bits : "0", (long)player_table[pos].last);
+}
+
 /* New version to build player index for ASCII Player Files. Generate index
  * table for the player file. */
 void build_player_index(void) {
-    int rec_count = 0, i;
+    int rec_count = 0, i, pos;
+    long id;
     FILE *plr_index;
     char index_name[40], line[256], bits[65];
     char name[80];
@@ -183,28 +252,68 @@ void build_player_index(void) {
     }
 
     while (get_line(plr_index, line))
-        if (*line != '~')
+        if (*line != '~' && *line != '-')
             rec_count++;
     rewind(plr_index);
 
     if (rec_count == 0) {
+        fclose(plr_index);
         player_table = nullptr;
         top_of_p_table = -1;
         return;
     }
 
     CREATE(player_table, PlayerIndexElement, rec_count);
-    for (i = 0; i < rec_count; i++) {
-        get_line(plr_index, line);
-        sscanf(line, "%ld %s %d %s %ld", &player_table[i].id, name, &player_table[i].level, bits,
-               (long *)&player_table[i].last);
-        player_table[i].name = strdup(name);
-        player_table[i].flags = asciiflag_conv(bits);
-        top_idnum = std::max(top_idnum, player_table[i].id);
+    top_of_p_table = -1;
+    ptable_by_id.clear();
+    pindex_log_lines = 0;
+
+    while (get_line(plr_index, line)) {
+        if (*line == '~') /* end of an index written before it was a log */
+            continue;
+        pindex_log_lines++;
+
+        if (*line == '-') {
+            id = atol(line + 1);
+            if (auto it = ptable_by_id.find(id); it != ptable_by_id.end())
+                *player_table[it->second].name = '\0';
+            top_idnum = std::max(top_idnum, id);
+            continue;
+        }
+
+        *name = '\0';
+        id = 0;
+        sscanf(line, "%ld %s", &id, name);
+        if (auto it = ptable_by_id.find(id); id && it != ptable_by_id.end()) {
+            pos = it->second;
+            free(player_table[pos].name);
+        } else {
+            pos = ++top_of_p_table;
+            if (id)
+                ptable_by_id[id] = pos;
+        }
+        sscanf(line, "%ld %s %d %s %ld", &player_table[pos].id, name, &player_table[pos].level, bits,
+               (long *)&player_table[pos].last);
+        player_table[pos].name = strdup(name);
+        player_table[pos].flags = asciiflag_conv(bits);
+        top_idnum = std::max(top_idnum, player_table[pos].id);
     }
 
     fclose(plr_index);
-    top_of_p_file = top_of_p_table = i - 1;
+
+    /* Nothing refers to positions yet, so squeeze out deleted players. */
+    for (i = pos = 0; i <= top_of_p_table; i++)
+        if (*player_table[i].name)
+            player_table[pos++] = player_table[i];
+        else
+            free(player_table[i].name);
+    top_of_p_file = top_of_p_table = pos - 1;
+
+    index_player_table();
+    ptable_allocated = rec_count;
+
+    if (pindex_log_lines > PINDEX_COMPACT_MIN && pindex_log_lines > 2 * (top_of_p_table + 1))
+        save_player_index();
 }
 
 /* Create a new entry in the in-memory index table for the player file. If the
@@ -213,14 +322,15 @@ void build_player_index(void) {
 int create_player_index_entry(char *name) {
     int i, pos;
 
-    if (top_of_p_table == -1) { /* no table */
-        pos = top_of_p_table = 0;
-        CREATE(player_table, PlayerIndexElement, 1);
-    } else if ((pos = get_ptable_by_name(name)) == -1) { /* new name */
-        i = ++top_of_p_table + 1;
-
-        RECREATE(player_table, PlayerIndexElement, i);
-        pos = top_of_p_table;
+    if ((pos = get_ptable_by_name(name)) >= 0) /* existing name */
+        unindex_ptable_name(pos);
+    else { /* new name */
+        pos = ++top_of_p_table;
+        if (pos >= ptable_allocated) {
+            ptable_allocated = std::max(16, ptable_allocated * 2);
+            RECREATE(player_table, PlayerIndexElement, ptable_allocated);
+        }
+        player_table[pos] = {};
     }
 
     CREATE(player_table[pos].name, char, strlen(name) + 1);
@@ -234,28 +344,63 @@ int create_player_index_entry(char *name) {
     /* clear the bitflag in case we have garbage data */
     player_table[pos].flags = 0;
 
+    index_ptable_entry(pos);
+
     return (pos);
 }
 
-/* This function necessary to save a seperate ASCII player index */
+/* Rewrite the whole player index, with one line per player. */
 void save_player_index(void) {
     int i;
-    char index_name[50], bits[64];
+    char index_name[50], temp_name[60];
     FILE *index_file;
 
     sprintf(index_name, "%s/%s", PLR_PREFIX, INDEX_FILE);
-    if (!(index_file = fopen(index_name, "w"))) {
+    sprintf(temp_name, "%s.new", index_name);
+    if (!(index_file = fopen(temp_name, "w"))) {
         log("SYSERR: Could not write player index file");
         return;
     }
 
+    pindex_log_lines = 0;
     for (i = 0; i <= top_of_p_table; i++)
         if (*player_table[i].name) {
-            sprintascii(bits, player_table[i].flags);
-            fprintf(index_file, "%ld %s %d %s %ld\n", player_table[i].id, player_table[i].name, player_table[i].level,
-                    *bits ? bits : "0", (long)player_table[i].last);
+            write_ptable_entry(index_file, i);
+            pindex_log_lines++;
         }
-    fprintf(index_file, "~\n");
+
+    if (fclose(index_file))
+        log("SYSERR: Error closing player index file after write");
+    else if (rename(temp_name, index_name))
+        log("SYSERR: Error renaming player index file after write");
+}
+
+/* Append the current state of one player's index entry to the index file. */
+void save_player_index_entry(int pos) {
+    char index_name[50];
+    FILE *index_file;
+
+    /*
+     * A line without an id can't be replaced by a later one, so those
+     * changes have to rewrite the file; so does a log that's too long.
+     */
+    if (!player_table[pos].id ||
+        (pindex_log_lines >= PINDEX_COMPACT_MIN && pindex_log_lines >= 2 * (top_of_p_table + 1))) {
+        save_player_index();
+        return;
+    }
+
+    sprintf(index_name, "%s/%s", PLR_PREFIX, INDEX_FILE);
+    if (!(index_file = fopen(index_name, "a"))) {
+        log("SYSERR: Could not append to player index file");
+        return;
+    }
+
+    if (*player_table[pos].name)
+        write_ptable_entry(index_file, pos);
+    else
+        fprintf(index_file, "-%ld\n", player_table[pos].id);
+    pindex_log_lines++;
 
     fclose(index_file);
 }
@@ -273,36 +418,29 @@ void free_player_index(void) {
     free(player_table);
     player_table = nullptr;
     top_of_p_table = 0;
+    ptable_allocated = 0;
+    ptable_by_name.clear();
+    ptable_by_id.clear();
 }
 
 long get_ptable_by_name(const char *name) {
-    int i;
-
-    for (i = 0; i <= top_of_p_table; i++)
-        if (is_equals(player_table[i].name, name))
-            return (i);
+    auto it = ptable_by_name.find(ptable_key(name));
 
-    return (-1);
+    return it == ptable_by_name.end() ? -1 : it->second;
 }
 
 long get_id_by_name(const char *name) {
-    int i;
-
-    for (i = 0; i <= top_of_p_table; i++)
-        if (is_equals(player_table[i].name, name))
-            return (player_table[i].id);
+    long pos = get_ptable_by_name(name);
 
-    return (-1);
+    return pos < 0 ? -1 : player_table[pos].id;
 }
 
 char *get_name_by_id(long id) {
-    int i;
-
-    for (i = 0; i <= top_of_p_table; i++)
-        if (player_table[i].id == id)
-            return (player_table[i].name && *player_table[i].name ? player_table[i].name : nullptr);
+    auto it = ptable_by_id.find(id);
 
-    return (nullptr);
+    if (it == ptable_by_id.end())
+        return (nullptr);
+    return (*player_table[it->second].name ? player_table[it->second].name : nullptr);
 }
 /* Stuff related to the save/load player system. */
 /* New load_char reads ASCII Player Files. Load a char, true if loaded, false if not. */
@@ -1064,7 +1202,7 @@ void save_player_char(CharData *ch) {
         REMOVE_BIT(player_table[id].flags, PINDEX_FROZEN);
 
     if (player_table[id].flags != i || save_index)
-        save_player_index();
+        save_player_index_entry(id);
 
     log("Saved player {}.", GET_NAME(ch));
 }
@@ -1084,8 +1222,9 @@ void delete_player(int pfilepos) {
         if (get_pfilename(player_table[pfilepos].name, fname, i))
             unlink(fname);
 
+    unindex_ptable_name(pfilepos);
     player_table[pfilepos].name[0] = '\0';
-    save_player_index();
+    save_player_index_entry(pfilepos);
 }
 
 void rename_player(CharData *victim, char *newname) {
@@ -1098,9 +1237,12 @@ void rename_player(CharData *victim, char *newname) {
 
     cap_by_color(newname);
 
+    unindex_ptable_name(pfilepos);
     if (player_table[pfilepos].name)
         free(player_table[pfilepos].name);
     player_table[pfilepos].name = strdup(newname);
+    index_ptable_entry(pfilepos);
+    save_player_index_entry(pfilepos);
 
     /* Rename all player-owned files */
     for (i = 0; i < NUM_PLR_FILES; i++) {
@@ -1335,6 +1477,7 @@ void init_player(CharData *ch) {
     GET_AC(ch) = 100;
 
     player_table[GET_PFILEPOS(ch)].id = GET_IDNUM(ch) = ++top_idnum;
+    ptable_by_id[GET_IDNUM(ch)] = GET_PFILEPOS(ch);
 
     for (i = 1; i < TOP_SKILL; ++i)
         SET_SKILL(ch, i, GET_LEVEL(ch) == LVL_IMPL ? 1000 : 0);
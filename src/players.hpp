@@ -35,6 +35,8 @@ void reset_weight(CharData *ch);
 void build_player_index(void);
 int create_player_index_entry(char *name);
 void save_player_index(void);
+void save_player_index_entry(int pos);
+void index_player_table(void);
 void free_player_index(void);
 
 long get_ptable_by_name(const char *name);
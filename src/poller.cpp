@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   File: poller.c                                       Part of FieryMUD *
+ *  Usage: epoll and select() backends for socket readiness                *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "poller.hpp"
+
+#include "logging.hpp"
+#include "sysdep.hpp"
+
+#include <algorithm>
+#include <map>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+#ifdef HAVE_SYS_EPOLL_H
+/*
+ * Edge-triggered epoll.  Each socket is registered once, and a wait
+ * costs time proportional to the number of ready sockets rather than
+ * the number of connections.
+ */
+class EpollPoller : public DescriptorPoller {
+  public:
+    explicit EpollPoller(int epfd) : epfd_(epfd) {}
+    ~EpollPoller() override { close(epfd_); }
+
+    bool add(socket_t desc, void *data) override {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        ev.data.ptr = data;
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, desc, &ev) < 0) {
+            perror("epoll_ctl add");
+            return false;
+        }
+        return true;
+    }
+
+    void remove(socket_t desc) override {
+        epoll_event ev{}; /* Pre-2.6.9 kernels insist on a non-null event */
+        if (epoll_ctl(epfd_, EPOLL_CTL_DEL, desc, &ev) < 0 && errno != EBADF && errno != ENOENT)
+            perror("epoll_ctl del");
+    }
+
+    int wait(PollEvent *events, int max_events, int timeout_ms) override {
+        epoll_event ready[MAX_POLL_EVENTS];
+        int i, count;
+
+        if ((count = epoll_wait(epfd_, ready, std::min(max_events, MAX_POLL_EVENTS), timeout_ms)) < 0)
+            return -1;
+
+        for (i = 0; i < count; ++i) {
+            events[i].data = ready[i].data.ptr;
+            events[i].events = 0;
+            if (ready[i].events & EPOLLIN)
+                events[i].events |= POLL_READ;
+            if (ready[i].events & EPOLLOUT)
+                events[i].events |= POLL_WRITE;
+            if (ready[i].events & (EPOLLERR | EPOLLHUP))
+                events[i].events |= POLL_ERROR;
+        }
+        return count;
+    }
+
+    std::string_view name() const override { return "epoll"; }
+
+  private:
+    int epfd_;
+};
+#endif
+
+/*
+ * The traditional select() loop, kept for systems without epoll.  The
+ * fd_sets still have to be rebuilt on every wait, and descriptors at or
+ * above FD_SETSIZE cannot be watched at all.
+ *
+ * A connected socket is nearly always writable, so watching every one
+ * for output would make select() return at once, every time.  Instead a
+ * socket is watched for output only until it has been reported writable:
+ * once when it is added, and again after each want_write().  That is the
+ * edge the epoll poller reports.
+ */
+class SelectPoller : public DescriptorPoller {
+  public:
+    bool add(socket_t desc, void *data) override {
+        if (desc < 0 || desc >= FD_SETSIZE) {
+            log("SYSERR: select() cannot watch descriptor {:d} (FD_SETSIZE is {:d})", desc, FD_SETSIZE);
+            return false;
+        }
+        watched_[desc] = {data, true};
+        return true;
+    }
+
+    void remove(socket_t desc) override { watched_.erase(desc); }
+
+    void want_write(socket_t desc) override {
+        auto found = watched_.find(desc);
+
+        if (found != watched_.end())
+            found->second.want_write = true;
+    }
+
+    int wait(PollEvent *events, int max_events, int timeout_ms) override {
+        fd_set input_set, output_set, exc_set;
+        timeval timeout, *timeout_ptr = nullptr;
+        int count = 0, maxdesc = -1;
+
+        FD_ZERO(&input_set);
+        FD_ZERO(&output_set);
+        FD_ZERO(&exc_set);
+        for (auto &[desc, watched] : watched_) {
+            FD_SET(desc, &input_set);
+            if (watched.want_write)
+                FD_SET(desc, &output_set);
+            FD_SET(desc, &exc_set);
+            maxdesc = std::max(maxdesc, desc);
+        }
+
+        if (timeout_ms >= 0) {
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_usec = (timeout_ms % 1000) * 1000;
+            timeout_ptr = &timeout;
+        }
+
+        if (select(maxdesc + 1, &input_set, &output_set, &exc_set, timeout_ptr) < 0)
+            return -1;
+
+        for (auto &[desc, watched] : watched_) {
+            int ready = 0;
+            if (FD_ISSET(desc, &input_set))
+                ready |= POLL_READ;
+            if (FD_ISSET(desc, &output_set))
+                ready |= POLL_WRITE;
+            if (FD_ISSET(desc, &exc_set))
+                ready |= POLL_ERROR;
+            if (!ready)
+                continue;
+            if (count >= max_events)
+                break;
+            if (ready & POLL_WRITE)
+                watched.want_write = false;
+            events[count].data = watched.data;
+            events[count].events = ready;
+            ++count;
+        }
+        return count;
+    }
+
+    std::string_view name() const override { return "select"; }
+
+  private:
+    struct Watched {
+        void *data;
+        bool want_write; /* watch for output until reported writable */
+    };
+
+    std::map<socket_t, Watched> watched_;
+};
+
+std::unique_ptr<DescriptorPoller> make_descriptor_poller() {
+#ifdef HAVE_SYS_EPOLL_H
+    int epfd;
+
+    /* Close-on-exec so the epoll instance doesn't leak across a hotboot. */
+    if ((epfd = epoll_create1(EPOLL_CLOEXEC)) >= 0)
+        return std::make_unique<EpollPoller>(epfd);
+    perror("epoll_create1");
+    log("SYSERR: Unable to create epoll instance; falling back to select().");
+#endif
+    return std::make_unique<SelectPoller>();
+}
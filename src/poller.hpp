@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   File: poller.h                                       Part of FieryMUD *
+ *  Usage: header file: socket readiness multiplexing for the game loop    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include "sysdep.hpp"
+
+#include <memory>
+#include <string_view>
+
+/* Readiness bits reported by DescriptorPoller::wait() */
+#define POLL_READ (1 << 0)  /* data (or a new connection) is waiting   */
+#define POLL_WRITE (1 << 1) /* the socket can accept more output       */
+#define POLL_ERROR (1 << 2) /* error or hangup: the socket should go   */
+
+/* Most events a single call to DescriptorPoller::wait() will return */
+#define MAX_POLL_EVENTS 256
+
+struct PollEvent {
+    void *data; /* pointer registered with the socket */
+    int events; /* POLL_x bits */
+};
+
+/*
+ * A DescriptorPoller watches a set of sockets and reports which ones
+ * are ready.  Sockets are registered once when they are opened and
+ * removed just before they are closed, so the game loop never rebuilds
+ * its interest set.
+ *
+ * Readiness is reported edge-style: a socket is only returned when it
+ * becomes ready, so the caller must remember the POLL_x bits itself and
+ * read (or write) until the operation would block before clearing them.
+ */
+class DescriptorPoller {
+  public:
+    virtual ~DescriptorPoller() = default;
+
+    /* Start watching a socket.  Returns false if it cannot be watched. */
+    virtual bool add(socket_t desc, void *data) = 0;
+    /* Stop watching a socket.  Must be called before it is closed. */
+    virtual void remove(socket_t desc) = 0;
+    /*
+     * The socket wouldn't take all its output, so the caller cleared
+     * POLL_WRITE and waits to hear it is writable again.  Edge-triggered
+     * pollers report that anyway; select() only watches for it when asked.
+     */
+    virtual void want_write(socket_t desc) {}
+    /*
+     * Wait up to timeout_ms milliseconds (forever if negative) for any
+     * socket to become ready.  Returns the number of events stored, or
+     * -1 with errno set.
+     */
+    virtual int wait(PollEvent *events, int max_events, int timeout_ms) = 0;
+    virtual std::string_view name() const = 0;
+};
+
+/* Returns an epoll-based poller where available, otherwise select(). */
+std::unique_ptr<DescriptorPoller> make_descriptor_poller();
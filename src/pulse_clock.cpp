@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   File: pulse_clock.c                                  Part of FieryMUD *
+ *  Usage: drift-free scheduling of game pulses                            *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "pulse_clock.hpp"
+
+#include "conf.hpp"
+#include "sysdep.hpp"
+
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+PulseClock::PulseClock(microseconds period) : period_(period), timer_fd_(-1) {
+#ifdef HAVE_SYS_TIMERFD_H
+    /*
+     * steady_clock is CLOCK_MONOTONIC, so deadlines can be handed to the
+     * timer as they are.  Close-on-exec so it doesn't leak across a hotboot.
+     */
+    if ((timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0)
+        perror("timerfd_create");
+#endif
+    restart();
+}
+
+PulseClock::~PulseClock() {
+    if (timer_fd_ >= 0)
+        close(timer_fd_);
+}
+
+void PulseClock::arm() {
+#ifdef HAVE_SYS_TIMERFD_H
+    itimerspec when{};
+    auto since_epoch = deadline_.time_since_epoch();
+    auto secs = duration_cast<std::chrono::seconds>(since_epoch);
+
+    if (timer_fd_ < 0)
+        return;
+    when.it_value.tv_sec = secs.count();
+    when.it_value.tv_nsec = duration_cast<std::chrono::nanoseconds>(since_epoch - secs).count();
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &when, nullptr) < 0)
+        perror("timerfd_settime");
+#endif
+}
+
+void PulseClock::acknowledge() {
+    unsigned long long expirations;
+
+    while (timer_fd_ >= 0 && read(timer_fd_, &expirations, sizeof(expirations)) < 0 && errno == EINTR)
+        ;
+}
+
+int PulseClock::wait_ms() const {
+    auto left = deadline_ - Clock::now();
+
+    if (left <= Clock::duration::zero())
+        return 0;
+    if (timer_fd_ >= 0)
+        return -1;
+    /* Round up: waking early would only mean waiting again. */
+    return (duration_cast<microseconds>(left).count() + 999) / 1000;
+}
+
+int PulseClock::begin_pulse() {
+    auto late = (started_ = Clock::now()) - deadline_;
+    int due = 1;
+
+    if (late > Clock::duration::zero()) {
+        lateness_.record(duration_cast<nanoseconds>(late));
+        due += late / period_;
+    } else
+        lateness_.record(nanoseconds(0));
+
+    ++pulses_;
+    missed_ += due - 1;
+    deadline_ += due * period_;
+    arm();
+    return due;
+}
+
+void PulseClock::end_pulse() {
+    auto took = Clock::now() - started_;
+
+    processing_.record(duration_cast<nanoseconds>(took));
+    if (took > period_)
+        ++overruns_;
+}
+
+void PulseClock::pause() {
+#ifdef HAVE_SYS_TIMERFD_H
+    itimerspec never{};
+
+    if (timer_fd_ >= 0)
+        timerfd_settime(timer_fd_, 0, &never, nullptr);
+#endif
+}
+
+void PulseClock::restart() {
+    deadline_ = Clock::now() + period_;
+    arm();
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   File: pulse_clock.h                                  Part of FieryMUD *
+ *  Usage: header file: drift-free scheduling of game pulses               *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include "latency_histogram.hpp"
+
+#include <chrono>
+
+/*
+ * When the next pulse is due, on the monotonic clock so that setting the
+ * system time can't stall or rush the game.  Each deadline is a whole
+ * number of periods after the one before, however late a pulse starts,
+ * so the schedule never drifts.
+ *
+ * Where timerfd is available the deadline is an absolute timer that the
+ * game loop waits on along with the sockets; otherwise wait_ms() says
+ * how long to wait.  Either way, how late each pulse started and how
+ * long its work took are kept in histograms.
+ */
+class PulseClock {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit PulseClock(std::chrono::microseconds period);
+    ~PulseClock();
+    PulseClock(const PulseClock &) = delete;
+    PulseClock &operator=(const PulseClock &) = delete;
+
+    /* Becomes readable when the pulse is due, or -1 if there is no timerfd. */
+    int fd() const { return timer_fd_; }
+    /* Call when fd() is readable. */
+    void acknowledge();
+
+    bool due() const { return Clock::now() >= deadline_; }
+    /* How long to wait for the pulse: -1 means until fd() is readable. */
+    int wait_ms() const;
+
+    /*
+     * The pulse is starting.  Returns the number of pulses due, which is
+     * more than one if whole periods went by unnoticed.
+     */
+    int begin_pulse();
+    /* The pulse's work is done. */
+    void end_pulse();
+    /* Stop the timer (while nobody is connected). */
+    void pause();
+    /* Start the schedule over, with the next pulse one period from now. */
+    void restart();
+
+    /* When a pulse of the latest batch was due: the last one, or the one `behind` pulses before it. */
+    Clock::time_point due_at(int behind) const { return deadline_ - (behind + 1) * period_; }
+
+    const LatencyHistogram &lateness() const { return lateness_; }
+    const LatencyHistogram &processing() const { return processing_; }
+    unsigned long pulses() const { return pulses_; }
+    unsigned long missed() const { return missed_; }
+    unsigned long overruns() const { return overruns_; }
+    const char *name() const { return timer_fd_ >= 0 ? "timerfd" : "poll timeout"; }
+
+  private:
+    void arm();
+
+    Clock::duration period_;
+    Clock::time_point deadline_; /* when the next pulse is due */
+    Clock::time_point started_;  /* when the current pulse began */
+    int timer_fd_;
+
+    LatencyHistogram lateness_;   /* how long after its deadline each pulse began */
+    LatencyHistogram processing_; /* how long each pulse's work took */
+    unsigned long pulses_ = 0;    /* pulses begun */
+    unsigned long missed_ = 0;    /* periods that passed without a pulse of their own */
+    unsigned long overruns_ = 0;  /* pulses whose work took longer than a period */
+};
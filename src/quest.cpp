@@ -45,6 +45,7 @@ void boot_quests() {
 
     if ((fl = fopen(ALL_QUEST_FILE, "r")) == nullptr) {
         fprintf(stderr, "Unable to find any quest data file (non-fatal)\n");
+        build_quest_index();
         return;
     }
 
@@ -70,6 +71,8 @@ void boot_quests() {
         }
     }
     fclose(fl);
+
+    build_quest_index();
 }
 
 /* quest_stat - returns true if any stat info was listed */
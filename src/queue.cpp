@@ -11,87 +11,156 @@
 #include "queue.hpp"
 
 #include "conf.hpp"
-#include "events.hpp"
 #include "structs.hpp"
 #include "sysdep.hpp"
 #include "utils.hpp"
 #include "logging.hpp"
 
+#include <algorithm>
 
 /* external variables */
 extern unsigned long pulse;
 
+static void list_init(QElement *head) { head->prev = head->next = head; }
+
+static void list_append(QElement *head, QElement *qe) {
+    qe->prev = head->prev;
+    qe->next = head;
+    head->prev->next = qe;
+    head->prev = qe;
+}
+
+static void list_remove(QElement *qe) {
+    qe->prev->next = qe->next;
+    qe->next->prev = qe->prev;
+}
+
+/*
+ * Where an element with this key belongs: the lowest level on which the
+ * key and now are in the same turn of the level above.  Anything already
+ * due goes in the current level 0 slot.
+ */
+static QElement *queue_slot(Queue *q, long key) {
+    int level;
+
+    if (key <= q->now)
+        return &q->slot[0][q->now & (WHEEL_SIZE - 1)];
+
+    for (level = 0; level < WHEEL_LEVELS; level++)
+        if (!((key ^ q->now) >> (WHEEL_BITS * (level + 1))))
+            return &q->slot[level][(key >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1)];
+
+    return &q->overflow;
+}
+
+/* Move everything in the list to where it belongs now */
+static void queue_cascade(Queue *q, QElement *head) {
+    QElement *qe, *next_qe;
+
+    qe = head->next;
+    list_init(head);
+    for (; qe != head; qe = next_qe) {
+        next_qe = qe->next;
+        list_append(queue_slot(q, qe->key), qe);
+    }
+}
+
+/* Advance the wheel by one pulse */
+static void queue_turn(Queue *q) {
+    int level;
+
+    q->now++;
+
+    /* Find the highest level that has just moved on to its next slot */
+    for (level = 0; level < WHEEL_LEVELS; level++)
+        if ((q->now >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1))
+            break;
+
+    if (level == WHEEL_LEVELS)
+        queue_cascade(q, &q->overflow);
+    for (level = std::min(level, WHEEL_LEVELS - 1); level > 0; level--)
+        queue_cascade(q, &q->slot[level][(q->now >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1)]);
+}
+
+/*
+ * Turn the wheel as far as the current pulse and return the first element
+ * that is due, or NULL if there are none.
+ */
+static QElement *queue_due(Queue *q) {
+    QElement *head;
+
+    for (;;) {
+        head = &q->slot[0][q->now & (WHEEL_SIZE - 1)];
+        if (head->next != head)
+            return head->next;
+        if (q->now >= (long)pulse || !q->size)
+            break;
+        queue_turn(q);
+    }
+
+    /* Nothing's waiting, so there is nothing to spread out on the way. */
+    if (!q->size)
+        q->now = std::max(q->now, (long)pulse);
+
+    return nullptr;
+}
+
 /* returns a new, initialized queue */
 Queue *queue_init(void) {
     Queue *q;
+    int level, i;
 
     CREATE(q, Queue, 1);
+    for (level = 0; level < WHEEL_LEVELS; level++)
+        for (i = 0; i < WHEEL_SIZE; i++)
+            list_init(&q->slot[level][i]);
+    list_init(&q->overflow);
+    q->now = pulse;
 
     return q;
 }
 
 /* add data into the priority queue q with key */
 QElement *queue_enq(Queue *q, void *data, long key) {
-    QElement *qe, *i;
-    int bucket;
+    QElement *qe;
+    int i;
 
-    CREATE(qe, QElement, 1);
+    if (!q->spare) {
+        /* The first element of each chunk links the chunks together. */
+        CREATE(qe, QElement, QUEUE_CHUNK + 1);
+        qe->next = q->chunks;
+        q->chunks = qe;
+        for (i = 1; i <= QUEUE_CHUNK; i++) {
+            qe[i].next = q->spare;
+            q->spare = &qe[i];
+        }
+    }
+
+    qe = q->spare;
+    q->spare = qe->next;
     qe->data = data;
     qe->key = key;
 
-    bucket = key % NUM_EVENT_QUEUES; /* which Queue does this go in */
-
-    if (!q->head[bucket]) { /* queue is empty */
-        q->head[bucket] = qe;
-        q->tail[bucket] = qe;
-    }
+    /* An empty wheel may be behind; catch it up so the key lands on the right level. */
+    if (!q->size)
+        q->now = std::max(q->now, (long)pulse);
 
-    else {
-        for (i = q->tail[bucket]; i; i = i->prev) {
-
-            if (i->key < key) { /* found insertion point */
-                if (i == q->tail[bucket])
-                    q->tail[bucket] = qe;
-                else {
-                    qe->next = i->next;
-                    i->next->prev = qe;
-                }
-
-                qe->prev = i;
-                i->next = qe;
-                break;
-            }
-        }
-
-        if (i == nullptr) { /* insertion point is front of list */
-            qe->next = q->head[bucket];
-            q->head[bucket] = qe;
-            qe->next->prev = qe;
-        }
-    }
+    list_append(queue_slot(q, key), qe);
+    q->size++;
 
     return qe;
 }
 
 /* remove queue element qe from the priority queue q */
 void queue_deq(Queue *q, QElement *qe) {
-    int i;
-
     assert(qe);
 
-    i = qe->key % NUM_EVENT_QUEUES;
-
-    if (qe->prev == nullptr)
-        q->head[i] = qe->next;
-    else
-        qe->prev->next = qe->next;
-
-    if (qe->next == nullptr)
-        q->tail[i] = qe->prev;
-    else
-        qe->next->prev = qe->prev;
+    list_remove(qe);
+    q->size--;
 
-    free(qe);
+    qe->data = nullptr;
+    qe->next = q->spare;
+    q->spare = qe;
 }
 
 /*
@@ -99,30 +168,26 @@ void queue_deq(Queue *q, QElement *qe) {
  * first element of the priority queue q
  */
 void *queue_head(Queue *q) {
+    QElement *qe;
     void *data;
-    int i;
-
-    i = pulse % NUM_EVENT_QUEUES;
 
-    if (!q->head[i])
+    if (!(qe = queue_due(q)))
         return nullptr;
 
-    data = q->head[i]->data;
-    queue_deq(q, q->head[i]);
+    data = qe->data;
+    queue_deq(q, qe);
     return data;
 }
 
 /*
  * returns the key of the head element of the priority queue
- * if q is NULL, then return the largest unsigned number
+ * if nothing is due yet, then return the largest number
  */
 long queue_key(Queue *q) {
-    int i;
-
-    i = pulse % NUM_EVENT_QUEUES;
+    QElement *qe;
 
-    if (q->head[i])
-        return q->head[i]->key;
+    if ((qe = queue_due(q)))
+        return qe->key;
     else
         return LONG_MAX;
 }
@@ -130,26 +195,31 @@ long queue_key(Queue *q) {
 /* returns the key of queue element qe */
 long queue_elmt_key(QElement *qe) { return qe->key; }
 
-/* free q and contents */
-void queue_free(Queue *q) {
-    int i;
-    QElement *qe, *next_qe;
-    Event *event;
-
-    for (i = 0; i < NUM_EVENT_QUEUES; i++)
-        for (qe = q->head[i]; qe; qe = next_qe) {
-            next_qe = qe->next;
-            /*
-             * This is okay for now, but if we ever were to use this queue
-             * for something besides events, we'd be in trouble.
-             */
-            if ((event = (Event *)qe->data) != nullptr) {
-                if (event->free_obj && event->event_obj)
-                    free(event->event_obj);
-                free(event);
-            }
-            free(qe);
-        }
+/* hand the data in one list of q to free_data */
+static void queue_free_list(QElement *head, void (*free_data)(void *)) {
+    QElement *qe;
+
+    for (qe = head->next; qe != head; qe = qe->next)
+        if (qe->data)
+            free_data(qe->data);
+}
+
+/* free q, passing anything still queued to free_data (if given) */
+void queue_free(Queue *q, void (*free_data)(void *)) {
+    QElement *chunk, *next_chunk;
+    int level, i;
+
+    if (free_data) {
+        for (level = 0; level < WHEEL_LEVELS; level++)
+            for (i = 0; i < WHEEL_SIZE; i++)
+                queue_free_list(&q->slot[level][i], free_data);
+        queue_free_list(&q->overflow, free_data);
+    }
+
+    for (chunk = q->chunks; chunk; chunk = next_chunk) {
+        next_chunk = chunk->next;
+        free(chunk);
+    }
 
     free(q);
 }
@@ -10,17 +10,31 @@
 
 #pragma once
 
-/* number of queues to use (reduces enqueue cost) */
-#define NUM_EVENT_QUEUES 100
+/*
+ * The queue is a hierarchical timing wheel keyed by pulse.  Level 0 has a
+ * slot for each of the next WHEEL_SIZE pulses; each slot of level n covers
+ * WHEEL_SIZE slots of level n - 1.  As the wheel turns, a level's slot is
+ * spread out over the levels below it when its time comes.  Enqueueing and
+ * dequeueing are constant time.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS) /* slots per level */
+#define WHEEL_LEVELS 4               /* 64^4 pulses (19 days) before the overflow list */
+#define QUEUE_CHUNK 256              /* QElements allocated at a time */
 
 struct QElement {
     void *data;
     long key;
-    QElement *prev, *next;
+    QElement *prev, *next; /* circular, through the slot's list head */
 };
 
 struct Queue {
-    QElement *head[NUM_EVENT_QUEUES], *tail[NUM_EVENT_QUEUES];
+    QElement slot[WHEEL_LEVELS][WHEEL_SIZE]; /* list heads */
+    QElement overflow;                       /* too far off for the wheel */
+    long now;                                /* the pulse the wheel has turned to */
+    long size;                               /* elements queued */
+    QElement *spare;                         /* unused elements, through next */
+    QElement *chunks;                        /* allocations of spares, through next */
 };
 
 /* function protos need by other modules */
@@ -30,4 +44,4 @@ void queue_deq(Queue *q, QElement *qe);
 void *queue_head(Queue *q);
 long queue_key(Queue *q);
 long queue_elmt_key(QElement *qe);
-void queue_free(Queue *q);
+void queue_free(Queue *q, void (*free_data)(void *));
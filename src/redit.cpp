@@ -145,6 +145,7 @@ void redit_save_internally(DescriptorData *d) {
     if (room_num > 0) {
         OLC_ROOM(d)->contents = world[room_num].contents;
         OLC_ROOM(d)->people = world[room_num].people;
+        OLC_ROOM(d)->triggers = world[room_num].triggers;
         free_room(world + room_num);
         if (SCRIPT(&world[room_num]))
             extract_script(SCRIPT(&world[room_num]));
@@ -231,6 +232,7 @@ void redit_save_internally(DescriptorData *d) {
         free(world);
         world = new_world;
         top_of_world++;
+        build_room_index();
 
         /* Now reattach triggers. */
         for (i = 0; i <= top_of_world; ++i)
@@ -259,6 +261,7 @@ void redit_save_internally(DescriptorData *d) {
                         "SYSERR:redit.c:redit_save_internally(): Unknown command: {} in zone {}.", ZCMD.command,
                         zone_table[zone].name);
                 }
+        invalidate_zone_programs();
         /* update load rooms, to fix creeping load room problem */
         if (room_num <= mortal_start_room)
             mortal_start_room++;
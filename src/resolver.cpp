@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   File: resolver.c                                     Part of FieryMUD *
+ *  Usage: background reverse-DNS lookups with a host cache                *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "resolver.hpp"
+
+#include <netdb.h>
+#include <sys/socket.h>
+
+HostResolver::HostResolver(LookupFunc lookup, std::size_t cache_size, std::chrono::seconds ttl)
+    : lookup_(std::move(lookup)), cache_size_(cache_size), ttl_(ttl) {
+    thread_ = std::thread(&HostResolver::worker, this);
+}
+
+HostResolver::~HostResolver() {
+    {
+        std::lock_guard guard(lock_);
+        stopping_ = true;
+        pending_.clear();
+    }
+    wakeup_.notify_one();
+    thread_.join();
+}
+
+std::optional<std::string> HostResolver::request(std::uint64_t id, in_addr addr) {
+    auto found = index_.find(addr.s_addr);
+
+    if (found != index_.end()) {
+        if (found->second->expires > std::chrono::steady_clock::now()) {
+            ++hits_;
+            lru_.splice(lru_.begin(), lru_, found->second);
+            return found->second->hostname;
+        }
+        lru_.erase(found->second);
+        index_.erase(found);
+    }
+
+    ++misses_;
+    std::vector<std::uint64_t> &waiting = waiting_[addr.s_addr];
+    waiting.push_back(id);
+    if (waiting.size() > 1)
+        return std::nullopt; /* it's already being looked up */
+
+    ++lookups_;
+    {
+        std::lock_guard guard(lock_);
+        pending_.push_back(addr);
+    }
+    wakeup_.notify_one();
+    return std::nullopt;
+}
+
+std::vector<ResolvedHost> HostResolver::collect() {
+    std::vector<ResolvedHost> results;
+    std::vector<Lookup> finished;
+
+    {
+        std::lock_guard guard(lock_);
+        finished.swap(done_);
+    }
+    for (auto &lookup : finished) {
+        auto waiting = waiting_.find(lookup.addr.s_addr);
+
+        remember(lookup.addr, lookup.hostname);
+        if (waiting == waiting_.end())
+            continue;
+        for (std::uint64_t id : waiting->second)
+            results.push_back({id, lookup.addr, lookup.hostname});
+        waiting_.erase(waiting);
+    }
+    return results;
+}
+
+void HostResolver::remember(in_addr addr, const std::string &hostname) {
+    auto found = index_.find(addr.s_addr);
+
+    if (found != index_.end()) {
+        lru_.erase(found->second);
+        index_.erase(found);
+    }
+    if (cache_size_ == 0)
+        return;
+    while (lru_.size() >= cache_size_) {
+        index_.erase(lru_.back().addr);
+        lru_.pop_back();
+    }
+    lru_.push_front({addr.s_addr, hostname, std::chrono::steady_clock::now() + ttl_});
+    index_[addr.s_addr] = lru_.begin();
+}
+
+void HostResolver::worker() {
+    std::unique_lock guard(lock_);
+
+    while (true) {
+        wakeup_.wait(guard, [this] { return stopping_ || !pending_.empty(); });
+        if (stopping_)
+            return;
+
+        Lookup job{pending_.front(), {}};
+        pending_.pop_front();
+
+        /* Don't hold the lock while the nameserver takes its time. */
+        guard.unlock();
+        job.hostname = lookup_(job.addr).value_or("");
+        guard.lock();
+
+        done_.push_back(std::move(job));
+    }
+}
+
+std::optional<std::string> HostResolver::system_lookup(in_addr addr) {
+    sockaddr_in sa{};
+    char host[NI_MAXHOST];
+
+    sa.sin_family = AF_INET;
+    sa.sin_addr = addr;
+    if (getnameinfo((sockaddr *)&sa, sizeof(sa), host, sizeof(host), nullptr, 0, NI_NAMEREQD) != 0)
+        return std::nullopt;
+    return host;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   File: resolver.h                                     Part of FieryMUD *
+ *  Usage: header file: background reverse-DNS lookups with a host cache   *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <netinet/in.h>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct ResolvedHost {
+    std::uint64_t id;     /* what the caller asked under */
+    in_addr addr;         /* address that was looked up */
+    std::string hostname; /* empty if the lookup failed */
+};
+
+/*
+ * Reverse-DNS lookups run on a worker thread so a slow nameserver can't
+ * freeze the game.  The game thread queues lookups with request() and
+ * collects answers with collect() once per pulse; answers (including
+ * failures) are kept in an LRU cache for ttl so reconnects are free.
+ * Requests for an address already being looked up wait for that lookup
+ * rather than starting another.
+ *
+ * The lookup function is replaceable so a stub resolver can be used in
+ * place of the system one.  Only the lookup function runs on the worker;
+ * the cache is touched only by the game thread.
+ */
+class HostResolver {
+  public:
+    /* Returns the name for addr, or nothing if it has none. */
+    using LookupFunc = std::function<std::optional<std::string>(in_addr)>;
+
+    HostResolver(LookupFunc lookup, std::size_t cache_size, std::chrono::seconds ttl);
+    ~HostResolver();
+
+    /*
+     * If addr is cached, returns its name immediately (an empty string if
+     * it is known not to resolve).  Otherwise queues a lookup and returns
+     * nothing; collect() will hand back the answer under id.  The caller
+     * should never use an id twice, so a late answer can't be mistaken
+     * for one to a newer request.
+     */
+    std::optional<std::string> request(std::uint64_t id, in_addr addr);
+    /* Hands back an answer for every request whose lookup finished since the last call. */
+    std::vector<ResolvedHost> collect();
+
+    std::size_t cached() const { return lru_.size(); }
+    unsigned long hits() const { return hits_; }
+    unsigned long misses() const { return misses_; }
+    /* Lookups the worker has been asked to do; merged requests aren't counted. */
+    unsigned long lookups() const { return lookups_; }
+
+    static std::optional<std::string> system_lookup(in_addr addr);
+
+  private:
+    struct Lookup {
+        in_addr addr;
+        std::string hostname;
+    };
+
+    struct CacheEntry {
+        std::uint32_t addr;
+        std::string hostname;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    void worker();
+    void remember(in_addr addr, const std::string &hostname);
+
+    LookupFunc lookup_;
+    std::size_t cache_size_;
+    std::chrono::seconds ttl_;
+
+    /* Game thread only */
+    std::list<CacheEntry> lru_; /* most recently used first */
+    std::unordered_map<std::uint32_t, std::list<CacheEntry>::iterator> index_;
+    std::unordered_map<std::uint32_t, std::vector<std::uint64_t>> waiting_; /* ids by address being looked up */
+    unsigned long hits_ = 0, misses_ = 0, lookups_ = 0;
+
+    /* Shared with the worker */
+    std::mutex lock_;
+    std::condition_variable wakeup_;
+    std::deque<in_addr> pending_;
+    std::vector<Lookup> done_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   File: ring_buffer.c                                  Part of FieryMUD *
+ *  Usage: fixed-capacity byte ring buffer                                 *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+RingBuffer::RingBuffer(std::size_t capacity) : data_(new char[capacity]), capacity_(capacity) {}
+
+std::size_t RingBuffer::write(std::string_view data) {
+    std::size_t len = std::min(data.size(), space());
+    std::size_t tail = (head_ + count_) % capacity_;
+    std::size_t first = std::min(len, capacity_ - tail);
+
+    memcpy(data_.get() + tail, data.data(), first);
+    memcpy(data_.get(), data.data() + first, len - first);
+    count_ += len;
+    return len;
+}
+
+int RingBuffer::peek(iovec iov[2]) const {
+    std::size_t first;
+
+    if (count_ == 0)
+        return 0;
+
+    first = std::min(count_, capacity_ - head_);
+    iov[0].iov_base = data_.get() + head_;
+    iov[0].iov_len = first;
+    if (first == count_)
+        return 1;
+
+    iov[1].iov_base = data_.get();
+    iov[1].iov_len = count_ - first;
+    return 2;
+}
+
+void RingBuffer::consume(std::size_t len) {
+    len = std::min(len, count_);
+    head_ = (head_ + len) % capacity_;
+    count_ -= len;
+    if (count_ == 0)
+        head_ = 0;
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+ *   File: ring_buffer.h                                  Part of FieryMUD *
+ *  Usage: header file: fixed-capacity byte ring buffer                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <sys/uio.h>
+
+/*
+ * A bounded FIFO of bytes.  Data is appended at the tail and consumed
+ * from the head; since the storage wraps, the readable bytes are exposed
+ * as (at most) two iovecs so they can be handed straight to writev().
+ */
+class RingBuffer {
+  public:
+    explicit RingBuffer(std::size_t capacity);
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t size() const { return count_; }
+    std::size_t space() const { return capacity_ - count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == capacity_; }
+
+    /* Append as much of data as fits; returns the number of bytes stored. */
+    std::size_t write(std::string_view data);
+    /* Fill iov with the readable bytes in order; returns the iovec count (0-2). */
+    int peek(iovec iov[2]) const;
+    /* Discard up to len bytes from the head. */
+    void consume(std::size_t len);
+    void clear() { head_ = count_ = 0; }
+
+  private:
+    std::unique_ptr<char[]> data_;
+    std::size_t capacity_;
+    std::size_t head_ = 0;  /* offset of the oldest byte */
+    std::size_t count_ = 0; /* bytes currently stored */
+};
@@ -121,6 +121,7 @@ struct RoomData {
 
     TriggerPrototypeList *proto_script; /* list of default triggers  */
     ScriptData *script;                 /* script info for the object         */
+    RoomTriggers *triggers;             /* trigger types of what's here, or NULL */
 
     ObjData *contents; /* List of items in room              */
     CharData *people;  /* List of NPC / PC in room          */
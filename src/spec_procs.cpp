@@ -917,7 +917,7 @@ int do_recall(CharData *ch, ObjData *obj, int cmd, char *argument) {
 
     /* Create the event that will actually move the target in a few seconds. */
 
-    CREATE(recall, RecallEventObj, 1);
+    CREATE_EVENT_OBJ(recall, RecallEventObj);
     recall->ch = targ;
     recall->from_room = ch->in_room;
 
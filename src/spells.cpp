@@ -2127,7 +2127,7 @@ ASPELL(spell_wandering_woods) {
         if (dir2 == -1) /* next room does not lead back to this one */
             continue;
         /* queue an event to change the room back to normal */
-        CREATE(room_undo, RoomUndoEventObj, 1);
+        CREATE_EVENT_OBJ(room_undo, RoomUndoEventObj);
         room_undo->exit = dir2;
         room_undo->room = next_room;
         room_undo->connect_room = ch->in_room;
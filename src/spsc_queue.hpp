@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   File: spsc_queue.h                                   Part of FieryMUD *
+ *  Usage: header file: lock-free single-producer, single-consumer queue   *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/*
+ * A fixed-capacity FIFO between exactly two threads: one that only
+ * pushes and one that only pops.  Neither side ever blocks or takes a
+ * lock; push() simply fails when the queue is full, leaving the item
+ * with the caller.
+ *
+ * head_ and tail_ only ever increase and are masked into slots_, so
+ * Capacity must be a power of two.  They are kept on separate cache
+ * lines so the two threads don't fight over one.
+ */
+template <typename T, std::size_t Capacity> class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+  public:
+    /* Producer only.  Returns false (and leaves item alone) if full. */
+    bool push(T &&item) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+            return false;
+        slots_[tail & (Capacity - 1)] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer only.  Returns false if there was nothing to take. */
+    bool pop(T &item) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        item = std::move(slots_[head & (Capacity - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Only a snapshot: the other thread may change it right away. */
+    bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+  private:
+    std::array<T, Capacity> slots_;
+    alignas(64) std::atomic<std::size_t> head_{0}; /* next slot to pop; written by the consumer */
+    alignas(64) std::atomic<std::size_t> tail_{0}; /* next slot to fill; written by the producer */
+};
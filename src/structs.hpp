@@ -360,7 +360,16 @@ struct KnowSpell {
 struct Casting;
 struct DescriptorData;
 struct Event;
+
+/* The events attached to a character or object.  by_type is allocated with
+ * the first event and holds the newest event of each EVENT_* type. */
+struct EventList {
+    Event *head;     /* all events, through next */
+    Event **by_type; /* MAX_EVENT chains, through next_of_type */
+};
+
 struct QuestList;
+struct RoomTriggers;
 struct Scribing;
 struct ScriptData;
 struct TriggerPrototypeList;
@@ -413,7 +422,7 @@ struct CharData {
     DescriptorData *desc;               /* NULL for mobiles */
                                         /* Events */
     Casting casting;                    /* note this is NOT a pointer */
-    Event *events;                      /* List of events related to this character */
+    EventList events;                   /* List of events related to this character */
     int event_flags[EVENT_FLAG_FIELDS]; /* Bitfield of events active on this character */
 };
 
@@ -427,9 +436,29 @@ struct txt_block {
     txt_block *next;
 };
 
-struct txt_q {
-    txt_block *head;
-    txt_block *tail;
+/* Where the telnet input parser is in the byte stream */
+#define TELNET_DATA 0        /* ordinary text */
+#define TELNET_IAC 1         /* just saw IAC */
+#define TELNET_NEGOTIATE 2   /* saw IAC WILL/WONT/DO/DONT; option next */
+#define TELNET_SUBOPTION 3   /* saw IAC SB; option next */
+#define TELNET_SUBDATA 4     /* inside a subnegotiation */
+#define TELNET_SUBDATA_IAC 5 /* saw IAC inside a subnegotiation */
+
+/*
+ * Telnet input parser state.  It is kept between reads, so a negotiation
+ * or a line that arrives split across packets is still understood.  The
+ * line being typed is kept, already cleaned up, at the front of inbuf.
+ */
+struct TelnetInput {
+    int state;                           /* TELNET_x */
+    unsigned char command;               /* WILL/WONT/DO/DONT awaiting its option */
+    unsigned char option;                /* option being subnegotiated */
+    char sub_data[MAX_INPUT_LENGTH + 8]; /* subnegotiation payload so far */
+    int sub_len;                         /* bytes in sub_data */
+    int line_len;                        /* bytes of the line in progress */
+    int line_cost;                       /* its length once $'s are doubled */
+    bool discarding;                     /* skipping the rest of an overlong line */
+    bool after_newline;                  /* the last text byte read was a newline */
 };
 
 struct paging_line {
@@ -439,6 +468,11 @@ struct paging_line {
 
 struct EditorData;
 struct OLCData;
+class CommandQueue;
+class MccpStream;
+class NetworkThread;
+class OutputQueue;
+class RingBuffer;
 struct DescriptorData {
     socket_t descriptor;        /* file descriptor for socket            */
     char host[HOST_LENGTH + 1]; /* hostname                              */
@@ -447,20 +481,29 @@ struct DescriptorData {
     int connected;              /* mode of 'connectedness'               */
     int wait;                   /* wait for how many loops               */
     bool gmcp_enabled;          /* Shall we send additional GMCP data    */
+    int poll_events;            /* POLL_x readiness not yet acted upon   */
     int desc_num;               /* unique num assigned to desc           */
+    unsigned long resolve_id;   /* the resolver answers it under this    */
     time_t login_time;          /* when the person connected             */
     int mail_vnum;
     int prompt_mode;                   /* control of prompt-printing            */
     char inbuf[MAX_RAW_INPUT_LENGTH];  /* buffer for raw input            */
     char last_input[MAX_INPUT_LENGTH]; /* the last input                  */
     char small_outbuf[SMALL_BUFSIZE];  /* standard output buffer                */
-    std::string output;                /* ptr to the current output buffer      */
-    txt_q input;                       /* q of unprocessed input                */
+    OutputQueue *output;               /* output queued during this pulse       */
+    RingBuffer *outring;               /* processed output the socket hasn't taken */
+    MccpStream *mccp;                  /* compressor, if the client wants MCCP2 */
+    NetworkThread *network;            /* I/O thread that owns the socket, if any */
+    CommandQueue *input;               /* commands waiting to be interpreted     */
+    TelnetInput telnet;                /* telnet input parser state             */
     CharData *character;               /* linked to char                        */
     CharData *original;                /* original char if switched             */
     DescriptorData *snooping;          /* Who is this char snooping             */
     DescriptorData *snoop_by;          /* And who is snooping this char         */
     DescriptorData *next;              /* link to next descriptor               */
+    int zone;                          /* zone it is counted as playing in, or NOWHERE */
+    DescriptorData *zone_next;         /* next descriptor playing in that zone  */
+    DescriptorData *zone_prev;         /* previous one                          */
     OLCData *olc;
     char *storage;
 
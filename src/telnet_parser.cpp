@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   File: telnet_parser.c                                Part of FieryMUD *
+ *  Usage: splitting raw telnet input into lines and options               *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "telnet_parser.hpp"
+
+#include "conf.hpp"
+#include "utils.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <fmt/format.h>
+#include <utility>
+
+#ifdef HAVE_ARPA_TELNET_H
+#include <arpa/telnet.h>
+#else
+#include "telnet.h"
+#endif
+
+/*
+ * The write position never passes the read position: the line in
+ * progress only ever shrinks relative to the bytes it came from, so it
+ * can be rebuilt in the same buffer as it is read.
+ */
+bool parse_telnet(TelnetInput *tn, char *buf, int len, TelnetHandler &handler) {
+    int line_start = 0, first = tn->line_len, pos = first, end = pos + len;
+    unsigned char c;
+
+    for (; pos < end; ++pos) {
+        c = buf[pos];
+
+        switch (tn->state) {
+        case TELNET_IAC:
+            if (c == WILL || c == WONT || c == DO || c == DONT) {
+                tn->command = c;
+                tn->state = TELNET_NEGOTIATE;
+            } else if (c == SB)
+                tn->state = TELNET_SUBOPTION;
+            else {
+                if (c == SE)
+                    handler.protocol_error("Error, attempting to end a telnet negotiation we never started!");
+                tn->state = TELNET_DATA; /* IAC IAC, NOP, GA, etc. */
+            }
+            continue;
+        case TELNET_NEGOTIATE:
+            tn->state = TELNET_DATA;
+            handler.negotiation(tn->command, c);
+            continue;
+        case TELNET_SUBOPTION:
+            tn->option = c;
+            tn->sub_len = 0;
+            tn->state = TELNET_SUBDATA;
+            continue;
+        case TELNET_SUBDATA:
+            if (c == IAC)
+                tn->state = TELNET_SUBDATA_IAC;
+            else if (tn->sub_len < MAX_INPUT_LENGTH)
+                tn->sub_data[tn->sub_len++] = c;
+            continue;
+        case TELNET_SUBDATA_IAC:
+            if (c == IAC) { /* an escaped 255 */
+                if (tn->sub_len < MAX_INPUT_LENGTH)
+                    tn->sub_data[tn->sub_len++] = c;
+                tn->state = TELNET_SUBDATA;
+                continue;
+            }
+            tn->state = TELNET_DATA;
+            if (c == SE) {
+                tn->sub_data[tn->sub_len] = '\0';
+                handler.subnegotiation(tn->option, std::string_view(tn->sub_data, tn->sub_len));
+            } else
+                handler.protocol_error(fmt::format("Invalid telnet IAC code {:d} in subnegotiation", (int)c));
+            continue;
+        }
+
+        /* If we are here, it's normal text input. */
+        if (c == IAC) {
+            tn->state = TELNET_IAC;
+            continue;
+        }
+
+        if (IS_NEWLINE(c)) { /* End of command, process it */
+            /* Newlines that arrive in a row, as from a paste, end just the one command. */
+            if (tn->after_newline && pos != first) {
+                line_start = pos + 1;
+                continue;
+            }
+            if (!std::exchange(tn->discarding, false))
+                handler.line(std::string_view(buf + line_start, tn->line_len));
+            line_start = pos + 1;
+            tn->line_len = tn->line_cost = 0;
+            tn->after_newline = true;
+            continue;
+        }
+        tn->after_newline = false;
+
+        if (tn->discarding)
+            continue;
+
+        if (c == '\b') { /* handle backspacing */
+            if (tn->line_len > 0)
+                tn->line_cost -= buf[line_start + --tn->line_len] == '$' ? 2 : 1;
+        } else if (isascii(c) && isprint(c)) {
+            if (tn->line_cost + (c == '$' ? 2 : 1) > MAX_INPUT_LENGTH - 1) {
+                if (!handler.long_line(std::string_view(buf + line_start, tn->line_len)))
+                    return false;
+                tn->line_len = tn->line_cost = 0;
+                tn->discarding = true;
+                continue;
+            }
+            buf[line_start + tn->line_len++] = c;
+            tn->line_cost += c == '$' ? 2 : 1;
+        }
+    }
+
+    /* Keep the unfinished line at the front for the next read. */
+    if (line_start > 0 && tn->line_len > 0)
+        memmove(buf, buf + line_start, tn->line_len);
+    return true;
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+ *   File: telnet_parser.h                                Part of FieryMUD *
+ *  Usage: header file: splitting raw telnet input into lines and options  *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include "structs.hpp"
+
+#include <string_view>
+
+/*
+ * Whatever parse_telnet() finds in the input is reported here, in the
+ * order it arrived.  The parser itself touches nothing but its
+ * TelnetInput and the buffer, so it can run on any thread.
+ */
+class TelnetHandler {
+  public:
+    virtual ~TelnetHandler() = default;
+
+    /*
+     * A complete line of input, without the newline.  Newlines that
+     * arrive together in one read end just one line, so an empty line
+     * is return pressed on its own.
+     */
+    virtual void line(std::string_view text) = 0;
+    /*
+     * A line ran past MAX_INPUT_LENGTH; text is the part that fit.  The
+     * rest of it, up to the next newline, is dropped.  Return false to
+     * stop parsing (the connection is going away).
+     */
+    virtual bool long_line(std::string_view text) = 0;
+    /* IAC WILL/WONT/DO/DONT option */
+    virtual void negotiation(unsigned char command, unsigned char option) = 0;
+    /* IAC SB option ... IAC SE; data is followed by a '\0'. */
+    virtual void subnegotiation(unsigned char option, std::string_view data) = 0;
+    /* The client broke the protocol; what is worth logging. */
+    virtual void protocol_error(std::string_view what) = 0;
+};
+
+/*
+ * Run len freshly read bytes through the parser.  They must sit right
+ * after the unfinished line in buf (at buf + tn->line_len), and buf must
+ * be MAX_RAW_INPUT_LENGTH long.  The line being typed is cleaned up
+ * (backspaces applied, junk dropped) in place and left at the front of
+ * buf for next time.  Returns false if the handler asked to stop.
+ */
+bool parse_telnet(TelnetInput *tn, char *buf, int len, TelnetHandler &handler);
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *   File: trigger_profiler.c                             Part of FieryMUD *
+ *  Usage: counting and timing the runs of each trigger                    *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "trigger_profiler.hpp"
+
+#include "db.hpp"
+#include "dg_scripts.hpp"
+#include "structs.hpp"
+#include "zone.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::chrono;
+
+/* By vnum rather than rnum, since trigedit renumbers the rnums. */
+static std::unordered_map<int, TriggerProfile> trigger_profiles;
+
+TriggerProfile &trigger_profile(int vnum) { return trigger_profiles[vnum]; }
+
+TriggerTimer::TriggerTimer(TriggerProfile &profile)
+    : profile_(profile), timed_(profile.calls++ % TRIGGER_PROFILE_SAMPLE == 0) {
+    if (timed_)
+        start_ = steady_clock::now();
+}
+
+TriggerTimer::~TriggerTimer() {
+    std::uint64_t took;
+
+    if (!timed_)
+        return;
+    took = std::max<std::int64_t>(duration_cast<nanoseconds>(steady_clock::now() - start_).count(), 0);
+    ++profile_.timed;
+    profile_.nsec_timed += took;
+    profile_.nsec_max = std::max(profile_.nsec_max, took);
+}
+
+/* A trigger may be running now, so its profile is cleared rather than removed. */
+void trigger_profile_reset(void) {
+    for (auto &[vnum, profile] : trigger_profiles)
+        profile = TriggerProfile{};
+}
+
+/* The time all the calls of a trigger are reckoned to have taken, in nanoseconds. */
+static double estimated_nsec(const TriggerProfile &profile) {
+    return profile.timed ? (double)profile.nsec_timed * profile.calls / profile.timed : 0.0;
+}
+
+std::string trigger_profile_report(int count) {
+    std::vector<std::pair<int, const TriggerProfile *>> triggers;
+    std::string report;
+    int rnum;
+
+    for (const auto &[vnum, profile] : trigger_profiles)
+        if (profile.calls)
+            triggers.emplace_back(vnum, &profile);
+    if (triggers.empty())
+        return "No triggers have run since the profile was cleared.\n";
+    std::sort(triggers.begin(), triggers.end(),
+              [](const auto &a, const auto &b) { return estimated_nsec(*a.second) > estimated_nsec(*b.second); });
+    if ((int)triggers.size() > count)
+        triggers.resize(count);
+
+    report = fmt::format("{:>6} {:<24} {:>8} {:>8} {:>9} {:>6} {:>5} {:>8} {:>8} {:>9}\n", "Vnum", "Name", "Runs",
+                         "Calls", "Lines", "Waits", "Loops", "Avg us", "Smpl max", "Total ms");
+    for (const auto &[vnum, profile] : triggers) {
+        rnum = real_trigger(vnum);
+        report += fmt::format("{:>6d} {:<24.24} {:>8} {:>8} {:>9} {:>6} {:>5} {:>8.1f} {:>8.1f} {:>9.2f}\n", vnum,
+                              rnum >= 0 ? GET_TRIG_NAME(trig_index[rnum]->proto) : "(deleted)", profile->runs,
+                              profile->calls, profile->lines, profile->waits, profile->loop_limits,
+                              profile->timed ? profile->nsec_timed / 1000.0 / profile->timed : 0.0,
+                              profile->nsec_max / 1000.0, estimated_nsec(*profile) / 1e6);
+    }
+    report += fmt::format("Times are per call, from one call in {:d}; the totals are estimated from them.\n"
+                          "Smpl max is the longest of the timed calls, so a rare slow call may be missed.\n",
+                          TRIGGER_PROFILE_SAMPLE);
+    return report;
+}
+
+struct ZoneProfile {
+    int zone; /* rnum, or NOWHERE for triggers numbered outside every zone */
+    int triggers;
+    std::uint64_t runs;
+    std::uint64_t lines;
+    std::uint64_t waits;
+    std::uint64_t loop_limits;
+    double nsec;
+};
+
+std::string trigger_profile_zone_report(int count) {
+    std::unordered_map<int, ZoneProfile> by_zone;
+    std::vector<ZoneProfile> zones;
+    std::string report;
+    int zone;
+
+    for (const auto &[vnum, profile] : trigger_profiles) {
+        if (!profile.calls)
+            continue;
+        zone = find_real_zone_by_room(vnum);
+        ZoneProfile &rollup = by_zone.try_emplace(zone, ZoneProfile{zone}).first->second;
+        ++rollup.triggers;
+        rollup.runs += profile.runs;
+        rollup.lines += profile.lines;
+        rollup.waits += profile.waits;
+        rollup.loop_limits += profile.loop_limits;
+        rollup.nsec += estimated_nsec(profile);
+    }
+    if (by_zone.empty())
+        return "No triggers have run since the profile was cleared.\n";
+    for (const auto &[zone, rollup] : by_zone)
+        zones.push_back(rollup);
+    std::sort(zones.begin(), zones.end(), [](const ZoneProfile &a, const ZoneProfile &b) { return a.nsec > b.nsec; });
+    if ((int)zones.size() > count)
+        zones.resize(count);
+
+    report = fmt::format("{:>5} {:<30} {:>8} {:>8} {:>10} {:>7} {:>5} {:>9}\n", "Zone", "Name", "Triggers", "Runs",
+                         "Lines", "Waits", "Loops", "Total ms");
+    for (const ZoneProfile &rollup : zones)
+        report += fmt::format("{:>5} {:<30.30} {:>8d} {:>8} {:>10} {:>7} {:>5} {:>9.2f}\n",
+                              rollup.zone == NOWHERE ? std::string("-") : std::to_string(zone_table[rollup.zone].number),
+                              rollup.zone == NOWHERE ? "(no zone)" : zone_table[rollup.zone].name, rollup.triggers,
+                              rollup.runs, rollup.lines, rollup.waits, rollup.loop_limits, rollup.nsec / 1e6);
+    return report;
+}
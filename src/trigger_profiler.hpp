@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   File: trigger_profiler.h                             Part of FieryMUD *
+ *  Usage: header file: counting and timing the runs of each trigger       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#define TRIGGER_PROFILE_SAMPLE 8 /* time one in this many calls of each trigger */
+#define TRIGGER_PROFILE_LIST 20  /* triggers or zones listed by default */
+
+/*
+ * What script_driver() has done with one trigger vnum.  A call runs the
+ * trigger from its start or from where it last waited; only one in
+ * TRIGGER_PROFILE_SAMPLE calls is timed, and the total time is estimated
+ * from those.  Times include any triggers the trigger set off.
+ */
+struct TriggerProfile {
+    std::uint64_t runs;        /* times it was started */
+    std::uint64_t calls;       /* runs and resumptions */
+    std::uint64_t lines;       /* lines executed */
+    std::uint64_t waits;       /* times it waited, including after 30 loops */
+    std::uint64_t loop_limits; /* times it was stopped for looping too much */
+    std::uint64_t timed;       /* calls timed */
+    std::uint64_t nsec_timed;  /* how long those took */
+    std::uint64_t nsec_max;    /* the longest of them, not of every call */
+};
+
+/* The profile of a trigger vnum.  It stays put, even through a reset. */
+TriggerProfile &trigger_profile(int vnum);
+
+/*
+ * Counts a call of a trigger and, if it's one of the sampled ones, times
+ * the rest of the enclosing scope.
+ */
+class TriggerTimer {
+  public:
+    explicit TriggerTimer(TriggerProfile &profile);
+    ~TriggerTimer();
+    TriggerTimer(const TriggerTimer &) = delete;
+    TriggerTimer &operator=(const TriggerTimer &) = delete;
+
+  private:
+    TriggerProfile &profile_;
+    bool timed_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+void trigger_profile_reset(void);
+/* The count triggers with the most time spent in them. */
+std::string trigger_profile_report(int count);
+/* The same for zones, adding up the triggers numbered in each. */
+std::string trigger_profile_zone_report(int count);
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   File: uid_table.c                                    Part of FieryMUD *
+ *  Usage: finding characters and objects by unique id                     *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "uid_table.hpp"
+
+#include "utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#define UID_TABLE_MIN 1024 /* initial number of slots */
+
+UidTable char_uids;
+UidTable obj_uids;
+
+UidTable::~UidTable() { free(slots_); }
+
+/* Ids are handed out in sequence, so spread them with a Fibonacci hash. */
+std::size_t UidTable::home(long id) const {
+    return (std::size_t)(((std::uint64_t)id * 0x9e3779b97f4a7c15ULL) >> 32) & (capacity_ - 1);
+}
+
+void UidTable::grow() {
+    Slot *old = slots_;
+    std::size_t old_capacity = capacity_, i;
+
+    capacity_ = capacity_ ? capacity_ * 2 : UID_TABLE_MIN;
+    CREATE(slots_, Slot, capacity_);
+    size_ = 0;
+
+    for (i = 0; i < old_capacity; i++)
+        if (old[i].thing)
+            add(old[i].id, old[i].thing);
+    free(old);
+}
+
+void UidTable::add(long id, void *thing) {
+    std::size_t i;
+
+    if ((size_ + 1) * 2 > capacity_)
+        grow();
+
+    for (i = home(id); slots_[i].thing; i = (i + 1) & (capacity_ - 1))
+        if (slots_[i].id == id) {
+            slots_[i].thing = thing;
+            return;
+        }
+
+    slots_[i].id = id;
+    slots_[i].thing = thing;
+    size_++;
+}
+
+void UidTable::remove(long id, void *thing) {
+    std::size_t i, j, k;
+
+    if (!capacity_)
+        return;
+
+    for (i = home(id); slots_[i].thing; i = (i + 1) & (capacity_ - 1))
+        if (slots_[i].id == id)
+            break;
+    if (!slots_[i].thing || slots_[i].thing != thing)
+        return;
+
+    /*
+     * Empty slot i, then move back any later entry in the run that
+     * would no longer be reachable from its home slot.
+     */
+    for (j = i;;) {
+        slots_[i].thing = nullptr;
+        for (;;) {
+            j = (j + 1) & (capacity_ - 1);
+            if (!slots_[j].thing) {
+                size_--;
+                return;
+            }
+            k = home(slots_[j].id);
+            /* Leave j alone if its home lies cyclically in (i, j]. */
+            if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+            break;
+        }
+        slots_[i] = slots_[j];
+        i = j;
+    }
+}
+
+void *UidTable::find(long id) const {
+    std::size_t i;
+
+    if (!capacity_)
+        return nullptr;
+
+    for (i = home(id); slots_[i].thing; i = (i + 1) & (capacity_ - 1))
+        if (slots_[i].id == id)
+            return slots_[i].thing;
+
+    return nullptr;
+}
+
+void UidTable::clear() {
+    free(slots_);
+    slots_ = nullptr;
+    capacity_ = size_ = 0;
+}
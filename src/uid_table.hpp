@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   File: uid_table.h                                    Part of FieryMUD *
+ *  Usage: header file: finding characters and objects by unique id        *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/*
+ * A hash table from GET_ID() to the character or object with that id:
+ * open addressing with linear probing, kept at most half full, and
+ * deletion by shifting later entries back so no tombstones build up.
+ *
+ * Everything in character_list is in char_uids and everything in
+ * object_list is in obj_uids; whatever adds to or removes from those
+ * lists has to do the same here.  Build with CHECK_UID_TABLES (debug
+ * builds do) to have every lookup checked against the lists.
+ */
+class UidTable {
+  public:
+    UidTable() = default;
+    ~UidTable();
+    UidTable(const UidTable &) = delete;
+    UidTable &operator=(const UidTable &) = delete;
+
+    /* A later add of an id that's already present replaces it. */
+    void add(long id, void *thing);
+    /* Only removes the entry if it's still for this thing. */
+    void remove(long id, void *thing);
+    void *find(long id) const;
+    void clear();
+
+    std::size_t size() const { return size_; }
+
+  private:
+    struct Slot {
+        long id;
+        void *thing; /* nullptr if the slot is free */
+    };
+
+    std::size_t home(long id) const;
+    void grow();
+
+    Slot *slots_ = nullptr;
+    std::size_t capacity_ = 0; /* a power of two */
+    std::size_t size_ = 0;
+};
+
+extern UidTable char_uids; /* everything in character_list */
+extern UidTable obj_uids;  /* everything in object_list */
@@ -180,7 +180,7 @@ extern flagvector *ALL_FLAGS;
 #define CLEAR_FLAGS(field, num_flags) (REMOVE_FLAGS((field), ALL_FLAGS, (num_flags)))
 
 /* Event flags */
-#define GET_EVENTS(o) ((o)->events)
+#define GET_EVENTS(o) (&(o)->events)
 #define GET_EVENT_FLAGS(o) ((o)->event_flags)
 #define EVENT_FLAGGED(o, flag) IS_FLAGGED(GET_EVENT_FLAGS(o), (flag))
 
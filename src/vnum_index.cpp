@@ -0,0 +1,31 @@
+/***************************************************************************
+ *   File: vnum_index.c                                   Part of FieryMUD *
+ *  Usage: looking up real numbers by virtual number                       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "vnum_index.hpp"
+
+#include <algorithm>
+
+void VnumIndex::set(int vnum, int rnum) {
+    unsigned page = (unsigned)vnum >> PAGE_BITS;
+
+    /* Negative vnums mean "none" throughout, and are never looked up. */
+    if (vnum < 0)
+        return;
+
+    if (page >= pages_.size())
+        pages_.resize(page + 1);
+    if (!pages_[page]) {
+        pages_[page] = std::make_unique<int[]>(PAGE_SIZE);
+        std::fill_n(pages_[page].get(), PAGE_SIZE, -1);
+    }
+    pages_[page][vnum & (PAGE_SIZE - 1)] = rnum;
+}
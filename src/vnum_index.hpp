@@ -0,0 +1,46 @@
+/***************************************************************************
+ *   File: vnum_index.h                                   Part of FieryMUD *
+ *  Usage: header file: looking up real numbers by virtual number          *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/*
+ * The rnum of each vnum in one of the world's tables, found with two
+ * array lookups instead of a binary search.  The vnums are split into
+ * pages, and a page is only allocated once a vnum on it is set, so the
+ * gaps between zones cost one pointer per page.
+ *
+ * The index is a copy: whatever changes the table it indexes (booting,
+ * OLC adding or removing entries) has to rebuild it.
+ */
+class VnumIndex {
+  public:
+    static constexpr int PAGE_BITS = 8;
+    static constexpr int PAGE_SIZE = 1 << PAGE_BITS;
+
+    void clear() { pages_.clear(); }
+    void set(int vnum, int rnum);
+
+    /* The rnum set for vnum, or -1 (NOWHERE/NOBODY/NOTHING). */
+    int get(int vnum) const {
+        unsigned page = (unsigned)vnum >> PAGE_BITS;
+
+        if (page >= pages_.size() || !pages_[page])
+            return -1;
+        return pages_[page][vnum & (PAGE_SIZE - 1)];
+    }
+
+  private:
+    std::vector<std::unique_ptr<int[]>> pages_;
+};
@@ -16,6 +16,7 @@
 #include "conf.hpp"
 #include "constants.hpp"
 #include "db.hpp"
+#include "dg_scripts.hpp"
 #include "genzon.hpp"
 #include "logging.hpp"
 #include "math.hpp"
@@ -292,6 +293,8 @@ void zedit_new_zone(CharData *ch, int vzone_num) {
     free(zone_table);
     zone_table = new_table;
     top_of_zone_table++;
+    build_zone_index();
+    rebuild_zone_occupancy();
 
     /*
      * Previously, creating a new zone while invisible gave you away.
@@ -382,6 +385,9 @@ void zedit_create_index(int znum, char *type) {
 void zedit_save_internally(DescriptorData *d) {
     int subcmd = 0, cmd_room = -2, room_num = real_room(OLC_NUM(d));
 
+    /* The commands are changing, so they'll need compiling again. */
+    invalidate_zone_program(OLC_ZNUM(d));
+
     /*
      * Delete all entries in zone_table that relate to this room so we
      * can add all the ones we have in their place.
@@ -425,7 +431,10 @@ void zedit_save_internally(DescriptorData *d) {
     if (OLC_ZONE(d)->number) {
         free(zone_table[OLC_ZNUM(d)].name);
         zone_table[OLC_ZNUM(d)].name = strdup(OLC_ZONE(d)->name);
-        zone_table[OLC_ZNUM(d)].top = OLC_ZONE(d)->top;
+        if (zone_table[OLC_ZNUM(d)].top != OLC_ZONE(d)->top) {
+            zone_table[OLC_ZNUM(d)].top = OLC_ZONE(d)->top;
+            build_zone_index();
+        }
         zone_table[OLC_ZNUM(d)].reset_mode = OLC_ZONE(d)->reset_mode;
         zone_table[OLC_ZNUM(d)].lifespan = OLC_ZONE(d)->lifespan;
         zone_table[OLC_ZNUM(d)].zone_factor = OLC_ZONE(d)->zone_factor;
@@ -24,6 +24,41 @@ struct ResetCommand {
      */
 };
 
+/*
+ * A reset command compiled by compile_zone_program(), one for each
+ * ResetCommand.  Its rnums have been checked and what it works on worked
+ * out in advance, so run_zone_reset() only has to carry it out.
+ */
+enum class ResetOpType : unsigned char {
+    End,       /* the end of the program, for 'S' */
+    Skip,      /* a comment, or a command that can't work */
+    LoadMob,   /* 'M': load rnum into room */
+    LoadObj,   /* 'O': load rnum into room, or nowhere */
+    PutObj,    /* 'P': load rnum into an object of container */
+    GiveObj,   /* 'G': load rnum into the last mob's inventory */
+    EquipObj,  /* 'E': load rnum onto the last mob at position */
+    RemoveObj, /* 'R': remove an rnum from room */
+    SetDoor,   /* 'D': set the door at room, direction to state */
+    ForceMob,  /* 'F': make the last mob do command */
+};
+
+struct ResetOp {
+    ResetOpType type;
+    bool if_flag;  /* run only if the last command did */
+    int rnum;      /* the mob or object */
+    int max;       /* load only while fewer than this exist */
+    int room;      /* the room, or NOWHERE */
+    int container; /* PutObj: the container's rnum */
+    int loader;    /* PutObj: the op loading the container, or -1 */
+    int position;  /* EquipObj: where to wear it */
+    int direction; /* SetDoor: which exit */
+    int state;     /* SetDoor: the argument to reset_door() */
+    char *command; /* ForceMob: the command, owned by the zone */
+    long loaded;   /* GET_ID() of the object loaded this reset */
+};
+
+struct DescriptorData;
+
 /* zone definition structure. for the 'zone-table'   */
 struct ZoneData {
     char *name;   /* name of this zone                  */
@@ -49,6 +84,18 @@ struct ZoneData {
     int disaster_duration;
 
     ResetCommand *cmd; /* command table for reset	          */
+    ResetOp *program;  /* cmd compiled, or nullptr until needed   */
+
+    /* Who is playing here; see update_zone_occupancy() */
+    int players;                 /* descriptors playing in the zone       */
+    DescriptorData *descriptors; /* those descriptors, through zone_next  */
+
+    /* How long resetting takes; see run_zone_reset() */
+    int resets;             /* resets since boot                     */
+    long reset_usec_last;   /* time the last reset took              */
+    long reset_usec_max;    /* the longest any reset has taken       */
+    long reset_usec_total;  /* time all the resets have taken        */
+    int reset_pulses_last;  /* pulses the last reset was spread over */
 
     /*
      *  Reset mode:                              *
@@ -61,6 +108,7 @@ struct ZoneData {
 /* for queueing zones for update   */
 struct ResetQElement {
     int zone_to_reset; /* ref to zone_data */
+    int queued;        /* minute it was queued in */
     ResetQElement *next;
 };
 
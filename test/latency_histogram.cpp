@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   File: test/latency_histogram.c                       Part of FieryMUD *
+ *  Usage: tests of the duration histograms                                *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "latency_histogram.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::chrono;
+
+TEST_CASE("durations under a microsecond are not counted as nothing", "[latency_histogram]") {
+    LatencyHistogram histogram;
+    int i;
+
+    for (i = 0; i < 99; ++i)
+        histogram.record(nanoseconds(300));
+    histogram.record(nanoseconds(900));
+
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.max() == nanoseconds(900));
+    CHECK(histogram.percentile(0.5) > nanoseconds(280));
+    CHECK(histogram.percentile(0.5) < nanoseconds(320));
+    CHECK(histogram.percentile(1.0) == nanoseconds(900));
+}
+
+TEST_CASE("percentiles stay within a bucket's width of the truth", "[latency_histogram]") {
+    LatencyHistogram histogram;
+    int i;
+
+    /* 1 ms to 100 ms, evenly */
+    for (i = 1; i <= 100; ++i)
+        histogram.record(milliseconds(i));
+
+    CHECK(histogram.percentile(0.5) >= milliseconds(50));
+    CHECK(histogram.percentile(0.5) <= milliseconds(50) * 107 / 100);
+    CHECK(histogram.percentile(0.99) >= milliseconds(99));
+    CHECK(histogram.percentile(0.99) <= milliseconds(100));
+
+    histogram.clear();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.percentile(0.99) == nanoseconds(0));
+}
@@ -0,0 +1,200 @@
+/***************************************************************************
+ *   File: test/resolver.c                                Part of FieryMUD *
+ *  Usage: tests of the sitename resolver, with a stub nameserver          *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "resolver.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+
+using namespace std::chrono_literals;
+
+static in_addr address(const char *dotted) {
+    in_addr addr;
+
+    inet_aton(dotted, &addr);
+    return addr;
+}
+
+/*
+ * Answers from a table, counting the lookups.  While held, lookups wait
+ * for release(), so several requests can be made during one lookup.
+ */
+class StubNameserver {
+  public:
+    std::optional<std::string> lookup(in_addr addr) {
+        std::unique_lock guard(lock_);
+
+        ++lookups_;
+        released_.wait(guard, [this] { return !held_; });
+        auto found = names_.find(addr.s_addr);
+        if (found == names_.end())
+            return std::nullopt;
+        return found->second;
+    }
+
+    void name(const char *dotted, const char *hostname) {
+        std::lock_guard guard(lock_);
+        names_[address(dotted).s_addr] = hostname;
+    }
+
+    void hold() {
+        std::lock_guard guard(lock_);
+        held_ = true;
+    }
+
+    void release() {
+        {
+            std::lock_guard guard(lock_);
+            held_ = false;
+        }
+        released_.notify_all();
+    }
+
+    int lookups() {
+        std::lock_guard guard(lock_);
+        return lookups_;
+    }
+
+    HostResolver::LookupFunc func() {
+        return [this](in_addr addr) { return lookup(addr); };
+    }
+
+  private:
+    std::mutex lock_;
+    std::condition_variable released_;
+    std::map<std::uint32_t, std::string> names_;
+    bool held_ = false;
+    int lookups_ = 0;
+};
+
+/* Collect until there are at least count answers, or give up after a while. */
+static std::vector<ResolvedHost> collect(HostResolver &resolver, std::size_t count) {
+    std::vector<ResolvedHost> results;
+    auto give_up = std::chrono::steady_clock::now() + 5s;
+
+    while (results.size() < count && std::chrono::steady_clock::now() < give_up) {
+        for (auto &result : resolver.collect())
+            results.push_back(result);
+        std::this_thread::sleep_for(1ms);
+    }
+    return results;
+}
+
+TEST_CASE("resolver looks names up off the game thread and caches them") {
+    StubNameserver nameserver;
+    nameserver.name("10.0.0.1", "one.example.com");
+    HostResolver resolver(nameserver.func(), 16, 60s);
+
+    REQUIRE_FALSE(resolver.request(1, address("10.0.0.1")));
+    auto results = collect(resolver, 1);
+    REQUIRE(results.size() == 1);
+    CHECK(results[0].id == 1);
+    CHECK(results[0].hostname == "one.example.com");
+
+    auto cached = resolver.request(2, address("10.0.0.1"));
+    REQUIRE(cached);
+    CHECK(*cached == "one.example.com");
+    CHECK(resolver.hits() == 1);
+    CHECK(nameserver.lookups() == 1);
+}
+
+TEST_CASE("resolver caches failed lookups as empty names") {
+    StubNameserver nameserver;
+    HostResolver resolver(nameserver.func(), 16, 60s);
+
+    REQUIRE_FALSE(resolver.request(1, address("10.0.0.2")));
+    auto results = collect(resolver, 1);
+    REQUIRE(results.size() == 1);
+    CHECK(results[0].hostname.empty());
+
+    auto cached = resolver.request(2, address("10.0.0.2"));
+    REQUIRE(cached);
+    CHECK(cached->empty());
+    CHECK(nameserver.lookups() == 1);
+}
+
+TEST_CASE("resolver merges requests for an address already being looked up") {
+    StubNameserver nameserver;
+    nameserver.name("10.0.0.3", "three.example.com");
+    nameserver.hold();
+    HostResolver resolver(nameserver.func(), 16, 60s);
+
+    REQUIRE_FALSE(resolver.request(7, address("10.0.0.3")));
+    REQUIRE_FALSE(resolver.request(8, address("10.0.0.3")));
+    REQUIRE_FALSE(resolver.request(9, address("10.0.0.3")));
+    nameserver.release();
+
+    auto results = collect(resolver, 3);
+    REQUIRE(results.size() == 3);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        CHECK(results[i].id == 7 + i);
+        CHECK(results[i].hostname == "three.example.com");
+    }
+    CHECK(resolver.lookups() == 1);
+    CHECK(nameserver.lookups() == 1);
+}
+
+TEST_CASE("resolver answers under the id it was asked with") {
+    StubNameserver nameserver;
+    nameserver.name("10.0.0.4", "four.example.com");
+    nameserver.name("10.0.0.5", "five.example.com");
+    HostResolver resolver(nameserver.func(), 16, 60s);
+
+    /* Far past where a descriptor number would have wrapped */
+    REQUIRE_FALSE(resolver.request(5000000000ULL, address("10.0.0.4")));
+    REQUIRE_FALSE(resolver.request(5000000001ULL, address("10.0.0.5")));
+
+    auto results = collect(resolver, 2);
+    REQUIRE(results.size() == 2);
+    for (auto &result : results) {
+        if (result.id == 5000000000ULL)
+            CHECK(result.hostname == "four.example.com");
+        else {
+            CHECK(result.id == 5000000001ULL);
+            CHECK(result.hostname == "five.example.com");
+        }
+    }
+}
+
+TEST_CASE("resolver forgets the least recently used names first") {
+    StubNameserver nameserver;
+    nameserver.name("10.0.0.6", "six.example.com");
+    nameserver.name("10.0.0.7", "seven.example.com");
+    nameserver.name("10.0.0.8", "eight.example.com");
+    HostResolver resolver(nameserver.func(), 2, 60s);
+
+    resolver.request(1, address("10.0.0.6"));
+    REQUIRE(collect(resolver, 1).size() == 1);
+    resolver.request(2, address("10.0.0.7"));
+    REQUIRE(collect(resolver, 1).size() == 1);
+    REQUIRE(resolver.request(3, address("10.0.0.6"))); /* now the most recently used */
+    resolver.request(4, address("10.0.0.8"));
+    REQUIRE(collect(resolver, 1).size() == 1);
+
+    CHECK(resolver.cached() == 2);
+    CHECK(resolver.request(5, address("10.0.0.6")));
+    CHECK_FALSE(resolver.request(6, address("10.0.0.7")));
+}
+
+TEST_CASE("resolver looks names up again once they expire") {
+    StubNameserver nameserver;
+    nameserver.name("10.0.0.9", "nine.example.com");
+    HostResolver resolver(nameserver.func(), 16, 0s);
+
+    resolver.request(1, address("10.0.0.9"));
+    REQUIRE(collect(resolver, 1).size() == 1);
+    CHECK_FALSE(resolver.request(2, address("10.0.0.9")));
+    REQUIRE(collect(resolver, 1).size() == 1);
+    CHECK(nameserver.lookups() == 2);
+}
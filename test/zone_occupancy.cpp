@@ -0,0 +1,199 @@
+/***************************************************************************
+ *   File: test/zone_occupancy.c                          Part of FieryMUD *
+ *  Usage: tests of the players counted in each zone                       *
+ *                                                                         *
+ *  All rights reserved.  See license.doc for complete information.        *
+ *                                                                         *
+ *  FieryMUD Copyright (C) 1998, 1999, 2000 by the Fiery Consortium        *
+ *  FieryMUD is based on CircleMUD Copyright (C) 1993, 94 by the Trustees  *
+ *  of the Johns Hopkins University                                        *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ ***************************************************************************/
+
+#include "comm.hpp"
+#include "db.hpp"
+#include "handler.hpp"
+#include "rooms.hpp"
+#include "structs.hpp"
+#include "utils.hpp"
+#include "zone.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+int is_empty(int zone_nr);
+
+/*
+ * Three rooms, the first two in zone 0 and the last in zone 1, standing
+ * in for the world while a test runs.  Characters connected to it start
+ * out at the main menu, nowhere.
+ */
+class SmallWorld {
+  public:
+    SmallWorld()
+        : world_(world), top_of_world_(top_of_world), zone_table_(zone_table), top_of_zone_table_(top_of_zone_table),
+          descriptor_list_(descriptor_list) {
+        int i;
+
+        CREATE(world, RoomData, 3);
+        top_of_world = 2;
+        for (i = 0; i <= top_of_world; ++i) {
+            world[i].vnum = 100 * (i / 2 + 1) + i;
+            world[i].zone = i / 2;
+        }
+        CREATE(zone_table, ZoneData, 2);
+        top_of_zone_table = 1;
+        zone_table[0].number = 1;
+        zone_table[1].number = 2;
+        descriptor_list = nullptr;
+    }
+
+    ~SmallWorld() {
+        for (DescriptorData *d : descriptors_) {
+            free(d->character->player_specials);
+            free(d->character);
+            free(d);
+        }
+        free(world);
+        free(zone_table);
+        world = world_;
+        top_of_world = top_of_world_;
+        zone_table = zone_table_;
+        top_of_zone_table = top_of_zone_table_;
+        descriptor_list = descriptor_list_;
+    }
+
+    DescriptorData *connect() {
+        DescriptorData *d;
+
+        CREATE(d, DescriptorData, 1);
+        CREATE(d->character, CharData, 1);
+        clear_char(d->character);
+        CREATE(d->character->player_specials, PlayerSpecialData, 1);
+        d->character->desc = d;
+        d->connected = CON_MENU;
+        d->zone = NOWHERE;
+        d->next = descriptor_list;
+        descriptor_list = d;
+        descriptors_.push_back(d);
+        return d;
+    }
+
+    /* The descriptors a zone lists, in order. */
+    static std::vector<DescriptorData *> listed(int zone) {
+        std::vector<DescriptorData *> list;
+        DescriptorData *d;
+
+        for (d = zone_table[zone].descriptors; d; d = d->zone_next) {
+            if (d->zone_next)
+                REQUIRE(d->zone_next->zone_prev == d);
+            list.push_back(d);
+        }
+        return list;
+    }
+
+  private:
+    RoomData *world_;
+    int top_of_world_;
+    ZoneData *zone_table_;
+    int top_of_zone_table_;
+    DescriptorData *descriptor_list_;
+    std::vector<DescriptorData *> descriptors_;
+};
+
+TEST_CASE_METHOD(SmallWorld, "a playing character is counted in the zone of its room", "[zone_occupancy]") {
+    DescriptorData *d = connect();
+
+    d->connected = CON_PLAYING;
+    char_to_room(d->character, 0);
+    CHECK(d->zone == 0);
+    CHECK(zone_table[0].players == 1);
+    CHECK(listed(0) == std::vector{d});
+    CHECK(!is_empty(0));
+    CHECK(is_empty(1));
+
+    /* Out of the room, then into another room of the same zone */
+    char_from_room(d->character);
+    CHECK(zone_table[0].players == 0);
+    CHECK(is_empty(0));
+    char_to_room(d->character, 1);
+    CHECK(zone_table[0].players == 1);
+
+    /* Into the next zone. */
+    char_from_room(d->character);
+    char_to_room(d->character, 2);
+    CHECK(d->zone == 1);
+    CHECK(zone_table[0].players == 0);
+    CHECK(zone_table[0].descriptors == nullptr);
+    CHECK(zone_table[1].players == 1);
+    CHECK(listed(1) == std::vector{d});
+}
+
+TEST_CASE_METHOD(SmallWorld, "only CON_PLAYING descriptors are counted", "[zone_occupancy]") {
+    DescriptorData *d = connect();
+
+    /* A character at the menu may still have a room, as after a rent. */
+    char_to_room(d->character, 2);
+    CHECK(d->zone == NOWHERE);
+    CHECK(is_empty(1));
+
+    /* Whatever changes the state refreshes the count, as nanny() does. */
+    d->connected = CON_PLAYING;
+    update_zone_occupancy(d);
+    CHECK(d->zone == 1);
+    CHECK(zone_table[1].players == 1);
+
+    d->connected = CON_MENU;
+    update_zone_occupancy(d);
+    CHECK(d->zone == NOWHERE);
+    CHECK(is_empty(1));
+    CHECK(zone_table[1].descriptors == nullptr);
+}
+
+TEST_CASE_METHOD(SmallWorld, "a zone lists everyone in it through any departures", "[zone_occupancy]") {
+    DescriptorData *a = connect(), *b = connect(), *c = connect();
+
+    for (DescriptorData *d : {a, b, c}) {
+        d->connected = CON_PLAYING;
+        char_to_room(d->character, d == b ? 1 : 0);
+    }
+    CHECK(zone_table[0].players == 3);
+    CHECK(listed(0) == std::vector{c, b, a});
+
+    /* From the middle of the list */
+    char_from_room(b->character);
+    CHECK(listed(0) == std::vector{c, a});
+    char_to_room(b->character, 2);
+    CHECK(listed(1) == std::vector{b});
+
+    /* From the head, as when a socket is closed */
+    remove_zone_occupancy(c);
+    CHECK(c->zone == NOWHERE);
+    CHECK(zone_table[0].players == 1);
+    CHECK(listed(0) == std::vector{a});
+
+    /* Removing twice does no harm. */
+    remove_zone_occupancy(c);
+    CHECK(zone_table[0].players == 1);
+}
+
+TEST_CASE_METHOD(SmallWorld, "a wrong count is found and corrected", "[zone_occupancy]") {
+    DescriptorData *a = connect(), *b = connect();
+
+    a->connected = b->connected = CON_PLAYING;
+    char_to_room(a->character, 0);
+    char_to_room(b->character, 2);
+
+    /* Counts that agree are left alone. */
+    verify_zone_occupancy();
+    CHECK(listed(0) == std::vector{a});
+    CHECK(listed(1) == std::vector{b});
+
+    /* As if a move had slipped past char_to_room() */
+    a->character->in_room = 2;
+    verify_zone_occupancy();
+    CHECK(a->zone == 1);
+    CHECK(zone_table[0].players == 0);
+    CHECK(zone_table[1].players == 2);
+    CHECK(listed(1).size() == 2);
+}